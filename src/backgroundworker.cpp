@@ -0,0 +1,108 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "backgroundworker.h"
+#include <QMutexLocker>
+
+BackgroundWorker::BackgroundWorker(QObject *parent)
+    : QThread(parent)
+{
+    work_id = 0;
+    thread_active = false;
+
+    connect(this, SIGNAL(resultReady(QVariant, int)),
+            this, SLOT(relayResult(QVariant, int)), Qt::QueuedConnection);
+}
+
+BackgroundWorker::~BackgroundWorker()
+{
+    // The subclass has already stopped the thread
+    wait();
+}
+
+void BackgroundWorker::stop()
+{
+    cancel();
+    wait();
+}
+
+void BackgroundWorker::wakeUp()
+{
+    if (!thread_active) {
+        // The previous run() may still be returning
+        wait();
+
+        thread_active = true;
+        start(QThread::LowPriority);
+    }
+}
+
+void BackgroundWorker::cancel()
+{
+    QMutexLocker locker(&mutex);
+
+    clearQueue();
+    work_id++;
+}
+
+bool BackgroundWorker::isBusy()
+{
+    QMutexLocker locker(&mutex);
+    return thread_active;
+}
+
+bool BackgroundWorker::isCancelled(int id)
+{
+    QMutexLocker locker(&mutex);
+    return (id != work_id);
+}
+
+void BackgroundWorker::run()
+{
+    threadStarted();
+
+    forever {
+        int id;
+
+        {
+            QMutexLocker locker(&mutex);
+
+            if (!takeWork()) {
+                thread_active = false;
+                return;
+            }
+
+            id = work_id;
+        }
+
+        doWork(id);
+    }
+}
+
+void BackgroundWorker::sendResult(const QVariant &result, int id)
+{
+    emit resultReady(result, id);
+}
+
+void BackgroundWorker::relayResult(QVariant result, int id)
+{
+    // From cancelled work
+    if (isCancelled(id)) return;
+
+    receiveResult(result);
+}
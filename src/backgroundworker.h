@@ -0,0 +1,102 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _BACKGROUNDWORKER_H_
+#define _BACKGROUNDWORKER_H_
+
+#include <QThread>
+#include <QMutex>
+#include <QVariant>
+
+//! BackgroundWorker does queued work in a thread and sends the results
+//! to the GUI thread.
+
+/*!
+ Subclasses keep their own queue, protected by mutex. After adding
+ work to it they call wakeUp(), which starts the thread if it isn't
+ running. The thread takes one piece of work at a time with takeWork()
+ and does it with doWork() without holding the mutex.
+
+ Results are sent from the thread with sendResult() and received in the
+ GUI thread by receiveResult(), except the ones from work done before
+ the last cancel().
+
+ Subclasses must call stop() in their destructor, the thread calls their
+ virtual functions.
+*/
+
+class BackgroundWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    BackgroundWorker(QObject *parent = 0);
+    ~BackgroundWorker();
+
+    //! Forgets the queue. No more results of the work done so far will
+    //! be received.
+    void cancel();
+
+    //! True while the thread has work to do
+    bool isBusy();
+
+signals:
+    // Used internally to move the results from the thread to the GUI
+    void resultReady(QVariant result, int id);
+
+protected slots:
+    void relayResult(QVariant result, int id);
+
+protected:
+    virtual void run();
+
+    //! Starts the thread if it's not running. Must be called with the
+    //! mutex locked.
+    void wakeUp();
+
+    //! Cancels the work and waits for the thread to finish
+    void stop();
+
+    //! Called by the thread when it starts, before taking any work
+    virtual void threadStarted() {}
+    //! Called by the thread, with the mutex locked. Takes the next
+    //! piece of work from the queue; returns false if it's empty.
+    virtual bool takeWork() = 0;
+    //! Called by the thread, without the mutex, to do the work taken by
+    //! takeWork(). \a id identifies the work for sendResult().
+    virtual void doWork(int id) = 0;
+    //! Called with the mutex locked by cancel()
+    virtual void clearQueue() = 0;
+    //! Called in the GUI thread with each result of current work
+    virtual void receiveResult(const QVariant &result) = 0;
+
+    //! Called by the thread to send a result to receiveResult()
+    void sendResult(const QVariant &result, int id);
+    //! True if cancel() has been called since \a id was taken
+    bool isCancelled(int id);
+
+protected:
+    QMutex mutex;
+
+private:
+    //! Incremented by cancel(); results with an older id are discarded
+    int work_id;
+    bool thread_active;
+};
+
+#endif
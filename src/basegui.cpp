@@ -88,6 +88,7 @@
 #include "playlist.h"
 
 #include "constants.h"
+#include "loglevels.h"
 
 #include "extensions.h"
 #ifdef HAVE_QTDBUS
@@ -160,8 +161,12 @@ BaseGui::BaseGui(bool use_server, QWidget *parent, Qt::WindowFlags flags)
 
 #endif
 
+    mplayer_log.setCapacity(pref->log_max_lines);
+
     mplayer_log_window = new LogWindow(0);
+    mplayer_log_window->setLogBuffer(&mplayer_log);
     smplayer2_log_window = new LogWindow(0);
+    smplayer2_log_window->setLogBuffer(smplayer2_log);
 
     createActions();
     createMenus();
@@ -229,6 +234,8 @@ void BaseGui::initializeGui()
                 this, SLOT(remoteViewStatus(QString *)));
         connect(server, SIGNAL(receivedViewClipInfo(QString *)),
                 this, SLOT(remoteViewClipInfo(QString *)));
+        connect(server, SIGNAL(receivedViewStartupTimes(QString *)),
+                this, SLOT(remoteViewStartupTimes(QString *)));
         connect(server, SIGNAL(receivedSeek(double)),
                 this, SLOT(remoteSeek(double)));
         connect(server, SIGNAL(receivedGetChecked(QString, QString *)),
@@ -394,6 +401,18 @@ void BaseGui::remoteViewClipInfo(QString *output)
     *output += QString("%1\t%2\r\n").arg("Software", core->mdat.clip_software);
 }
 
+void BaseGui::remoteViewStartupTimes(QString *output)
+{
+    qDebug("BaseGui::remoteViewStartupTimes");
+
+    QString last = core->startupTimings()->lastToString();
+
+    if (!last.isEmpty()) *output += "Last\t" + last + "\r\n";
+
+    *output += core->startupTimings()->report();
+    *output += QString("Restarts avoided\t%1\r\n").arg(core->restartsAvoided());
+}
+
 void BaseGui::remoteSeek(double sec)
 {
     qDebug("BaseGui::remoteSeek");
@@ -2697,6 +2716,8 @@ void BaseGui::applyNewPreferences()
 
     pref_dialog->getData(pref);
 
+    Log::setLevels(pref->log_smplayer2 ? pref->log_levels : QString("all=quiet"));
+
     if (!pref->default_font.isEmpty()) {
         QFont f;
         f.fromString(pref->default_font);
@@ -3018,32 +3039,17 @@ void BaseGui::newMediaLoaded()
 void BaseGui::clearMplayerLog()
 {
     mplayer_log.clear();
-
-    if (mplayer_log_window->isVisible()) mplayer_log_window->clear();
 }
 
 void BaseGui::recordMplayerLog(QString line)
 {
     if (pref->log_mplayer) {
         if ((line.indexOf("A:") == -1) && (line.indexOf("V:") == -1)) {
-            line.append("\n");
             mplayer_log.append(line);
-
-            if (mplayer_log_window->isVisible()) mplayer_log_window->appendText(line);
         }
     }
 }
 
-void BaseGui::recordSmplayerLog(QString line)
-{
-    if (pref->log_smplayer2) {
-        line.append("\n");
-        smplayer2_log.append(line);
-
-        if (smplayer2_log_window->isVisible()) smplayer2_log_window->appendText(line);
-    }
-}
-
 /*!
 	Save the mplayer log to a file, so it can be used by external
 	applications.
@@ -3058,7 +3064,7 @@ void BaseGui::autosaveMplayerLog()
 
             if (file.open(QIODevice::WriteOnly)) {
                 QTextStream strm(&file);
-                strm << mplayer_log;
+                strm << mplayer_log.toText();
                 file.close();
             }
         }
@@ -3071,7 +3077,6 @@ void BaseGui::showMplayerLog()
 
     exitFullscreenIfNeeded();
 
-    mplayer_log_window->setText(mplayer_log);
     mplayer_log_window->show();
 }
 
@@ -3081,7 +3086,6 @@ void BaseGui::showLog()
 
     exitFullscreenIfNeeded();
 
-    smplayer2_log_window->setText(smplayer2_log);
     smplayer2_log_window->show();
 }
 
@@ -3534,6 +3538,8 @@ void BaseGui::open(QString file)
         playlist->load_m3u(file);
     } else if (extension == "pls") {
         playlist->load_pls(file);
+    } else if (extension == "xspf") {
+        playlist->load_xspf(file);
     } else if (QFileInfo(file).isDir()) {
         openDirectory(file);
     } else {
@@ -3676,6 +3682,8 @@ void BaseGui::openFile(QString file)
             playlist->load_m3u(file);
         } else if (extension == "pls") {
             playlist->load_pls(file);
+        } else if (extension == "xspf") {
+            playlist->load_xspf(file);
         } else if (extension == "iso") {
             if (playlist->maybeSave()) {
                 core->open(file);
@@ -4384,12 +4392,7 @@ void BaseGui::gotCurrentTime(double sec)
 {
     //qDebug( "DefaultGui::displayTime: %f", sec);
 
-    static int last_second = 0;
-
-    if (floor(sec) == last_second) return; // Update only once per second
-
-    last_second = (int) floor(sec);
-
+    // Core::showTime is only emitted when the second changes
     QString time = Helper::formatTime((int) sec) + " / " +
                    Helper::formatTime((int) core->mdat.duration);
 
@@ -4757,7 +4760,7 @@ void BaseGui::showExitCodeFromMplayer(int exit_code)
         ErrorDialog d(this);
         d.setText(tr("mplayer2 has finished unexpectedly.") + " " +
                   tr("Exit code: %1").arg(exit_code));
-        d.setLog(mplayer_log);
+        d.setLog(mplayer_log.toText());
         d.exec();
     }
 }
@@ -4782,7 +4785,7 @@ void BaseGui::showErrorFromMplayer(QProcess::ProcessError e)
                       tr("See the log for more info."));
         }
 
-        d.setLog(mplayer_log);
+        d.setLog(mplayer_log.toText());
         d.exec();
     }
 }
@@ -25,6 +25,7 @@
 #include "mediasettings.h"
 #include "preferences.h"
 #include "core.h"
+#include "logbuffer.h"
 #include "config.h"
 #include "guiconfig.h"
 
@@ -77,9 +78,6 @@ public:
         pending_actions_to_run = actions;
     };
 
-    //! Saves the line from the smplayer2 output
-    void recordSmplayerLog(QString line);
-
 public slots:
     virtual void open(QString file); // Generic open, autodetect type.
     virtual void openFile();
@@ -237,6 +235,7 @@ protected slots:
     virtual void remoteViewPlaylist(QString *);
     virtual void remoteViewStatus(QString *);
     virtual void remoteViewClipInfo(QString *);
+    virtual void remoteViewStartupTimes(QString *);
     virtual void remoteSeek(double);
     virtual void remoteGetChecked(QString, QString *);
     virtual void remoteGetVolume(int *);
@@ -685,8 +684,7 @@ private:
     bool just_stopped;
 #endif
 
-    QString mplayer_log;
-    QString smplayer2_log;
+    LogBuffer mplayer_log;
 
     bool ignore_show_hide_events;
 };
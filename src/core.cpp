@@ -36,6 +36,7 @@
 #include "colorutils.h"
 #include "discname.h"
 #include "filters.h"
+#include "inforeader.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h> // To change app priority
@@ -48,6 +49,7 @@
 #ifndef NO_USE_INI_FILES
 #include "filesettings.h"
 #include "filesettingshash.h"
+#include "filesettingsindexed.h"
 #include "tvsettings.h"
 #endif
 
@@ -63,6 +65,10 @@ Core::Core(MplayerWindow *mpw, QWidget *parent)
     _state = Stopped;
 
     we_are_restarting = false;
+    reusing_process = false;
+    mplayer_is_idle = false;
+    loadfile_seek = -1;
+    restarts_avoided = 0;
     just_loaded_external_subs = false;
     just_unloaded_external_subs = false;
     change_volume_after_unpause = false;
@@ -118,6 +124,13 @@ Core::Core(MplayerWindow *mpw, QWidget *parent)
     connect(proc, SIGNAL(mplayerFullyLoaded()),
             this, SLOT(finishRestart()), Qt::QueuedConnection);
 
+    // Not queued, to get the time when they're received
+    connect(proc, SIGNAL(mplayerFullyLoaded()),
+            this, SLOT(gotFullyLoaded()));
+
+    connect(proc, SIGNAL(receivedFirstIdLine()),
+            this, SLOT(gotFirstIdLine()));
+
     connect(proc, SIGNAL(lineAvailable(QString)),
             this, SIGNAL(logLineAvailable(QString)));
 
@@ -187,6 +200,11 @@ Core::Core(MplayerWindow *mpw, QWidget *parent)
     connect(ask_timer, SIGNAL(timeout()), this, SLOT(askForInfo()));
     ask_timer->start(5000);
 
+    idle_timer = new QTimer(this);
+    idle_timer->setSingleShot(true);
+    idle_timer->setInterval(2000);
+    connect(idle_timer, SIGNAL(timeout()), this, SLOT(stopIdleProcess()));
+
     connect(proc, SIGNAL(receivedTitleIsMenu()),
             this, SLOT(dvdTitleIsMenu()));
     connect(proc, SIGNAL(receivedTitleIsMovie()),
@@ -267,6 +285,8 @@ void Core::changeFileSettingsMethod(QString method)
 
     if (method.toLower() == "hash")
         file_settings = new FileSettingsHash(Paths::iniPath());
+    else if (method.toLower() == "indexed")
+        file_settings = new FileSettingsIndexed(Paths::iniPath());
     else
         file_settings = new FileSettings(Paths::iniPath());
 }
@@ -376,6 +396,8 @@ void Core::open(QString file, int seek)
 {
     qDebug("Core::open: '%s'", file.toUtf8().data());
 
+    startup_timings.begin(file);
+
     if (file.startsWith("file:")) {
         file = QUrl(file).toLocalFile();
         qDebug("Core::open: converting url to local file: %s", file.toUtf8().constData());
@@ -592,6 +614,8 @@ void Core::openDVD(QString dvd_url)
 {
     qDebug("Core::openDVD: '%s'", dvd_url.toUtf8().data());
 
+    markStartup(StartupTimings::Open);
+
     //Checks
     DiscData disc_data = DiscName::split(dvd_url);
     QString folder = disc_data.device;
@@ -698,6 +722,8 @@ void Core::openStream(QString name)
 {
     qDebug("Core::openStream: '%s'", name.toUtf8().data());
 
+    markStartup(StartupTimings::Open);
+
     if (proc->isRunning()) {
         stopMplayer();
         we_are_restarting = false;
@@ -724,11 +750,26 @@ void Core::playNewFile(QString file, int seek)
 {
     qDebug("Core::playNewFile: '%s'", file.toUtf8().data());
 
-    if (proc->isRunning()) {
+    markStartup(StartupTimings::Open);
+
+    // Try to load the file in the running process (if options allow it).
+    // The new file is always a TYPE_FILE, the type of the previous one
+    // doesn't matter: startMplayer() compares the options of the process.
+    // Speed, delays, filters... changed while the previous file played
+    // would remain in the process, so it can't be reused then.
+    reusing_process = (pref->reuse_mplayer_process && proc->isRunning() &&
+                       (processState() == reusable_state));
+
+    if (reusing_process) {
+        qDebug("Core::playNewFile: trying to load the file in the running mplayer2");
+    }
+
+    if (proc->isRunning() && !reusing_process) {
         stopMplayer();
-        we_are_restarting = false;
     }
 
+    we_are_restarting = false;
+
     // Save data of previous file:
 #ifndef NO_USE_INI_FILES
     saveMediaInfo();
@@ -795,6 +836,7 @@ void Core::playNewFile(QString file, int seek)
 
 void Core::restartPlay()
 {
+    reusing_process = false;
     we_are_restarting = true;
     initPlaying();
 }
@@ -812,7 +854,18 @@ void Core::initPlaying(int seek)
 
     mplayerwindow->hideLogo();
 
-    if (proc->isRunning()) {
+    if (we_are_restarting) {
+        // Only new files are timed
+        startup_timings.cancel();
+    } else {
+        // Opened without Core::open()
+        if (!startup_timings.isActive()) startup_timings.begin(mdat.filename);
+
+        startup_timings.setMediaType(mdat.type);
+        markStartup(StartupTimings::Prepare);
+    }
+
+    if (proc->isRunning() && !reusing_process) {
         stopMplayer();
     }
 
@@ -820,6 +873,9 @@ void Core::initPlaying(int seek)
 
     if (seek > -1) start_sec = seek;
 
+    position.setChapters(mdat.chapters_timestamp); // Empty for a new file, until it's loaded
+    position.reset();
+
     startMplayer(mdat.filename, start_sec);
 }
 
@@ -829,12 +885,16 @@ void Core::newMediaPlaying()
 {
     qDebug("Core::newMediaPlaying: --- start ---");
 
+    position.reset();
+
     QString file = mdat.filename;
     int type = mdat.type;
     mdat = proc->mediaData();
     mdat.filename = file;
     mdat.type = type;
 
+    position.setChapters(mdat.chapters_timestamp);
+
     initializeMenus(); // Old
 
     // Video
@@ -925,6 +985,11 @@ void Core::finishRestart()
         emit mediaStartPlay();
     }
 
+    if (loadfile_seek != -1) {
+        goToSec(loadfile_seek);
+        loadfile_seek = -1;
+    }
+
     if (we_are_restarting) {
         // Update info about codecs and demuxer
         mdat.video_codec = proc->mediaData().video_codec;
@@ -1034,9 +1099,29 @@ void Core::finishRestart()
 
     updateWidgets(); // New
 
+    markStartup(StartupTimings::FinishRestart);
+
     qDebug("Core::finishRestart: --- end ---");
 }
 
+void Core::gotFirstIdLine()
+{
+    markStartup(StartupTimings::FirstIdLine);
+}
+
+void Core::gotFullyLoaded()
+{
+    markStartup(StartupTimings::FullyLoaded);
+}
+
+void Core::markStartup(StartupTimings::Stage stage)
+{
+    if (startup_timings.mark(stage)) {
+        qDebug("Core::markStartup: startup times of %s",
+               startup_timings.lastToString().toUtf8().constData());
+    }
+}
+
 void Core::initializeOSD()
 {
     changeOSD(pref->osd);
@@ -1052,6 +1137,7 @@ void Core::stop()
         qDebug("Core::stop: mset.current_sec: %f", mset.current_sec);
         mset.current_sec = 0;
         qDebug("Core::stop: mset.current_sec set to 0");
+        position.reset();
         emit showTime(mset.current_sec);
 #ifdef SEEKBAR_RESOLUTION
         emit positionChanged(0);
@@ -1202,6 +1288,17 @@ void Core::fileReachedEnd()
 
     // If we're at the end of the movie, reset to 0
     mset.current_sec = 0;
+
+    if (proc->isRunning()) {
+        // mplayer is idle, waiting for a new file (see pref->reuse_mplayer_process)
+        mplayer_is_idle = true;
+        setState(Stopped);
+
+        // Give the playlist some time to load the next file, which it does
+        // from a queued connection. loadFileInPlace() stops the timer.
+        idle_timer->start();
+    }
+
     updateWidgets();
 
     emit mediaFinished();
@@ -1221,12 +1318,14 @@ void Core::goToPosition(int value)
 void Core::goToPos(double perc)
 {
     qDebug("Core::goToPos: per: %f", perc);
+    position.reset();
     tellmp("seek " + QString::number(perc) + " 1");
 }
 #else
 void Core::goToPos(int perc)
 {
     qDebug("Core::goToPos: per: %d", perc);
+    position.reset();
     tellmp("seek " + QString::number(perc) + " 1");
 }
 #endif
@@ -1241,7 +1340,7 @@ void Core::startMplayer(QString file, double seek)
         return;
     }
 
-    if (proc->isRunning()) {
+    if (proc->isRunning() && !reusing_process) {
         qWarning("Core::startMplayer: mplayer2 still running!");
         return;
     }
@@ -1291,6 +1390,9 @@ void Core::startMplayer(QString file, double seek)
     qDebug("Core::startMplayer: url_is_playlist: %d", url_is_playlist);
 
 
+    // Position passed with -ss, if any
+    double start_seek = -1;
+
     bool screenshot_enabled = ((!pref->screenshot_directory.isEmpty()) &&
                                (QFileInfo(pref->screenshot_directory).isDir()));
 
@@ -1412,6 +1514,16 @@ void Core::startMplayer(QString file, double seek)
 
     proc->addArgument("-slave");
 
+    if (pref->reuse_mplayer_process && (mdat.type == TYPE_FILE)) {
+        // Keep mplayer running at the end of the file, waiting for the next one.
+        // The end of the file is only reported by the verbose "EOF code:"
+        // message of the "global" module (MSGT_GLOBAL, not all=6), so only
+        // that module is raised to verbose, the others keep their level.
+        proc->addArgument("-idle");
+        proc->addArgument("-msglevel");
+        proc->addArgument("global=6");
+    }
+
     if (!pref->vo.isEmpty()) {
         proc->addArgument("-vo");
         proc->addArgument(pref->vo);
@@ -1819,6 +1931,7 @@ void Core::startMplayer(QString file, double seek)
             if ((seek >= 5) && (!mset.loop)) {
                 proc->addArgument("-ss");
                 proc->addArgument(QString::number(seek));
+                start_seek = seek;
             }
     }
 
@@ -1847,87 +1960,288 @@ void Core::startMplayer(QString file, double seek)
         }
     }
 
+    // Video filters
+    QStringList video_filters = videoFilterChain();
+
+    // Upscale
+    if ((mset.upscaling_filter) && (!video_filters.isEmpty())) {
+        proc->addArgument("-sws");
+        proc->addArgument("9");
+    }
+
+    for (int n = 0; n < video_filters.count(); n++) {
+        proc->addArgument("-vf-add");
+        proc->addArgument(video_filters[n]);
+    }
+
+    // Audio channels
+    if (mset.audio_use_channels != 0) {
+        proc->addArgument("-channels");
+        proc->addArgument(QString::number(mset.audio_use_channels));
+    }
+
+    // Audio filters
+    QStringList audio_filters = audioFilterChain();
+
+    if (!audio_filters.isEmpty()) {
+        proc->addArgument("-af");
+        proc->addArgument(audio_filters.join(","));
+    }
+
+    if (pref->use_soft_vol) {
+        proc->addArgument("-softvol");
+        proc->addArgument("-softvol-max");
+        proc->addArgument(QString::number(pref->softvol_max));
+    }
+
+    // Load edl file
+    if (pref->use_edl_files) {
+        QString edl_f;
+        QFileInfo f(file);
+        QString basename = f.path() + "/" + f.completeBaseName();
+
+        qDebug("Core::startMplayer: file basename: '%s'", basename.toUtf8().data());
+
+        if (QFile::exists(basename + ".edl"))
+            edl_f = basename + ".edl";
+        else if (QFile::exists(basename + ".EDL"))
+            edl_f = basename + ".EDL";
+
+        qDebug("Core::startMplayer: edl file: '%s'", edl_f.toUtf8().data());
+
+        if (!edl_f.isEmpty()) {
+            proc->addArgument("-edl");
+            proc->addArgument(edl_f);
+        }
+    }
+
+    // Additional options supplied by the user
+    // File
+    if (!mset.mplayer_additional_options.isEmpty()) {
+        QStringList args = MyProcess::splitArguments(mset.mplayer_additional_options);
+        QStringList::Iterator it = args.begin();
+
+        while (it != args.end()) {
+            proc->addArgument((*it));
+            ++it;
+        }
+    }
+
+    // Global
+    if (!pref->mplayer_additional_options.isEmpty()) {
+        QStringList args = MyProcess::splitArguments(pref->mplayer_additional_options);
+        QStringList::Iterator it = args.begin();
+
+        while (it != args.end()) {
+            proc->addArgument((*it));
+            ++it;
+        }
+    }
+
+    // File to play
+    if (url_is_playlist) {
+        proc->addArgument("-playlist");
+    }
+
+    proc->addArgument(file);
+
+    // It seems the loop option must be after the filename
+    if (mset.loop) {
+        proc->addArgument("-loop");
+        proc->addArgument("0");
+    }
+
+    emit aboutToStartPlaying();
+
+    if (pref->reuse_mplayer_process) {
+        // The options which don't depend on the file being played
+        QStringList args = proc->arguments();
+        args.removeAll(file);
+
+        if (start_seek != -1) {
+            int pos = args.indexOf("-ss");
+
+            if (pos != -1) {
+                args.removeAt(pos);
+                args.removeAt(pos);
+            }
+        }
+
+        bool reuse = (reusing_process && proc->isRunning());
+        reusing_process = false;
+
+        if (reuse) {
+            // The filters are part of the options, so the process
+            // already runs the chains of the new file. The settings which
+            // aren't options (like the panscan) must match too.
+            if ((args == reusable_arguments) && (processState() == reusable_state)) {
+                markStartup(StartupTimings::Arguments);
+                loadFileInPlace(file, start_seek);
+                return;
+            }
+
+            qDebug("Core::startMplayer: options or settings have changed, starting a new process");
+            stopMplayer();
+        }
+
+        reusable_arguments = args;
+    }
+
+    // The new process starts with these filters
+    active_video_filters = video_filters;
+    active_audio_filters = audio_filters;
+
+    if (pref->reuse_mplayer_process) reusable_state = processState();
+
+    mplayer_is_idle = false;
+    loadfile_seek = -1;
+
+    markStartup(StartupTimings::Arguments);
+
+    QString commandline = proc->arguments().join(" ");
+    qDebug("Core::startMplayer: command: '%s'", commandline.toUtf8().data());
+
+    //Log command
+    QString line_for_log = commandline + "\n";
+    emit logLineAvailable(line_for_log);
+
+    if (!proc->start()) {
+        // error handling
+        qWarning("Core::startMplayer: mplayer process didn't start");
+        startup_timings.cancel();
+    } else {
+        markStartup(StartupTimings::Spawn);
+    }
+
+}
+
+void Core::loadFileInPlace(const QString &file, double seek)
+{
+    qDebug("Core::loadFileInPlace: '%s'", file.toUtf8().data());
+
+    idle_timer->stop();
+    proc->prepareNewFile(!mplayer_is_idle);
+    mplayer_is_idle = false;
+
+    // The position can't be set with -ss, so seek once the file is loaded
+    loadfile_seek = seek;
+
+    QString f = file;
+    f.replace("\"", "\\\"");
+
+    QString command = "loadfile \"" + f + "\"";
+    emit logLineAvailable(command + "\n");
+    tellmp(command);
+
+    markStartup(StartupTimings::Spawn);
+}
+
+QStringList Core::processState()
+{
+    QStringList l;
+
+    l << "speed=" + QString::number(mset.speed)
+      << "audio_delay=" + QString::number(mset.audio_delay)
+      << "sub_delay=" + QString::number(mset.sub_delay)
+      << "sub_scale=" + QString::number(mset.sub_scale_ass)
+      << "brightness=" + QString::number(mset.brightness)
+      << "contrast=" + QString::number(mset.contrast)
+      << "gamma=" + QString::number(mset.gamma)
+      << "hue=" + QString::number(mset.hue)
+      << "saturation=" + QString::number(mset.saturation)
+      << "panscan=" + QString::number(mset.panscan_factor)
+      << "loop=" + QString::number(mset.loop)
+      << "mute=" + QString::number(pref->global_volume ? pref->mute : mset.mute);
+
+    // The volume and the aspect ratio are set again by finishRestart()
+    // for every file
+
+    // Changed with vf_add/af_add, the equalizer with af_cmdline
+    l << "vf=" + active_video_filters.join(" ")
+      << "af=" + active_audio_filters.join(",");
+
+    return l;
+}
+
+void Core::stopIdleProcess()
+{
+    // No new file has been loaded, no need to keep mplayer running
+    if (mplayer_is_idle && proc->isRunning()) {
+        qDebug("Core::stopIdleProcess");
+        stopMplayer();
+    }
+}
+
+QStringList Core::videoFilterChain()
+{
+    QStringList filters;
+
 #ifndef Q_OS_WIN
 
     if ((pref->vdpau.disable_video_filters) && (pref->vo.startsWith("vdpau"))) {
-        qDebug("Core::startMplayer: using vdpau, video filters are ignored");
-        goto end_video_filters;
+        qDebug("Core::videoFilterChain: using vdpau, video filters are ignored");
+        return filters;
     }
 
 #endif
 
-    // Video filters:
     // Phase
     if (mset.phase_filter) {
-        proc->addArgument("-vf-add");
-        proc->addArgument("phase=A");
+        filters << "phase=A";
     }
 
     // Deinterlace
-    if (mset.current_deinterlacer != MediaSettings::NoDeinterlace) {
-        proc->addArgument("-vf-add");
-
-        switch (mset.current_deinterlacer) {
-        case MediaSettings::L5:
-            proc->addArgument("pp=l5");
-            break;
-        case MediaSettings::Yadif:
-            proc->addArgument("yadif");
-            break;
-        case MediaSettings::LB:
-            proc->addArgument("pp=lb");
-            break;
-        case MediaSettings::Yadif_1:
-            proc->addArgument("yadif=1");
-            break;
-        case MediaSettings::Kerndeint:
-            proc->addArgument("kerndeint=5");
-            break;
-        }
+    switch (mset.current_deinterlacer) {
+    case MediaSettings::L5:
+        filters << "pp=l5";
+        break;
+    case MediaSettings::Yadif:
+        filters << "yadif";
+        break;
+    case MediaSettings::LB:
+        filters << "pp=lb";
+        break;
+    case MediaSettings::Yadif_1:
+        filters << "yadif=1";
+        break;
+    case MediaSettings::Kerndeint:
+        filters << "kerndeint=5";
+        break;
     }
 
     // Denoise
     if (mset.current_denoiser != MediaSettings::NoDenoise) {
-        proc->addArgument("-vf-add");
-
         if (mset.current_denoiser == MediaSettings::DenoiseSoft) {
-            proc->addArgument(pref->filters->item("denoise_soft").filter());
+            filters << pref->filters->item("denoise_soft").filter();
         } else {
-            proc->addArgument(pref->filters->item("denoise_normal").filter());
+            filters << pref->filters->item("denoise_normal").filter();
         }
     }
 
     // Deblock
     if (mset.deblock_filter) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(pref->filters->item("deblock").filter());
+        filters << pref->filters->item("deblock").filter();
     }
 
     // Dering
     if (mset.dering_filter) {
-        proc->addArgument("-vf-add");
-        proc->addArgument("pp=dr");
+        filters << "pp=dr";
     }
 
     // Upscale
     if (mset.upscaling_filter) {
         int width = DesktopInfo::desktop_size(mplayerwindow).width();
-        proc->addArgument("-sws");
-        proc->addArgument("9");
-        proc->addArgument("-vf-add");
-        proc->addArgument("scale=" + QString::number(width) + ":-2");
+        filters << "scale=" + QString::number(width) + ":-2";
     }
 
     // Addnoise
     if (mset.noise_filter) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(pref->filters->item("noise").filter());
+        filters << pref->filters->item("noise").filter();
     }
 
     // Letterbox (expand)
     if ((mset.add_letterbox) || (pref->fullscreen && pref->add_blackborders_on_fullscreen)) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(QString("expand=:::::%1,harddup").arg(DesktopInfo::desktop_aspectRatio(mplayerwindow)));
+        filters << QString("expand=:::::%1,harddup").arg(DesktopInfo::desktop_aspectRatio(mplayerwindow));
         // Note: on some videos (h264 for instance) the subtitles doesn't disappear,
         // appearing the new ones on top of the old ones. It seems adding another
         // filter after expand fixes the problem. I chose harddup 'cos I think
@@ -1937,7 +2251,6 @@ void Core::startMplayer(QString file, double seek)
 
     // Software equalizer
     if ((pref->use_soft_video_eq)) {
-        proc->addArgument("-vf-add");
         QString eq_filter = "eq2,hue";
 
         if ((pref->vo == "gl") || (pref->vo == "gl2")
@@ -1946,207 +2259,227 @@ void Core::startMplayer(QString file, double seek)
 #endif
            ) eq_filter += ",scale";
 
-        proc->addArgument(eq_filter);
+        filters << eq_filter;
     }
 
     // Additional video filters, supplied by user
     // File
     if (!mset.mplayer_additional_video_filters.isEmpty()) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(mset.mplayer_additional_video_filters);
+        filters << mset.mplayer_additional_video_filters;
     }
 
     // Global
     if (!pref->mplayer_additional_video_filters.isEmpty()) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(pref->mplayer_additional_video_filters);
+        filters << pref->mplayer_additional_video_filters;
     }
 
     // Filters for subtitles on screenshots
     if (pref->subtitles_on_screenshots) {
-        proc->addArgument("-vf-add");
-        proc->addArgument("ass");
+        filters << "ass";
     }
 
     // Rotate
     if (mset.rotate != MediaSettings::NoRotate) {
-        proc->addArgument("-vf-add");
-        proc->addArgument(QString("rotate=%1").arg(mset.rotate));
+        filters << QString("rotate=%1").arg(mset.rotate);
     }
 
     // Flip
     if (mset.flip) {
-        proc->addArgument("-vf-add");
         // expand + flip doesn't work well, a workaround is to add another
         // filter between them, so that's why harddup is here
-        proc->addArgument("harddup,flip");
+        filters << "harddup,flip";
     }
 
     // Mirror
     if (mset.mirror) {
-        proc->addArgument("-vf-add");
-        proc->addArgument("mirror");
+        filters << "mirror";
     }
 
     // Screenshots
+    bool screenshot_enabled = ((!pref->screenshot_directory.isEmpty()) &&
+                               (QFileInfo(pref->screenshot_directory).isDir()));
+
     if (pref->subtitles_on_screenshots && screenshot_enabled) {
-        proc->addArgument("-vf-add");
-        proc->addArgument("screenshot");
+        filters << "screenshot";
     }
 
-#ifndef Q_OS_WIN
-end_video_filters:
-#endif
-
-    // Audio channels
-    if (mset.audio_use_channels != 0) {
-        proc->addArgument("-channels");
-        proc->addArgument(QString::number(mset.audio_use_channels));
-    }
+    return filters;
+}
 
-    // Audio filters
-    QString af = "";
+QStringList Core::audioFilterChain()
+{
+    QStringList filters;
 
     if (mset.karaoke_filter) {
-        af = "karaoke";
+        filters << "karaoke";
     }
 
     // Stereo mode
     if (mset.stereo_mode != 0) {
         if (mset.stereo_mode == MediaSettings::Left)
-            af += "channels=2:2:0:1:0:0";
+            filters << "channels=2:2:0:1:0:0";
         else
-            af += "channels=2:2:1:0:1:1";
+            filters << "channels=2:2:1:0:1:1";
     }
 
     if (mset.extrastereo_filter) {
-        if (!af.isEmpty()) af += ",";
-
-        af += "extrastereo";
+        filters << "extrastereo";
     }
 
     if (mset.volnorm_filter) {
-        if (!af.isEmpty()) af += ",";
-
-        af += pref->filters->item("volnorm").filter();
+        filters << pref->filters->item("volnorm").filter();
     }
 
     if (pref->use_scaletempo == Preferences::Detect) {
-        if (!af.isEmpty()) af += ",";
-
-        af += "scaletempo";
+        filters << "scaletempo";
     }
 
     // Audio equalizer
     if (pref->use_audio_equalizer) {
-        if (!af.isEmpty()) af += ",";
-
-        af += "equalizer=" + Helper::equalizerListToString(mset.audio_equalizer);
+        filters << "equalizer=" + Helper::equalizerListToString(mset.audio_equalizer);
     }
 
-
     // Additional audio filters, supplied by user
     // File
     if (!pref->mplayer_additional_audio_filters.isEmpty()) {
-        if (!af.isEmpty()) af += ",";
-
-        af += pref->mplayer_additional_audio_filters;
+        filters << pref->mplayer_additional_audio_filters;
     }
 
     // Global
     if (!mset.mplayer_additional_audio_filters.isEmpty()) {
-        if (!af.isEmpty()) af += ",";
-
-        af += mset.mplayer_additional_audio_filters;
+        filters << mset.mplayer_additional_audio_filters;
     }
 
-    if (!af.isEmpty()) {
-        // Don't use audio filters if using the S/PDIF output
-        if (pref->use_hwac3) {
-            qDebug("Core::startMplayer: audio filters are disabled when using the S/PDIF output!");
-        } else {
-            proc->addArgument("-af");
-            proc->addArgument(af);
-        }
+    // Don't use audio filters if using the S/PDIF output
+    if ((!filters.isEmpty()) && (pref->use_hwac3)) {
+        qDebug("Core::audioFilterChain: audio filters are disabled when using the S/PDIF output!");
+        filters.clear();
     }
 
-    if (pref->use_soft_vol) {
-        proc->addArgument("-softvol");
-        proc->addArgument("-softvol-max");
-        proc->addArgument(QString::number(pref->softvol_max));
+    return filters;
+}
+
+// Works out how to turn the filter chain \a active into \a wanted: the names
+// to pass to vf_del/af_del and the filters to pass to vf_add/af_add.
+// If \a keep_order is true the new filters must go at the end of the chain,
+// which is where vf_add puts them.
+static bool filterChanges(const QStringList &active, const QStringList &wanted,
+                          bool keep_order, QStringList &remove_names, QStringList &add_filters)
+{
+    QStringList kept;
+    QStringList removed;
+
+    for (int n = 0; n < active.count(); n++) {
+        if (wanted.contains(active[n])) kept << active[n];
+        else removed << active[n];
     }
 
-    // Load edl file
-    if (pref->use_edl_files) {
-        QString edl_f;
-        QFileInfo f(file);
-        QString basename = f.path() + "/" + f.completeBaseName();
+    for (int n = 0; n < wanted.count(); n++) {
+        if (!active.contains(wanted[n])) add_filters << wanted[n];
+    }
 
-        qDebug("Core::startMplayer: file basename: '%s'", basename.toUtf8().data());
+    if (keep_order) {
+        if (kept + add_filters != wanted) return false;
+    } else {
+        if (kept.count() + add_filters.count() != wanted.count()) return false;
+    }
 
-        if (QFile::exists(basename + ".edl"))
-            edl_f = basename + ".edl";
-        else if (QFile::exists(basename + ".EDL"))
-            edl_f = basename + ".EDL";
+    // vf_del and af_del remove all filters with the same name,
+    // so a filter to remove can't share the name with one to keep
+    for (int n = 0; n < removed.count(); n++) {
+        QStringList parts = removed[n].split(",");
 
-        qDebug("Core::startMplayer: edl file: '%s'", edl_f.toUtf8().data());
+        for (int i = 0; i < parts.count(); i++) {
+            QString name = parts[i].section('=', 0, 0).trimmed();
 
-        if (!edl_f.isEmpty()) {
-            proc->addArgument("-edl");
-            proc->addArgument(edl_f);
+            if (!remove_names.contains(name)) remove_names << name;
         }
     }
 
-    // Additional options supplied by the user
-    // File
-    if (!mset.mplayer_additional_options.isEmpty()) {
-        QStringList args = MyProcess::splitArguments(mset.mplayer_additional_options);
-        QStringList::Iterator it = args.begin();
+    for (int n = 0; n < kept.count(); n++) {
+        QStringList parts = kept[n].split(",");
 
-        while (it != args.end()) {
-            proc->addArgument((*it));
-            ++it;
+        for (int i = 0; i < parts.count(); i++) {
+            if (remove_names.contains(parts[i].section('=', 0, 0).trimmed())) return false;
         }
     }
 
-    // Global
-    if (!pref->mplayer_additional_options.isEmpty()) {
-        QStringList args = MyProcess::splitArguments(pref->mplayer_additional_options);
-        QStringList::Iterator it = args.begin();
+    return true;
+}
 
-        while (it != args.end()) {
-            proc->addArgument((*it));
-            ++it;
+bool Core::applyVideoFilters()
+{
+    if (!proc->isRunning()) return false;
+
+    QStringList wanted = videoFilterChain();
+    QStringList remove_names;
+    QStringList add_filters;
+
+    if (!filterChanges(active_video_filters, wanted, true, remove_names, add_filters)) {
+        qDebug("Core::applyVideoFilters: the filter chain can't be changed, mplayer2 must be restarted");
+        return false;
+    }
+
+    if ((!remove_names.isEmpty()) || (!add_filters.isEmpty())) {
+        QStringList commands = InfoReader::obj()->commandList();
+
+        if ((!commands.contains("vf_add")) || (!commands.contains("vf_del"))) {
+            qDebug("Core::applyVideoFilters: vf_add/vf_del not supported, mplayer2 must be restarted");
+            return false;
         }
     }
 
-    // File to play
-    if (url_is_playlist) {
-        proc->addArgument("-playlist");
+    if (!remove_names.isEmpty()) {
+        tellmp("vf_del " + remove_names.join(","));
     }
 
-    proc->addArgument(file);
+    for (int n = 0; n < add_filters.count(); n++) {
+        tellmp("vf_add " + add_filters[n]);
+    }
 
-    // It seems the loop option must be after the filename
-    if (mset.loop) {
-        proc->addArgument("-loop");
-        proc->addArgument("0");
+    active_video_filters = wanted;
+
+    // Only count it if something has been sent to mplayer2
+    if ((!remove_names.isEmpty()) || (!add_filters.isEmpty())) {
+        restarts_avoided++;
+        qDebug("Core::applyVideoFilters: restarts avoided: %d", restarts_avoided);
     }
 
-    emit aboutToStartPlaying();
+    return true;
+}
 
-    QString commandline = proc->arguments().join(" ");
-    qDebug("Core::startMplayer: command: '%s'", commandline.toUtf8().data());
+bool Core::applyAudioFilters(bool avoids_restart)
+{
+    if (!proc->isRunning()) return false;
 
-    //Log command
-    QString line_for_log = commandline + "\n";
-    emit logLineAvailable(line_for_log);
+    QStringList wanted = audioFilterChain();
+    QStringList remove_names;
+    QStringList add_filters;
 
-    if (!proc->start()) {
-        // error handling
-        qWarning("Core::startMplayer: mplayer process didn't start");
+    // The order of the audio filters isn't kept, as it was before
+    // when af_add/af_del were used directly
+    if (!filterChanges(active_audio_filters, wanted, false, remove_names, add_filters)) {
+        qDebug("Core::applyAudioFilters: the filter chain can't be changed, mplayer2 must be restarted");
+        return false;
+    }
+
+    if (!remove_names.isEmpty()) {
+        tellmp("af_del " + remove_names.join(","));
     }
 
+    for (int n = 0; n < add_filters.count(); n++) {
+        tellmp("af_add " + add_filters[n]);
+    }
+
+    active_audio_filters = wanted;
+
+    // Only count it if something has been sent to mplayer2
+    if (avoids_restart && ((!remove_names.isEmpty()) || (!add_filters.isEmpty()))) {
+        restarts_avoided++;
+        qDebug("Core::applyAudioFilters: restarts avoided: %d", restarts_avoided);
+    }
+
+    return true;
 }
 
 void Core::stopMplayer()
@@ -2179,6 +2512,7 @@ void Core::goToSec(double sec)
 
     if (sec > mdat.duration) sec = mdat.duration - 20;
 
+    position.reset();
     tellmp("seek " + QString::number(sec) + " 2");
 }
 
@@ -2188,6 +2522,7 @@ void Core::seek(int secs)
     qDebug("Core::seek: %d", secs);
 
     if ((proc->isRunning()) && (secs != 0)) {
+        position.reset();
         tellmp("seek " + QString::number(secs) + " 0");
     }
 }
@@ -2376,7 +2711,7 @@ void Core::toggleFlip(bool b)
     if (mset.flip != b) {
         mset.flip = b;
 
-        if (proc->isRunning()) restartPlay();
+        if (proc->isRunning() && !applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2393,7 +2728,7 @@ void Core::toggleMirror(bool b)
     if (mset.mirror != b) {
         mset.mirror = b;
 
-        if (proc->isRunning()) restartPlay();
+        if (proc->isRunning() && !applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2410,9 +2745,8 @@ void Core::toggleKaraoke(bool b)
     if (b != mset.karaoke_filter) {
         mset.karaoke_filter = b;
 
-        // Change filter without restarting
-        if (b) tellmp("af_add karaoke");
-        else tellmp("af_del karaoke");
+        // Changed live before too, it's not a restart avoided
+        if (proc->isRunning() && !applyAudioFilters(false)) restartPlay();
     }
 }
 
@@ -2428,9 +2762,8 @@ void Core::toggleExtrastereo(bool b)
     if (b != mset.extrastereo_filter) {
         mset.extrastereo_filter = b;
 
-        // Change filter without restarting
-        if (b) tellmp("af_add extrastereo");
-        else tellmp("af_del extrastereo");
+        // Changed live before too, it's not a restart avoided
+        if (proc->isRunning() && !applyAudioFilters(false)) restartPlay();
     }
 }
 
@@ -2445,11 +2778,9 @@ void Core::toggleVolnorm(bool b)
 
     if (b != mset.volnorm_filter) {
         mset.volnorm_filter = b;
-        // Change filter without restarting
-        QString f = pref->filters->item("volnorm").filter();
 
-        if (b) tellmp("af_add " + f);
-        else tellmp("af_del volnorm");
+        // Changed live before too, it's not a restart avoided
+        if (proc->isRunning() && !applyAudioFilters(false)) restartPlay();
     }
 }
 
@@ -2469,7 +2800,8 @@ void Core::setStereoMode(int mode)
 
     if (mode != mset.stereo_mode) {
         mset.stereo_mode = mode;
-        restartPlay();
+
+        if (!applyAudioFilters()) restartPlay();
     }
 }
 
@@ -2486,7 +2818,8 @@ void Core::toggleAutophase(bool b)
 
     if (b != mset.phase_filter) {
         mset.phase_filter = b;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2501,7 +2834,8 @@ void Core::toggleDeblock(bool b)
 
     if (b != mset.deblock_filter) {
         mset.deblock_filter = b;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2516,7 +2850,8 @@ void Core::toggleDering(bool b)
 
     if (b != mset.dering_filter) {
         mset.dering_filter = b;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2531,7 +2866,8 @@ void Core::toggleNoise(bool b)
 
     if (b != mset.noise_filter) {
         mset.noise_filter = b;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2541,7 +2877,8 @@ void Core::changeDenoise(int id)
 
     if (id != mset.current_denoiser) {
         mset.current_denoiser = id;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2551,7 +2888,9 @@ void Core::changeUpscale(bool b)
 
     if (mset.upscaling_filter != b) {
         mset.upscaling_filter = b;
-        restartPlay();
+
+        // -sws can't be changed in the running mplayer2
+        if (b || !applyVideoFilters()) restartPlay();
     }
 }
 
@@ -2927,7 +3266,8 @@ void Core::setAudioEqualizer(AudioEqualizerList values, bool restart)
     if (!restart) {
         const char *command = "af_cmdline equalizer ";
         tellmp(command + Helper::equalizerListToString(values));
-    } else {
+        active_audio_filters = audioFilterChain();
+    } else if (!applyAudioFilters()) {
         restartPlay();
     }
 
@@ -3005,6 +3345,8 @@ void Core::changeCurrentSec(double sec)
 {
     mset.current_sec = sec;
 
+    if (startup_timings.isActive()) markStartup(StartupTimings::FirstPosition);
+
     if (mset.starting_time != -1) {
         mset.current_sec -= mset.starting_time;
     }
@@ -3016,37 +3358,31 @@ void Core::changeCurrentSec(double sec)
         //emit stateChanged(state());
     }
 
-    emit showTime(mset.current_sec);
-
-    // Emit posChanged:
-    static int last_second = 0;
-
-    if (floor(sec) == last_second) return; // Update only once per second
-
-    last_second = (int) floor(sec);
-
-    int newChapter = mset.current_chapter_id;
-    QMap<int, long long>::iterator i;
-
-    for (i = mdat.chapters_timestamp.begin(); i != mdat.chapters_timestamp.end(); ++i) {
-        if ((long long)sec * 1000 >= i.value())
-            newChapter = i.key();
-        else
-            break;
+    // Update the time only once per second
+    if (position.publishSecond(mset.current_sec)) {
+        emit showTime(mset.current_sec);
     }
 
-    if (newChapter != mset.current_chapter_id)
+    // The chapter is checked on every update, so the change is
+    // detected as soon as the boundary is crossed
+    int newChapter = position.chapterAt((long long) (sec * 1000));
+
+    if ((newChapter != -1) && position.publishChapter(newChapter) &&
+            (newChapter != mset.current_chapter_id)) {
         emit updateChapter(newChapter);
+    }
 
+    // Emit posChanged:
 #ifdef SEEKBAR_RESOLUTION
     int value = 0;
 
     if ((mdat.duration > 1) && (mset.current_sec > 1) &&
             (mdat.duration > mset.current_sec)) {
-        value = ((int) mset.current_sec * SEEKBAR_RESOLUTION) / (int) mdat.duration;
+        value = (int) (mset.current_sec * SEEKBAR_RESOLUTION / mdat.duration);
     }
 
-    emit positionChanged(value);
+    if (position.publishPosition(value)) emit positionChanged(value);
+
 #else
     int perc = 0;
 
@@ -3055,7 +3391,8 @@ void Core::changeCurrentSec(double sec)
         perc = ((int) mset.current_sec * 100) / (int) mdat.duration;
     }
 
-    emit posChanged(perc);
+    if (position.publishPosition(perc)) emit posChanged(perc);
+
 #endif
 }
 
@@ -3085,7 +3422,8 @@ void Core::changeDeinterlace(int ID)
 
     if (ID != mset.current_deinterlacer) {
         mset.current_deinterlacer = ID;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -3318,6 +3656,8 @@ void Core::changeTitle(int ID)
 void Core::changeChapter(int ID, bool relative)
 {
     if (ID != mset.current_chapter_id || relative == true) {
+        position.reset();
+
         if (mdat.type != TYPE_DVD) {
             tellmp("seek_chapter " + QString::number(ID) + (relative ? " 0" : " 1"));
             tellmp("get_property chapter");
@@ -3474,7 +3814,8 @@ void Core::changeLetterbox(bool b)
 
     if (mset.add_letterbox != b) {
         mset.add_letterbox = b;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
@@ -3504,7 +3845,8 @@ void Core::changeRotate(int r)
 
     if (mset.rotate != r) {
         mset.rotate = r;
-        restartPlay();
+
+        if (!applyVideoFilters()) restartPlay();
     }
 }
 
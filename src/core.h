@@ -22,9 +22,12 @@
 #include <QObject>
 #include <QProcess> // For QProcess::ProcessError
 #include <QPoint>
+#include <QStringList>
 #include "mediadata.h"
 #include "mediasettings.h"
 #include "mplayerprocess.h"
+#include "positiontracker.h"
+#include "startuptimings.h"
 #include "config.h"
 
 #ifndef NO_USE_INI_FILES
@@ -34,6 +37,7 @@ class FileSettingsBase;
 class MplayerProcess;
 class MplayerWindow;
 class QSettings;
+class QTimer;
 
 #ifdef Q_OS_WIN
 #ifdef SCREENSAVER_OFF
@@ -63,6 +67,17 @@ public:
     //! so it can be printed on debugging messages.
     QString stateToString();
 
+    //! Number of times a setting has been changed in the running mplayer2
+    //! instead of restarting it, since the program started
+    int restartsAvoided() {
+        return restarts_avoided;
+    };
+
+    //! Time taken by each stage of the last opens
+    StartupTimings *startupTimings() {
+        return &startup_timings;
+    };
+
 protected:
     //! Change the current state (Stopped, Playing or Paused)
     //! And sends the stateChanged() signal.
@@ -341,7 +356,10 @@ protected slots:
 
     void finishRestart();
     void processFinished();
+    void gotFirstIdLine();
+    void gotFullyLoaded();
     void fileReachedEnd();
+    void stopIdleProcess();
 
     void displayMessage(QString text);
     void displayScreenshotName(QString filename);
@@ -386,8 +404,30 @@ protected:
     void initPlaying(int seek = -1);
     void newMediaPlaying();
 
+    //! Records that \a stage has been reached, and logs the times when
+    //! the open has finished
+    void markStartup(StartupTimings::Stage stage);
+
     void startMplayer(QString file, double seek = -1);
     void stopMplayer();
+    //! Plays \a file in the running mplayer2 with the loadfile command
+    void loadFileInPlace(const QString &file, double seek);
+    //! Settings changed at runtime that mplayer2 keeps after a loadfile,
+    //! as they are now. A process is only reused if they haven't changed
+    //! since it was started.
+    QStringList processState();
+
+    //! Filters passed to mplayer2 with -vf-add and -af, for the current settings
+    QStringList videoFilterChain();
+    QStringList audioFilterChain();
+
+    //! Changes the filters of the running mplayer2 to the ones of the current
+    //! settings with vf_add/vf_del (af_add/af_del). Returns false if that's
+    //! not possible and mplayer2 must be restarted. \a avoids_restart is
+    //! false for the changes that never needed a restart, so they aren't
+    //! counted in restartsAvoided().
+    bool applyVideoFilters();
+    bool applyAudioFilters(bool avoids_restart = true);
 
 #ifndef NO_USE_INI_FILES
     void saveMediaInfo();
@@ -442,6 +482,11 @@ protected:
     MplayerProcess *proc;
     MplayerWindow *mplayerwindow;
 
+    //! Last time, chapter and seek bar position sent to the GUI
+    PositionTracker position;
+
+    StartupTimings startup_timings;
+
 #ifndef NO_USE_INI_FILES
     FileSettingsBase *file_settings;
     FileSettingsBase *tv_settings;
@@ -457,6 +502,20 @@ private:
     // Some variables to proper restart
     bool we_are_restarting;
 
+    // To load files in the running process (pref->reuse_mplayer_process)
+    bool reusing_process;
+    bool mplayer_is_idle;
+    //! Stops mplayer if no other file is loaded soon after the end of the file
+    QTimer *idle_timer;
+    double loadfile_seek;
+    QStringList reusable_arguments;
+    QStringList reusable_state;
+
+    // Filters the running mplayer2 is using
+    QStringList active_video_filters;
+    QStringList active_audio_filters;
+    int restarts_avoided;
+
     bool just_loaded_external_subs;
     bool just_unloaded_external_subs;
     State _state;
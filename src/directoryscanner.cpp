@@ -0,0 +1,210 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "directoryscanner.h"
+#include "extensions.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QTime>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+// A batch is sent when it has this many files or it's older than
+// BATCH_TIME ms, whatever happens first
+#define BATCH_SIZE 500
+#define BATCH_TIME 250
+
+// Entries of a directory read between checks for a cancelled scan
+#define CANCEL_CHECK_ENTRIES 1000
+
+// Same order as QDir::Name | QDir::IgnoreCase, used by the old version
+static bool caseInsensitiveLessThan(const QString &s1, const QString &s2)
+{
+    return s1.compare(s2, Qt::CaseInsensitive) < 0;
+}
+
+DirectoryScanner::DirectoryScanner(QObject *parent)
+    : BackgroundWorker(parent)
+{
+    last_id = -1;
+    dirs_scanned = 0;
+    files_found = 0;
+
+    // Built once, instead of a regexp for every directory
+    Extensions e;
+    ExtensionList l = e.multimedia();
+
+    for (int n = 0; n < l.count(); n++) {
+        extensions.insert(l[n].toLower());
+    }
+
+    connect(this, SIGNAL(finished()), this, SLOT(threadFinished()));
+}
+
+DirectoryScanner::~DirectoryScanner()
+{
+    stop();
+}
+
+void DirectoryScanner::scan(const QString &dir, bool recursive)
+{
+    qDebug("DirectoryScanner::scan: '%s' (recursive: %d)", dir.toUtf8().constData(), recursive);
+
+    QMutexLocker locker(&mutex);
+
+    queue.append(qMakePair(dir, recursive));
+    wakeUp();
+}
+
+void DirectoryScanner::clearQueue()
+{
+    qDebug("DirectoryScanner::clearQueue: %d directories in the queue", queue.count());
+
+    queue.clear();
+}
+
+bool DirectoryScanner::isMultimedia(const QString &filename) const
+{
+    int pos = filename.lastIndexOf('.');
+
+    if (pos < 0) return false;
+
+    return extensions.contains(filename.mid(pos + 1).toLower());
+}
+
+void DirectoryScanner::threadStarted()
+{
+    last_id = -1;
+}
+
+bool DirectoryScanner::takeWork()
+{
+    if (queue.isEmpty()) return false;
+
+    current = queue.takeFirst();
+
+    return true;
+}
+
+void DirectoryScanner::doWork(int id)
+{
+    if (id != last_id) {
+        // A new scan, after cancel() or the first one of this run
+        visited.clear();
+        dirs_scanned = 0;
+        files_found = 0;
+        last_id = id;
+    }
+
+    scanDirectory(current.first, current.second, id);
+}
+
+bool DirectoryScanner::scanDirectory(const QString &dir, bool recursive, int id)
+{
+    QStringList batch;
+    QTime batch_time;
+    batch_time.start();
+
+    // Depth first, keeping the order of the old recursive version:
+    // the files of a directory, then its subdirectories
+    QStringList pending;
+    pending << dir;
+
+    while (!pending.isEmpty()) {
+        if (isCancelled(id)) return false;
+
+        QString path = pending.takeLast();
+        QString canonical = QFileInfo(path).canonicalFilePath();
+
+        if (canonical.isEmpty() || visited.contains(canonical)) {
+            qDebug("DirectoryScanner::scanDirectory: skipping '%s'", path.toUtf8().constData());
+            continue;
+        }
+
+        visited.insert(canonical);
+        dirs_scanned++;
+
+        QStringList files;
+        QStringList subdirs;
+
+        QDir::Filters filter = QDir::Files | QDir::NoDotAndDotDot;
+
+        if (recursive) filter |= QDir::AllDirs;
+
+        QDirIterator it(path, filter);
+        int entries = 0;
+
+        while (it.hasNext()) {
+            // A directory may have many thousands of entries
+            if ((++entries % CANCEL_CHECK_ENTRIES == 0) && (isCancelled(id))) return false;
+
+            QString filename = it.next();
+
+            if (it.fileInfo().isDir()) {
+                subdirs << filename;
+            } else if (isMultimedia(filename)) {
+                files << filename;
+            }
+        }
+
+        qSort(files.begin(), files.end(), caseInsensitiveLessThan);
+        qSort(subdirs.begin(), subdirs.end(), caseInsensitiveLessThan);
+
+        files_found += files.count();
+        batch += files;
+
+        // Reversed, so the first one is taken next
+        for (int n = subdirs.count() - 1; n >= 0; n--) pending << subdirs[n];
+
+        if ((batch.count() >= BATCH_SIZE) || (batch_time.elapsed() >= BATCH_TIME)) {
+            sendBatch(batch, id);
+            batch_time.restart();
+        }
+    }
+
+    sendBatch(batch, id);
+
+    return true;
+}
+
+void DirectoryScanner::sendBatch(QStringList &files, int id)
+{
+    QVariantList batch;
+    batch << QVariant(files) << dirs_scanned << files_found;
+
+    sendResult(batch, id);
+    files.clear();
+}
+
+void DirectoryScanner::receiveResult(const QVariant &result)
+{
+    QVariantList batch = result.toList();
+    QStringList files = batch[0].toStringList();
+
+    if (!files.isEmpty()) emit filesFound(files);
+
+    emit progress(batch[1].toInt(), batch[2].toInt());
+}
+
+void DirectoryScanner::threadFinished()
+{
+    // A new scan may have been started meanwhile
+    if (!isScanning()) emit scanFinished();
+}
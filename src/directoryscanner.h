@@ -0,0 +1,93 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _DIRECTORYSCANNER_H_
+#define _DIRECTORYSCANNER_H_
+
+#include "backgroundworker.h"
+#include <QStringList>
+#include <QSet>
+#include <QPair>
+
+//! DirectoryScanner looks for multimedia files in directories in the background.
+
+/*!
+ The directories are walked by a thread, so slow disks or network
+ shares don't block the GUI. The files found are sent in batches with
+ filesFound() while the scan is still running, each batch sorted by
+ name. Directories already visited (reached again through a symlink)
+ are skipped.
+*/
+
+class DirectoryScanner : public BackgroundWorker
+{
+    Q_OBJECT
+
+public:
+    DirectoryScanner(QObject *parent = 0);
+    ~DirectoryScanner();
+
+    //! Adds the directory to the queue and starts the thread if needed
+    void scan(const QString &dir, bool recursive);
+
+    bool isScanning() { return isBusy(); }
+
+    //! Returns true if the extension of \a filename is a multimedia one
+    bool isMultimedia(const QString &filename) const;
+
+signals:
+    //! Some files found, in the order they should be added
+    void filesFound(QStringList files);
+
+    //! Number of directories and files found so far
+    void progress(int dirs, int files);
+
+    //! The queue is empty, or the scan was cancelled
+    void scanFinished();
+
+protected slots:
+    void threadFinished();
+
+protected:
+    virtual void threadStarted();
+    virtual bool takeWork();
+    virtual void doWork(int id);
+    virtual void clearQueue();
+    virtual void receiveResult(const QVariant &result);
+
+    //! Walks one of the queued directories. Returns false if cancelled.
+    bool scanDirectory(const QString &dir, bool recursive, int id);
+    void sendBatch(QStringList &files, int id);
+
+protected:
+    QSet<QString> extensions;
+
+    // Protected by mutex
+    QList<QPair<QString, bool> > queue;
+
+    // Only used by the thread
+    QPair<QString, bool> current;
+    //! Id of the scan visited belongs to
+    int last_id;
+    QSet<QString> visited;
+    int dirs_scanned;
+    int files_found;
+};
+
+#endif
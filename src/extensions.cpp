@@ -67,7 +67,7 @@ Extensions::Extensions()
     _subtitles << "srt" << "sub" << "ssa" << "ass" << "idx" << "txt" << "smi"
                << "rt" << "utf" << "aqt";
 
-    _playlist << "m3u" << "m3u8" << "pls";
+    _playlist << "m3u" << "m3u8" << "pls" << "xspf";
 
     _multimedia = _video;
 
@@ -0,0 +1,82 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "filechecker.h"
+#include <QFileInfo>
+#include <QMutexLocker>
+
+// Files taken from the queue at once
+#define BATCH_SIZE 200
+
+FileChecker::FileChecker(QObject *parent)
+    : BackgroundWorker(parent)
+{
+}
+
+FileChecker::~FileChecker()
+{
+    stop();
+}
+
+void FileChecker::check(const QStringList &files)
+{
+    qDebug("FileChecker::check: %d files", files.count());
+
+    if (files.isEmpty()) return;
+
+    QMutexLocker locker(&mutex);
+
+    queue += files;
+    wakeUp();
+}
+
+void FileChecker::clearQueue()
+{
+    queue.clear();
+}
+
+bool FileChecker::takeWork()
+{
+    if (queue.isEmpty()) return false;
+
+    files = queue.mid(0, BATCH_SIZE);
+    queue.erase(queue.begin(), queue.begin() + files.count());
+
+    return true;
+}
+
+void FileChecker::doWork(int id)
+{
+    QStringList missing;
+
+    for (int n = 0; n < files.count(); n++) {
+        const QString &filename = files[n];
+
+        // dvd://, http://...
+        if (filename.contains("://")) continue;
+
+        if (!QFileInfo(filename).exists()) missing << filename;
+    }
+
+    if (!missing.isEmpty()) sendResult(missing, id);
+}
+
+void FileChecker::receiveResult(const QVariant &result)
+{
+    emit filesMissing(result.toStringList());
+}
@@ -0,0 +1,63 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _FILECHECKER_H_
+#define _FILECHECKER_H_
+
+#include "backgroundworker.h"
+#include <QStringList>
+
+//! FileChecker looks for files which don't exist, in the background.
+
+/*!
+ Used for the entries of playlist files, which are loaded without
+ checking them. The files are checked by a thread, so a long list on a
+ slow disk or a network share doesn't block the GUI. The missing ones
+ are sent in batches with filesMissing(). URLs are not checked.
+*/
+
+class FileChecker : public BackgroundWorker
+{
+    Q_OBJECT
+
+public:
+    FileChecker(QObject *parent = 0);
+    ~FileChecker();
+
+    //! Adds the files to the queue and starts the thread if needed
+    void check(const QStringList &files);
+
+signals:
+    //! Some of the files don't exist
+    void filesMissing(QStringList files);
+
+protected:
+    virtual bool takeWork();
+    virtual void doWork(int id);
+    virtual void clearQueue();
+    virtual void receiveResult(const QVariant &result);
+
+protected:
+    // Protected by mutex
+    QStringList queue;
+
+    // Only used by the thread
+    QStringList files;
+};
+
+#endif
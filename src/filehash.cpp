@@ -0,0 +1,93 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "filehash.h"
+#include "findsubtitles/osparser.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+
+// The cache is cleared when it reaches this size
+#define MAX_ENTRIES 10000
+
+QHash<QString, FileHash::Entry> FileHash::cache;
+QMutex FileHash::mutex;
+int FileHash::hit_count = 0;
+int FileHash::miss_count = 0;
+
+QString FileHash::hash(const QString &filename)
+{
+    QFileInfo fi(filename);
+
+    if (!fi.exists()) return QString();
+
+    QString key = fi.absoluteFilePath();
+    qint64 size = fi.size();
+    uint modified = fi.lastModified().toTime_t();
+
+    {
+        QMutexLocker locker(&mutex);
+
+        QHash<QString, Entry>::const_iterator it = cache.constFind(key);
+
+        if ((it != cache.constEnd()) && (it->size == size) && (it->modified == modified)) {
+            hit_count++;
+            return it->hash;
+        }
+
+        miss_count++;
+    }
+
+    // Not locked while reading the file, it may be slow
+    Entry e;
+    e.size = size;
+    e.modified = modified;
+    e.hash = OSParser::calculateHash(filename);
+
+    qDebug("FileHash::hash: '%s': %s (hits: %d, misses: %d)", filename.toUtf8().constData(),
+           e.hash.toUtf8().constData(), hits(), misses());
+
+    if (!e.hash.isEmpty()) {
+        QMutexLocker locker(&mutex);
+
+        if (cache.count() >= MAX_ENTRIES) cache.clear();
+
+        cache.insert(key, e);
+    }
+
+    return e.hash;
+}
+
+void FileHash::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+int FileHash::hits()
+{
+    QMutexLocker locker(&mutex);
+    return hit_count;
+}
+
+int FileHash::misses()
+{
+    QMutexLocker locker(&mutex);
+    return miss_count;
+}
@@ -0,0 +1,72 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _FILEHASH_H_
+#define _FILEHASH_H_
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+
+//! FileHash gives the OpenSubtitles hash of files, remembering it.
+
+/*!
+ Calculating the hash reads the beginning and the end of the file, which
+ is slow on network shares. The results are kept for the session, found
+ by the absolute path and checked against the size and modification
+ time, so each file is read at most once unless it changes.
+
+ It can be used from any thread.
+*/
+
+class FileHash
+{
+
+public:
+    //! Returns the hash of the file, or an empty string if it can't be
+    //! calculated (the file doesn't exist, it's not a local file...)
+    static QString hash(const QString &filename);
+
+    //! Forgets all the hashes
+    static void clear();
+
+    static int hits();
+    static int misses();
+
+protected:
+    class Entry
+    {
+    public:
+        Entry() {
+            size = 0;
+            modified = 0;
+        };
+
+        qint64 size;
+        uint modified;
+        QString hash;
+    };
+
+    static QHash<QString, Entry> cache;
+    static QMutex mutex;
+    static int hit_count;
+    static int miss_count;
+};
+
+#endif
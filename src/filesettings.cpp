@@ -18,6 +18,7 @@
 
 #include "filesettings.h"
 #include "mediasettings.h"
+#include "loglevels.h"
 #include <QSettings>
 #include <QFileInfo>
 
@@ -51,11 +52,11 @@ QString FileSettings::filenameToGroupname(const QString &filename)
 
 bool FileSettings::existSettingsFor(QString filename)
 {
-    qDebug("FileSettings::existSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::existSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString group_name = filenameToGroupname(filename);
 
-    qDebug("FileSettings::existSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::existSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
 
     my_settings->beginGroup(group_name);
     bool saved = my_settings->value("saved", false).toBool();
@@ -66,11 +67,11 @@ bool FileSettings::existSettingsFor(QString filename)
 
 void FileSettings::loadSettingsFor(QString filename, MediaSettings &mset)
 {
-    qDebug("FileSettings::loadSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::loadSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString group_name = filenameToGroupname(filename);
 
-    qDebug("FileSettings::loadSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::loadSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
 
     mset.reset();
     my_settings->beginGroup(group_name);
@@ -80,11 +81,11 @@ void FileSettings::loadSettingsFor(QString filename, MediaSettings &mset)
 
 void FileSettings::saveSettingsFor(QString filename, MediaSettings &mset)
 {
-    qDebug("FileSettings::saveSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::saveSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString group_name = filenameToGroupname(filename);
 
-    qDebug("FileSettings::saveSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::saveSettingsFor: group_name: '%s'", group_name.toUtf8().constData());
 
     my_settings->beginGroup(group_name);
     my_settings->setValue("saved", true);
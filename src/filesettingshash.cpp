@@ -18,7 +18,8 @@
 
 #include "filesettingshash.h"
 #include "mediasettings.h"
-#include "findsubtitles/osparser.h" // hash function
+#include "filehash.h"
+#include "loglevels.h"
 #include <QSettings>
 #include <QFile>
 #include <QDir>
@@ -37,7 +38,7 @@ QString FileSettingsHash::configFile(const QString &filename, QString *output_di
 {
     QString res;
 
-    QString hash = OSParser::calculateHash(filename);
+    QString hash = FileHash::hash(filename);
 
     if (!hash.isEmpty()) {
         if (output_dir != 0)(*output_dir) = hash[0];
@@ -50,22 +51,22 @@ QString FileSettingsHash::configFile(const QString &filename, QString *output_di
 
 bool FileSettingsHash::existSettingsFor(QString filename)
 {
-    qDebug("FileSettingsHash::existSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::existSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString config_file = configFile(filename);
 
-    qDebug("FileSettingsHash::existSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::existSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
 
     return QFile::exists(config_file);
 }
 
 void FileSettingsHash::loadSettingsFor(QString filename, MediaSettings &mset)
 {
-    qDebug("FileSettings::loadSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettings::loadSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString config_file = configFile(filename);
 
-    qDebug("FileSettingsHash::loadSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::loadSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
 
     mset.reset();
 
@@ -80,13 +81,13 @@ void FileSettingsHash::loadSettingsFor(QString filename, MediaSettings &mset)
 
 void FileSettingsHash::saveSettingsFor(QString filename, MediaSettings &mset)
 {
-    qDebug("FileSettingsHash::saveSettingsFor: '%s'", filename.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::saveSettingsFor: '%s'", filename.toUtf8().constData());
 
     QString output_dir;
     QString config_file = configFile(filename, &output_dir);
 
-    qDebug("FileSettingsHash::saveSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
-    qDebug("FileSettingsHash::saveSettingsFor: output_dir: '%s'", output_dir.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::saveSettingsFor: config_file: '%s'", config_file.toUtf8().constData());
+    LOG_DEBUG(Log::Settings, "FileSettingsHash::saveSettingsFor: output_dir: '%s'", output_dir.toUtf8().constData());
 
     if (!config_file.isEmpty()) {
         QDir d(base_dir);
@@ -0,0 +1,488 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "filesettingsindexed.h"
+#include "filesettings.h"
+#include "mediasettings.h"
+#include "filehash.h"
+#include "loglevels.h"
+#include <QSettings>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QPair>
+#include <QtAlgorithms>
+
+// Increase it if the format of the file changes
+#define STORE_MAGIC 0x534d4653 // SMFS
+#define STORE_VERSION 1
+
+// Compact when the replaced records use more than this and more than
+// the current ones
+#define MIN_DEAD_BYTES (1024 * 1024)
+
+// Key prefixes of what isn't a hash
+#define KEY_FILENAME "file:"
+#define KEY_OLD_GROUP "group:"
+// Its record saves when the old settings were last imported
+#define KEY_IMPORT "import:"
+
+FileSettingsIndexed::FileSettingsIndexed(QString directory) : FileSettingsBase(directory)
+{
+    file_name = directory + "/smplayer2_filesettings.dat";
+    dead_bytes = 0;
+    max_entries = 20000;
+    max_age = 730;
+
+    // The program may have died while compact() was replacing the file.
+    // The .new file is complete if the old one has already been renamed.
+    if (!QFile::exists(file_name)) {
+        if (QFile::exists(file_name + ".new")) {
+            QFile::rename(file_name + ".new", file_name);
+        } else if (QFile::exists(file_name + ".old")) {
+            QFile::rename(file_name + ".old", file_name);
+        }
+    }
+
+    QFile::remove(file_name + ".old");
+
+    bool first_time = !QFile::exists(file_name);
+
+    if (!open()) return;
+
+    // Also after the first time: the settings may have been changed
+    // while another method was chosen
+    importOldSettings();
+
+    if (first_time) {
+        compact();
+    } else if ((dead_bytes > MIN_DEAD_BYTES) && (dead_bytes > file.size() - dead_bytes)) {
+        compact();
+    }
+}
+
+FileSettingsIndexed::~FileSettingsIndexed()
+{
+    file.close();
+}
+
+bool FileSettingsIndexed::open()
+{
+    file.setFileName(file_name);
+
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning("FileSettingsIndexed::open: can't open '%s'", file_name.toUtf8().constData());
+        return false;
+    }
+
+    if (file.size() == 0) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_4_4);
+        stream << (quint32) STORE_MAGIC << (qint32) STORE_VERSION;
+        file.flush();
+    }
+
+    return readIndex();
+}
+
+bool FileSettingsIndexed::readIndex()
+{
+    index.clear();
+    dead_bytes = 0;
+
+    file.seek(0);
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    quint32 magic;
+    qint32 version;
+    stream >> magic >> version;
+
+    if ((magic != STORE_MAGIC) || (version != STORE_VERSION)) {
+        qWarning("FileSettingsIndexed::readIndex: unknown format, starting a new file");
+        file.resize(0);
+        stream.resetStatus();
+        stream << (quint32) STORE_MAGIC << (qint32) STORE_VERSION;
+        file.flush();
+        return true;
+    }
+
+    qint64 valid_end = file.pos();
+
+    while (!stream.atEnd()) {
+        QString key;
+        Entry e;
+        stream >> key >> e.saved >> e.size;
+
+        e.offset = file.pos();
+
+        // Truncated, the program died while writing it
+        if ((stream.status() != QDataStream::Ok) ||
+            (e.offset + e.size + 2 > file.size())) {
+            break;
+        }
+
+        QMap<QString, Entry>::iterator it = index.find(key);
+
+        if (it != index.end()) {
+            dead_bytes += it->size;
+            index.erase(it);
+        }
+
+        // An empty record means the key was removed
+        if (e.size > 0) index.insert(key, e);
+        else dead_bytes += key.size() * 2;
+
+        file.seek(e.offset + e.size + 2);
+        valid_end = file.pos();
+    }
+
+    if (valid_end < file.size()) {
+        qWarning("FileSettingsIndexed::readIndex: removing %lld bytes of an incomplete record",
+                 (long long)(file.size() - valid_end));
+        file.resize(valid_end);
+    }
+
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::readIndex: %d entries, %lld bytes not used", index.count(), (long long) dead_bytes);
+
+    return true;
+}
+
+bool FileSettingsIndexed::readValues(const Entry &e, QVariantMap &map)
+{
+    if (!file.seek(e.offset)) return false;
+
+    QByteArray data = file.read(e.size);
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    quint16 checksum;
+    stream >> checksum;
+
+    if ((data.size() != (int) e.size) || (checksum != qChecksum(data.constData(), data.size()))) {
+        qWarning("FileSettingsIndexed::readValues: damaged record");
+        return false;
+    }
+
+    QDataStream values(data);
+    values.setVersion(QDataStream::Qt_4_4);
+    values >> map;
+
+    return (values.status() == QDataStream::Ok);
+}
+
+bool FileSettingsIndexed::append(const QString &key, const QVariantMap &map, uint saved)
+{
+    if (!file.isOpen()) return false;
+
+    QByteArray data;
+
+    if (!map.isEmpty()) {
+        QDataStream values(&data, QIODevice::WriteOnly);
+        values.setVersion(QDataStream::Qt_4_4);
+        values << map;
+    }
+
+    file.seek(file.size());
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_4);
+    stream << key << (quint32) saved << (quint32) data.size();
+
+    Entry e;
+    e.offset = file.pos();
+    e.size = data.size();
+    e.saved = saved;
+
+    stream.writeRawData(data.constData(), data.size());
+    stream << qChecksum(data.constData(), data.size());
+
+    file.flush();
+
+    if (file.error() != QFile::NoError) {
+        qWarning("FileSettingsIndexed::append: error writing '%s'", file_name.toUtf8().constData());
+        file.unsetError();
+        return false;
+    }
+
+    QMap<QString, Entry>::iterator it = index.find(key);
+
+    if (it != index.end()) {
+        dead_bytes += it->size;
+        index.erase(it);
+    }
+
+    if (e.size > 0) index.insert(key, e);
+
+    return true;
+}
+
+static bool newerThan(const QPair<uint, QString> &e1, const QPair<uint, QString> &e2)
+{
+    return e1.first > e2.first;
+}
+
+bool FileSettingsIndexed::compact()
+{
+    if (!file.isOpen()) return false;
+
+    // Eviction: too old, or too many
+    uint oldest = QDateTime::currentDateTime().toTime_t() - max_age * 24 * 3600;
+
+    QList<QPair<uint, QString> > keep;
+    QMap<QString, Entry>::const_iterator it;
+
+    for (it = index.constBegin(); it != index.constEnd(); ++it) {
+        if (it.key() == KEY_IMPORT) continue;
+
+        if ((max_age <= 0) || (it->saved >= oldest)) keep.append(qMakePair(it->saved, it.key()));
+    }
+
+    if ((max_entries > 0) && (keep.count() > max_entries)) {
+        qSort(keep.begin(), keep.end(), newerThan);
+        keep = keep.mid(0, max_entries);
+    }
+
+    if (index.contains(KEY_IMPORT)) keep.append(qMakePair(index[KEY_IMPORT].saved, QString(KEY_IMPORT)));
+
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::compact: keeping %d of %d entries", keep.count(), index.count());
+
+    QFile f(file_name + ".new");
+
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("FileSettingsIndexed::compact: can't write '%s'", f.fileName().toUtf8().constData());
+        return false;
+    }
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_4_4);
+    stream << (quint32) STORE_MAGIC << (qint32) STORE_VERSION;
+
+    for (int n = 0; n < keep.count(); n++) {
+        const Entry &e = index[keep[n].second];
+
+        file.seek(e.offset);
+        QByteArray data = file.read(e.size);
+
+        if (data.size() != (int) e.size) continue;
+
+        stream << keep[n].second << (quint32) e.saved << (quint32) data.size();
+        stream.writeRawData(data.constData(), data.size());
+        stream << qChecksum(data.constData(), data.size());
+    }
+
+    bool ok = (f.error() == QFile::NoError);
+    f.close();
+
+    if (!ok) {
+        qWarning("FileSettingsIndexed::compact: error writing '%s'", f.fileName().toUtf8().constData());
+        f.remove();
+        return false;
+    }
+
+    file.close();
+
+    // The old file is kept until the new one is in place
+    QString old_name = file_name + ".old";
+    QFile::remove(old_name);
+
+    if (!QFile::rename(file_name, old_name)) {
+        qWarning("FileSettingsIndexed::compact: can't rename '%s'", file_name.toUtf8().constData());
+        f.remove();
+        return open();
+    }
+
+    if (!f.rename(file_name)) {
+        qWarning("FileSettingsIndexed::compact: can't rename '%s'", f.fileName().toUtf8().constData());
+        QFile::rename(old_name, file_name);
+        return open();
+    }
+
+    QFile::remove(old_name);
+
+    return open();
+}
+
+QString FileSettingsIndexed::keyFor(const QString &filename)
+{
+    QString hash = FileHash::hash(filename);
+
+    if (hash.isEmpty()) return KEY_FILENAME + filename;
+
+    return hash;
+}
+
+QString FileSettingsIndexed::findKey(const QString &filename)
+{
+    QString key = keyFor(filename);
+    // Imported from FileSettings
+    QString old_key = KEY_OLD_GROUP + FileSettings::filenameToGroupname(filename);
+
+    QMap<QString, Entry>::const_iterator it = index.constFind(key);
+    QMap<QString, Entry>::const_iterator old_it = index.constFind(old_key);
+
+    if (old_it == index.constEnd()) {
+        if (it == index.constEnd()) return QString::null;
+
+        return key;
+    }
+
+    // The newest one, the old group is updated if it's changed while
+    // FileSettings is used
+    if ((it == index.constEnd()) || (old_it->saved > it->saved)) return old_key;
+
+    return key;
+}
+
+bool FileSettingsIndexed::existSettingsFor(QString filename)
+{
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::existSettingsFor: '%s'", filename.toUtf8().constData());
+
+    return !findKey(filename).isEmpty();
+}
+
+void FileSettingsIndexed::loadSettingsFor(QString filename, MediaSettings &mset)
+{
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::loadSettingsFor: '%s'", filename.toUtf8().constData());
+
+    mset.reset();
+
+    QString key = findKey(filename);
+
+    if (key.isEmpty()) return;
+
+    QVariantMap map;
+
+    if (readValues(index[key], map)) mset.load(map);
+}
+
+void FileSettingsIndexed::saveSettingsFor(QString filename, MediaSettings &mset)
+{
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::saveSettingsFor: '%s'", filename.toUtf8().constData());
+
+    QVariantMap map;
+    mset.save(map);
+
+    uint now = QDateTime::currentDateTime().toTime_t();
+    QString key = keyFor(filename);
+
+    // The record imported from FileSettings is kept, it's compared with
+    // the group when importing again. From now on this one is newer.
+    if (!append(key, map, now)) return;
+
+    if (((dead_bytes > MIN_DEAD_BYTES) && (dead_bytes > file.size() - dead_bytes)) ||
+        ((max_entries > 0) && (index.count() > max_entries + max_entries / 10))) {
+        compact();
+    }
+}
+
+void FileSettingsIndexed::importOldSettings()
+{
+    // Only the files changed since the last import are read
+    uint last_import = index.contains(KEY_IMPORT) ? index[KEY_IMPORT].saved : 0;
+    uint now = QDateTime::currentDateTime().toTime_t();
+    bool changed = false;
+
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::importOldSettings: last import: %u", last_import);
+
+    // FileSettingsHash: file_settings/<x>/<hash>.ini
+    QString hash_dir = output_directory + "/file_settings";
+    int imported = 0;
+
+    QDirIterator it(hash_dir, QStringList() << "*.ini", QDir::Files, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        QString ini = it.next();
+
+        // Same second as the last import, it may have been changed after it
+        uint modified = it.fileInfo().lastModified().toTime_t();
+
+        if (modified < last_import) continue;
+
+        changed = true;
+
+        // Saved here after it was written
+        QString key = it.fileInfo().completeBaseName();
+
+        if ((index.contains(key)) && (index[key].saved >= modified)) continue;
+
+        QSettings set(ini, QSettings::IniFormat);
+        set.beginGroup("file_settings");
+
+        QVariantMap map;
+        QStringList keys = set.childKeys();
+
+        for (int n = 0; n < keys.count(); n++) map.insert(keys[n], set.value(keys[n]));
+
+        set.endGroup();
+
+        if ((!map.isEmpty()) && (append(key, map, modified))) imported++;
+    }
+
+    // FileSettings: smplayer2_files.ini, a group for each file. It has a
+    // single date, so the groups are compared with what was imported.
+    QString ini_file = output_directory + "/smplayer2_files.ini";
+    uint modified = QFileInfo(ini_file).lastModified().toTime_t();
+
+    if ((QFile::exists(ini_file)) && (modified >= last_import)) {
+        QSettings set(ini_file, QSettings::IniFormat);
+        changed = true;
+
+        QStringList groups = set.childGroups();
+
+        for (int n = 0; n < groups.count(); n++) {
+            set.beginGroup(groups[n]);
+
+            if (set.value("saved", false).toBool()) {
+                QVariantMap map;
+                QStringList keys = set.childKeys();
+
+                for (int k = 0; k < keys.count(); k++) {
+                    if (keys[k] != "saved") map.insert(keys[k], set.value(keys[k]));
+                }
+
+                QString key = KEY_OLD_GROUP + groups[n];
+                QVariantMap old_map;
+
+                if ((!index.contains(key)) ||
+                    (!readValues(index[key], old_map)) || (old_map != map)) {
+                    if (append(key, map, modified)) imported++;
+                }
+            }
+
+            set.endGroup();
+        }
+    }
+
+    if (changed) {
+        QVariantMap map;
+        map.insert("time", now);
+        append(KEY_IMPORT, map, now);
+    }
+
+    LOG_DEBUG(Log::Settings, "FileSettingsIndexed::importOldSettings: %d entries imported, %d in total",
+           imported, index.count());
+
+    // The old files are kept, they are still used if another method is
+    // chosen in the preferences
+}
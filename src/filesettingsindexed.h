@@ -0,0 +1,125 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _FILESETTINGS_INDEXED_H_
+#define _FILESETTINGS_INDEXED_H_
+
+#include "filesettingsbase.h"
+#include <QMap>
+#include <QFile>
+#include <QVariantMap>
+
+//! FileSettingsIndexed saves the settings of all files in a single indexed file.
+
+/*!
+ The file is a log of records: each save appends the settings of a file
+ (key, time and the values) and flushes it, so an update is never half
+ applied; a truncated record at the end is ignored. At startup only the
+ record headers are read to build the index, a QMap from key to the
+ position of its latest record, and the values are read when needed.
+
+ The key is the OpenSubtitles hash of the file, like in FileSettingsHash,
+ or the filename for things which can't be hashed (streams...).
+
+ When the file has too many old records it's compacted, writing only the
+ latest record of each key to a new file which replaces the old one. The
+ settings not saved for a long time, or the oldest ones if there are too
+ many, are dropped then.
+
+ The settings saved by FileSettings and FileSettingsHash are imported
+ the first time it's used. Their files are kept, in case one of those
+ methods is chosen again, and the ones changed since the last import
+ are imported again at startup.
+*/
+
+class FileSettingsIndexed : public FileSettingsBase
+{
+public:
+    FileSettingsIndexed(QString directory);
+    virtual ~FileSettingsIndexed();
+
+    virtual bool existSettingsFor(QString filename);
+
+    virtual void loadSettingsFor(QString filename, MediaSettings &mset);
+
+    virtual void saveSettingsFor(QString filename, MediaSettings &mset);
+
+    //! Rewrites the file with only the current records, dropping the
+    //! settings older than maxAge() or beyond maxEntries()
+    bool compact();
+
+    void setMaxEntries(int n) {
+        max_entries = n;
+    };
+    int maxEntries() {
+        return max_entries;
+    };
+
+    //! In days
+    void setMaxAge(int days) {
+        max_age = days;
+    };
+    int maxAge() {
+        return max_age;
+    };
+
+protected:
+    class Entry
+    {
+    public:
+        Entry() {
+            offset = 0;
+            size = 0;
+            saved = 0;
+        };
+
+        //! Position and size of the values in the file
+        qint64 offset;
+        quint32 size;
+        //! When it was saved (time_t)
+        uint saved;
+    };
+
+    bool open();
+    //! Reads the headers of all records
+    bool readIndex();
+    bool readValues(const Entry &e, QVariantMap &map);
+    //! Appends a record. An empty map removes the key.
+    bool append(const QString &key, const QVariantMap &map, uint saved);
+
+    //! Finds the entry for the file, by hash or with the key used by
+    //! FileSettings for the settings imported from it
+    QString findKey(const QString &filename);
+    QString keyFor(const QString &filename);
+
+    //! Imports the settings of FileSettings and FileSettingsHash newer
+    //! than the ones in the file
+    void importOldSettings();
+
+    QString file_name;
+    QFile file;
+    QMap<QString, Entry> index;
+    //! Bytes used by records which have been replaced
+    qint64 dead_bytes;
+
+    int max_entries;
+    int max_age;
+};
+
+#endif
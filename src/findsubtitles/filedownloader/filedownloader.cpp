@@ -19,6 +19,7 @@
 /* Based on the Qt network/http example */
 
 #include "filedownloader.h"
+#include "loglevels.h"
 #include <QHttp>
 #include <QTimer>
 
@@ -42,7 +43,7 @@ FileDownloader::FileDownloader(QWidget *parent) : QProgressDialog(parent)
 
 FileDownloader::~FileDownloader()
 {
-    //qDebug("FileDownloader::~FileDownloader");
+    //LOG_DEBUG(Log::Net, "FileDownloader::~FileDownloader");
     delete http;
 }
 
@@ -51,7 +52,7 @@ void FileDownloader::setProxy(QNetworkProxy proxy)
     http->abort();
     http->setProxy(proxy);
 
-    qDebug("FileDownloader::setProxy: host: '%s' port: %d type: %d",
+    LOG_DEBUG(Log::Net, "FileDownloader::setProxy: host: '%s' port: %d type: %d",
            proxy.hostName().toUtf8().constData(), proxy.port(), proxy.type());
 }
 
@@ -77,7 +78,7 @@ void FileDownloader::cancelDownload()
 
 void FileDownloader::httpRequestFinished(int request_id, bool error)
 {
-    qDebug("FileDownloader::httpRequestFinished: request_id %d, error %d", request_id, error);
+    LOG_DEBUG(Log::Net, "FileDownloader::httpRequestFinished: request_id %d, error %d", request_id, error);
 
     if (request_id != http_get_id) return;
 
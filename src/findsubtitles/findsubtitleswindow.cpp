@@ -21,6 +21,7 @@
 #include "simplehttp.h"
 #include "osparser.h"
 #include "languages.h"
+#include "filehash.h"
 #include <QStandardItemModel>
 #include <QSortFilterProxyModel>
 #include <QHeaderView>
@@ -247,7 +248,7 @@ void FindSubtitlesWindow::setMovie(QString filename)
     file_chooser->setText(filename);
     table->setRowCount(0);
 
-    QString hash = OSParser::calculateHash(filename);
+    QString hash = FileHash::hash(filename);
 
     if (hash.isEmpty()) {
         qWarning("FindSubtitlesWindow::setMovie: hash invalid. Doing nothing.");
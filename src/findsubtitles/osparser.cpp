@@ -17,9 +17,11 @@
 */
 
 #include "osparser.h"
+#include "loglevels.h"
 #include <QDomDocument>
 #include <QFile>
-#include <QDataStream>
+#include <QtEndian>
+#include <string.h>
 
 OSParser::OSParser()
 {
@@ -31,30 +33,30 @@ OSParser::~OSParser()
 
 bool OSParser::parseXml(QByteArray text)
 {
-    qDebug("OSParser::parseXml: source: '%s'", text.constData());
+    LOG_DEBUG(Log::Net, "OSParser::parseXml: source: '%s'", text.constData());
 
     s_list.clear();
 
     bool ok = dom_document.setContent(text);
-    qDebug("OSParser::parseXml: success: %d", ok);
+    LOG_DEBUG(Log::Net, "OSParser::parseXml: success: %d", ok);
 
     if (!ok) return false;
 
     QDomNode root = dom_document.documentElement();
-    //qDebug("tagname: '%s'", root.toElement().tagName().toLatin1().constData());
+    //LOG_DEBUG(Log::Net, "tagname: '%s'", root.toElement().tagName().toLatin1().constData());
 
     QString base_url = root.firstChildElement("base").text();
-    //qDebug("base_url: '%s'", base_url.toLatin1().constData());
+    //LOG_DEBUG(Log::Net, "base_url: '%s'", base_url.toLatin1().constData());
 
     QDomNode child = root.firstChildElement("results");
 
     if (!child.isNull()) {
-        //qDebug("items: %s", child.toElement().attribute("items").toLatin1().constData());
+        //LOG_DEBUG(Log::Net, "items: %s", child.toElement().attribute("items").toLatin1().constData());
         QDomNode subtitle = child.firstChildElement("subtitle");
 
         while (!subtitle.isNull()) {
-            //qDebug("tagname: '%s'", subtitle.tagName().toLatin1().constData());
-            qDebug("OSParser::parseXml: text: '%s'", subtitle.toElement().text().toLatin1().constData());
+            //LOG_DEBUG(Log::Net, "tagname: '%s'", subtitle.tagName().toLatin1().constData());
+            LOG_DEBUG(Log::Net, "OSParser::parseXml: text: '%s'", subtitle.toElement().text().toLatin1().constData());
 
             OSSubtitle sub;
 
@@ -80,38 +82,73 @@ bool OSParser::parseXml(QByteArray text)
     return true;
 }
 
+// Size of the blocks read from the beginning and the end of the file
+#define HASH_CHUNK_SIZE 65536
+
+//! Sum of the little endian 64-bit words of \a data. If \a size is not
+//! a multiple of 8 the bytes after the last full word are ignored.
+static quint64 sumWords(const char *data, int size)
+{
+    quint64 words[HASH_CHUNK_SIZE / 8];
+    int count = size / 8;
+
+    memcpy(words, data, count * 8);
+
+    quint64 sum = 0;
+
+    // Simple loop, the compiler can vectorize it
+    for (int n = 0; n < count; n++) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        sum += words[n];
+#else
+        sum += qFromLittleEndian(words[n]);
+#endif
+    }
+
+    return sum;
+}
+
 // From the patch by Kamil Dziobek turbos11(at)gmail.com
 // (c) Kamil Dziobek turbos11(at)gmail.com | BSD or GPL or public domain
+//
+// Files under 64 KiB are not in the OpenSubtitles database, and the
+// reference implementations don't agree on them. This one does what the
+// C and Java ones do: the tail block is read from max(0, size - 64 KiB),
+// so such a file is summed twice, and a partial word at the end is
+// ignored (the C# one pads it with zeros instead).
 QString OSParser::calculateHash(QString filename)
 {
     QFile file(filename);
 
-    if (!file.exists()) {
-        qWarning("OSParser:calculateHash: error hashing file. File doesn't exist.");
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("OSParser:calculateHash: error hashing file. Can't open it.");
         return QString();
     }
 
-    file.open(QIODevice::ReadOnly);
-    QDataStream in(&file);
-    in.setByteOrder(QDataStream::LittleEndian);
-    quint64 size = file.size();
+    qint64 size = file.size();
     quint64 hash = size;
-    quint64 a;
 
-    for (int i = 0; i < 8192; i++) {
-        in >> a ;
-        hash += a;
-    };
+    // Files smaller than a block are read once, and used for both
+    int chunk = (int) qMin((qint64) HASH_CHUNK_SIZE, size);
+
+    if (chunk > 0) {
+        QByteArray head = file.read(chunk);
+        QByteArray tail = head;
 
-    file.seek(size - 65536);
+        if (size > chunk) {
+            file.seek(size - chunk);
+            tail = file.read(chunk);
+        }
 
-    for (int i = 0; i < 8192; i++) {
-        in >> a ;
-        hash += a;
-    };
+        if ((head.size() != chunk) || (tail.size() != chunk)) {
+            qWarning("OSParser:calculateHash: error hashing file. Can't read it.");
+            return QString();
+        }
 
-    QString hexhash = QString("%1").arg(hash, 16, 16, QChar('0'));
+        hash += sumWords(head.constData(), chunk);
+        hash += sumWords(tail.constData(), chunk);
+    }
 
-    return hexhash;
+    return QString("%1").arg(hash, 16, 16, QChar('0'));
 }
 
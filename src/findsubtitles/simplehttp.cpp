@@ -17,6 +17,7 @@
 */
 
 #include "simplehttp.h"
+#include "loglevels.h"
 #include <QUrl>
 
 SimpleHttp::SimpleHttp(QObject *parent) : QHttp(parent)
@@ -36,7 +37,7 @@ SimpleHttp::~SimpleHttp()
 
 void SimpleHttp::download(const QString &url)
 {
-    qDebug("SimpleHttp::download: %s", url.toLatin1().constData());
+    LOG_DEBUG(Log::Net, "SimpleHttp::download: %s", url.toLatin1().constData());
 
     downloaded_text.clear();
 
@@ -44,8 +45,8 @@ void SimpleHttp::download(const QString &url)
     setHost(u.host());
 
     /*
-    qDebug("u.path: %s", u.path().toLatin1().constData());
-    qDebug("u.query: %s", u.encodedQuery().constData());
+    LOG_DEBUG(Log::Net, "u.path: %s", u.path().toLatin1().constData());
+    LOG_DEBUG(Log::Net, "u.query: %s", u.encodedQuery().constData());
     */
 
     QString p = u.path();
@@ -59,18 +60,18 @@ void SimpleHttp::download(const QString &url)
 
 void SimpleHttp::readResponseHeader(const QHttpResponseHeader &responseHeader)
 {
-    qDebug("SimpleHttp::readResponseHeader: statusCode: %d", responseHeader.statusCode());
+    LOG_DEBUG(Log::Net, "SimpleHttp::readResponseHeader: statusCode: %d", responseHeader.statusCode());
 
     if (responseHeader.statusCode() == 301)  {
         QString new_url = responseHeader.value("Location");
-        qDebug("SimpleHttp::readResponseHeader: Location: '%s'", new_url.toLatin1().constData());
+        LOG_DEBUG(Log::Net, "SimpleHttp::readResponseHeader: Location: '%s'", new_url.toLatin1().constData());
         download(new_url);
     } else if (responseHeader.statusCode() == 302)  {
         QString location = responseHeader.value("Location");
-        qDebug("SimpleHttp::readResponseHeader: Location: '%s'", location.toLatin1().constData());
+        LOG_DEBUG(Log::Net, "SimpleHttp::readResponseHeader: Location: '%s'", location.toLatin1().constData());
         http_get_id = get(location);
     } else if (responseHeader.statusCode() != 200) {
-        qDebug("SimpleHttp::readResponseHeader: error: '%s'", responseHeader.reasonPhrase().toLatin1().constData());
+        LOG_DEBUG(Log::Net, "SimpleHttp::readResponseHeader: error: '%s'", responseHeader.reasonPhrase().toLatin1().constData());
         emit downloadFailed(responseHeader.reasonPhrase());
         abort();
     }
@@ -78,7 +79,7 @@ void SimpleHttp::readResponseHeader(const QHttpResponseHeader &responseHeader)
 
 void SimpleHttp::httpRequestFinished(int request_id, bool error)
 {
-    qDebug("SimpleHttp::httpRequestFinished: http_get_id: %d request_id: %d, error: %d", http_get_id, request_id, error);
+    LOG_DEBUG(Log::Net, "SimpleHttp::httpRequestFinished: http_get_id: %d request_id: %d, error: %d", http_get_id, request_id, error);
 
     if (request_id != http_get_id) return;
 
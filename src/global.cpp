@@ -26,12 +26,19 @@
 #include <QSettings>
 #include "translator.h"
 #include "paths.h"
+#include "mediainfocache.h"
+#include "logbuffer.h"
+#include "loglevels.h"
 #include <QApplication>
 #include <QFile>
 
 QSettings *Global::settings = 0;
 Preferences *Global::pref = 0;
 Translator *Global::translator = 0;
+MediaInfoCache *Global::media_info_cache = 0;
+
+static LogBuffer smplayer2_log_buffer(10000, true);
+LogBuffer *Global::smplayer2_log = &smplayer2_log_buffer;
 
 using namespace Global;
 
@@ -59,6 +66,14 @@ void Global::global_init(const QString &config_path)
 
     // Preferences
     pref = new Preferences();
+
+    smplayer2_log->setCapacity(pref->log_max_lines);
+    // Nothing to format if the log is disabled
+    Log::setLevels(pref->log_smplayer2 ? pref->log_levels : QString("all=quiet"));
+
+    // Media info cache
+    media_info_cache = new MediaInfoCache(Paths::configPath() + "/smplayer2_mediainfo.dat",
+                                          pref->media_info_cache_size);
 }
 
 void Global::global_end()
@@ -66,6 +81,9 @@ void Global::global_end()
     qDebug("global_end");
 
     // delete
+    delete media_info_cache;
+    media_info_cache = 0;
+
     delete pref;
     pref = 0;
 
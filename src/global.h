@@ -29,6 +29,8 @@
 class QSettings;
 class Preferences;
 class Translator;
+class MediaInfoCache;
+class LogBuffer;
 
 namespace Global
 {
@@ -42,6 +44,13 @@ extern Preferences *pref;
 //! Translator (for changing language)
 extern Translator *translator;
 
+//! Info about the files already identified by mplayer
+extern MediaInfoCache *media_info_cache;
+
+//! Log of smplayer2 itself. It exists before global_init(), so lines
+//! written at startup are kept too.
+extern LogBuffer *smplayer2_log;
+
 
 void global_init(const QString &config_path);
 void global_end();
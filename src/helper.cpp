@@ -243,3 +243,62 @@ QStringList Helper::searchForConsecutiveFiles(const QString &initial_file)
 
     return files_to_add;
 }
+
+int Helper::naturalCompare(const QString &s1, const QString &s2)
+{
+    int l1 = s1.length();
+    int l2 = s2.length();
+    int i1 = 0;
+    int i2 = 0;
+
+    while ((i1 < l1) && (i2 < l2)) {
+        if (s1[i1].isDigit() && s2[i2].isDigit()) {
+            // Skip leading zeros, then the longest number is the biggest
+            int start1 = i1;
+            int start2 = i2;
+
+            while ((i1 < l1) && (s1[i1] == '0')) i1++;
+
+            while ((i2 < l2) && (s2[i2] == '0')) i2++;
+
+            int digits1 = i1;
+            int digits2 = i2;
+
+            while ((i1 < l1) && (s1[i1].isDigit())) i1++;
+
+            while ((i2 < l2) && (s2[i2].isDigit())) i2++;
+
+            int len1 = i1 - digits1;
+            int len2 = i2 - digits2;
+
+            if (len1 != len2) return (len1 < len2) ? -1 : 1;
+
+            for (int n = 0; n < len1; n++) {
+                QChar c1 = s1[digits1 + n];
+                QChar c2 = s2[digits2 + n];
+
+                if (c1 != c2) return (c1 < c2) ? -1 : 1;
+            }
+
+            // Same value, "01" goes after "1"
+            int zeros1 = digits1 - start1;
+            int zeros2 = digits2 - start2;
+
+            if (zeros1 != zeros2) return (zeros1 < zeros2) ? -1 : 1;
+        } else {
+            QChar c1 = s1[i1].toLower();
+            QChar c2 = s2[i2].toLower();
+
+            if (c1 != c2) return (c1 < c2) ? -1 : 1;
+
+            i1++;
+            i2++;
+        }
+    }
+
+    if (i1 < l1) return 1;
+
+    if (i2 < l2) return -1;
+
+    return 0;
+}
@@ -64,6 +64,10 @@ public:
     static QString equalizerListToString(AudioEqualizerList values);
 
     static QStringList searchForConsecutiveFiles(const QString &initial_file);
+
+    //! Compares two strings like QString::compare, case insensitive, but
+    //! numbers are compared by value, so "file 9" goes before "file 10".
+    static int naturalCompare(const QString &s1, const QString &s2);
 };
 
 #endif
@@ -22,11 +22,49 @@
 #include "global.h"
 #include "preferences.h"
 #include "paths.h"
+#include "loglevels.h"
 
-#include <QFile>
+#include <QDir>
+#include <QStringList>
+#include <QPixmapCache>
 
 using namespace Global;
 
+QString Images::indexed_iconset;
+bool Images::indexed = false;
+QHash<QString, QString> Images::theme_files;
+
+void Images::indexIconset()
+{
+    if ((indexed) && (indexed_iconset == pref->iconset)) return;
+
+    theme_files.clear();
+    indexed_iconset = pref->iconset;
+    indexed = true;
+
+    if (indexed_iconset.isEmpty()) return;
+
+    QStringList dirs;
+    dirs << Paths::configPath() + "/themes/" + indexed_iconset
+         << Paths::themesPath() + "/" + indexed_iconset;
+
+    foreach(QString dir, dirs) {
+        QStringList files = QDir(dir).entryList(QDir::Files);
+
+        foreach(QString f, files) {
+            if (!theme_files.contains(f)) theme_files.insert(f, dir + "/" + f);
+        }
+    }
+
+    qDebug("Images::indexIconset: '%s': %d files", indexed_iconset.toUtf8().constData(), theme_files.count());
+}
+
+QString Images::themeFile(const QString &icon_name)
+{
+    indexIconset();
+    return theme_files.value(icon_name);
+}
+
 QString Images::filename(const QString &name, bool png)
 {
     QString filename = name;
@@ -42,24 +80,13 @@ QString Images::filename(const QString &name, bool png)
 
 QString Images::file(const QString &icon_name)
 {
-    bool ok = false;
-    QString filename;
-
-    if (!pref->iconset.isEmpty()) {
-        filename = Paths::configPath() + "/themes/" + pref->iconset + "/" +  icon_name;
+    QString filename = themeFile(icon_name);
 
-        if (!QFile::exists(filename)) {
-            filename = Paths::themesPath() + "/" + pref->iconset + "/" +  icon_name;
-        }
-
-        ok = (QFile::exists(filename));
-    }
-
-    if (!ok) {
+    if (filename.isEmpty()) {
         filename = ":/icons-png/" + icon_name;
     }
 
-    qDebug("Images::file: icon_name: '%s', filename: '%s'", icon_name.toUtf8().constData(), filename.toUtf8().constData());
+    LOG_VERBOSE(Log::Gui, "Images::file: icon_name: '%s', filename: '%s'", icon_name.toUtf8().constData(), filename.toUtf8().constData());
 
     return filename;
 }
@@ -67,25 +94,32 @@ QString Images::file(const QString &icon_name)
 QPixmap Images::loadIcon(const QString &icon_name)
 {
     QPixmap p;
+    QString filename = themeFile(icon_name);
 
-    if (!pref->iconset.isEmpty()) {
-        QString filename = Paths::configPath() + "/themes/" + pref->iconset + "/" +  icon_name;
+    if (!filename.isEmpty()) {
+        p.load(filename);
+    }
 
-        if (!QFile::exists(filename)) {
-            filename = Paths::themesPath() + "/" + pref->iconset + "/" +  icon_name;
-        }
+    return p;
+}
 
-        //qDebug("Images::loadIcon: filename: '%s'", filename.toUtf8().data());
+QPixmap Images::icon(QString name, int size, bool png)
+{
+    indexIconset();
 
-        if (QFile::exists(filename)) {
-            p.load(filename);
-        }
+    QString key = QString("smplayer2:%1:%2:%3:%4").arg(indexed_iconset).arg(name).arg(size).arg(png);
+
+    QPixmap p;
+
+    if (!QPixmapCache::find(key, &p)) {
+        p = createIcon(name, size, png);
+        QPixmapCache::insert(key, p);
     }
 
     return p;
 }
 
-QPixmap Images::icon(QString name, int size, bool png)
+QPixmap Images::createIcon(const QString &name, int size, bool png)
 {
     bool small = false;
 
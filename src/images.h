@@ -21,8 +21,14 @@
 
 #include <QPixmap>
 #include <QString>
+#include <QHash>
 
 /* Warning: don't use this until global->preferences is created! */
+
+//! The icons are kept in QPixmapCache, with the iconset, name and size
+//! in the key, so they're only decoded once. The files of the iconset
+//! are listed when it's first used, instead of checking if each icon
+//! exists, and listed again only if pref->iconset changes.
 class Images
 {
 
@@ -43,6 +49,20 @@ private:
     //! Try to load an icon. \a icon_name is the filename of the
     //! icon without path. Return a null pixmap if loads fails.
     static QPixmap loadIcon(const QString &icon_name);
+
+    static QPixmap createIcon(const QString &name, int size, bool png);
+
+    //! Full path of \a icon_name in the iconset, or an empty string
+    static QString themeFile(const QString &icon_name);
+
+    //! Lists the files of the iconset if it has changed
+    static void indexIconset();
+
+    //! Iconset of theme_files
+    static QString indexed_iconset;
+    static bool indexed;
+    //! Icon filename to full path, the config directory has priority
+    static QHash<QString, QString> theme_files;
 };
 
 #endif
@@ -20,29 +20,41 @@
 #include "global.h"
 #include "preferences.h"
 #include "mplayerprocess.h"
+#include "mediainfocache.h"
 #include <QFileInfo>
 
-MediaData InfoProvider::getInfo(QString mplayer_bin, QString filename)
+void InfoProvider::addArguments(MplayerProcess *proc, QString mplayer_bin, QString filename)
 {
-    qDebug("InfoProvider::getInfo: %s", filename.toUtf8().data());
-
-    MplayerProcess proc;
-
     QFileInfo fi(mplayer_bin);
 
     if (fi.exists() && fi.isExecutable() && !fi.isDir()) {
         mplayer_bin = fi.absoluteFilePath();
     }
 
-    proc.addArgument(mplayer_bin);
-    proc.addArgument("-identify");
-    proc.addArgument("-frames");
-    proc.addArgument("0");
-    proc.addArgument("-vo");
-    proc.addArgument("null");
-    proc.addArgument("-ao");
-    proc.addArgument("null");
-    proc.addArgument(filename);
+    proc->addArgument(mplayer_bin);
+    proc->addArgument("-identify");
+    proc->addArgument("-frames");
+    proc->addArgument("0");
+    proc->addArgument("-vo");
+    proc->addArgument("null");
+    proc->addArgument("-ao");
+    proc->addArgument("null");
+    proc->addArgument(filename);
+}
+
+MediaData InfoProvider::getInfo(QString mplayer_bin, QString filename)
+{
+    qDebug("InfoProvider::getInfo: %s", filename.toUtf8().data());
+
+    MediaData data;
+
+    if (Global::media_info_cache && Global::media_info_cache->find(filename, data)) {
+        qDebug("InfoProvider::getInfo: found in cache");
+        return data;
+    }
+
+    MplayerProcess proc;
+    addArguments(&proc, mplayer_bin, filename);
 
     proc.start();
 
@@ -51,7 +63,11 @@ MediaData InfoProvider::getInfo(QString mplayer_bin, QString filename)
         proc.kill();
     }
 
-    return proc.mediaData();
+    data = proc.mediaData();
+
+    if (Global::media_info_cache) Global::media_info_cache->insert(filename, data);
+
+    return data;
 }
 
 MediaData InfoProvider::getInfo(QString filename)
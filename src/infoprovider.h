@@ -24,10 +24,15 @@
 #include <QString>
 #include "mediadata.h"
 
+class MplayerProcess;
+
 class InfoProvider
 {
 
 public:
+    //! Adds to \a proc the arguments to get info about the specified filename.
+    static void addArguments(MplayerProcess *proc, QString mplayer_bin, QString filename);
+
     //! Gets info about the specified filename.
     static MediaData getInfo(QString mplayer_bin, QString filename);
 
@@ -20,10 +20,15 @@
 #include <QStringList>
 #include <QApplication>
 #include <QRegExp>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QSettings>
 
 #include "colorutils.h"
 #include "global.h"
 #include "preferences.h"
+#include "paths.h"
 
 #if USE_QPROCESS
 #include <QProcess>
@@ -39,27 +44,50 @@ using namespace Global;
 #define DEMUXER 3
 #define VC 4
 #define AC 5
+#define CMD 6
+
+#define INFO_OPTIONS "-identify -vo help -ao help -demuxer help -vc help -ac help"
+#define CMDLIST_OPTIONS "-input cmdlist"
+
+// Increase it if the info saved in the cache changes
+#define CACHE_VERSION 1
 
 InfoReader *InfoReader::static_obj = 0;
 
 InfoReader *InfoReader::obj()
+{
+    preload();
+    static_obj->waitForInfo();
+
+    return static_obj;
+}
+
+void InfoReader::preload()
 {
     if (!static_obj) {
         static_obj = new InfoReader(pref->mplayer_bin);
-        static_obj->getInfo();
-    }
 
-    return static_obj;
+        if (!static_obj->loadCache()) static_obj->refresh();
+    }
 }
 
 InfoReader::InfoReader(QString mplayer_bin, QObject *parent)
     : QObject(parent)
 {
     mplayerbin = mplayer_bin;
+    mplayer_svn = 0;
+    has_info = false;
+    refresh_step = 0;
 
 #if USE_QPROCESS
     proc = new QProcess(this);
     proc->setProcessChannelMode(QProcess::MergedChannels);
+
+    // Only used by refresh(), the rest of runs are synchronous
+    connect(proc, SIGNAL(finished(int, QProcess::ExitStatus)),
+            this, SLOT(refreshStepFinished()));
+    connect(proc, SIGNAL(error(QProcess::ProcessError)),
+            this, SLOT(refreshFailed()));
 #else
     proc = new MyProcess(this);
 
@@ -72,18 +100,264 @@ InfoReader::~InfoReader()
 {
 }
 
-void InfoReader::getInfo()
+void InfoReader::clearInfo()
 {
     waiting_for_key = TRUE;
     vo_list.clear();
     ao_list.clear();
     demuxer_list.clear();
+    vc_list.clear();
+    ac_list.clear();
+}
+
+void InfoReader::clearCommands()
+{
+    cmd_list.clear();
+
+    // The list of slave commands has no key line
+    reading_type = CMD;
+    waiting_for_key = FALSE;
+}
 
-    run("-identify -vo help -ao help -demuxer help -vc help -ac help");
+void InfoReader::getInfo()
+{
+#if USE_QPROCESS
+
+    if (refresh_step != 0) {
+        // Cancel the refresh, it would be done twice
+        refresh_step = 0;
+        proc->kill();
+        proc->waitForFinished();
+    }
+
+#endif
+
+    QString key = cacheKey();
+
+    clearInfo();
+    run(INFO_OPTIONS);
+
+    clearCommands();
+    run(CMDLIST_OPTIONS);
+
+    has_info = true;
+    refresh_key = key;
+    saveCache();
 
     //list();
 }
 
+void InfoReader::setMplayerBin(const QString &mplayer_bin)
+{
+    qDebug("InfoReader::setMplayerBin: '%s'", mplayer_bin.toUtf8().data());
+
+    if (mplayer_bin == mplayerbin) return;
+
+    mplayerbin = mplayer_bin;
+
+    if (!loadCache()) refresh();
+}
+
+void InfoReader::waitForInfo()
+{
+    if (has_info) return;
+
+#if USE_QPROCESS
+    qDebug("InfoReader::waitForInfo: waiting for mplayer");
+
+    // The finished signal is emitted from waitForFinished(), so each
+    // step of the refresh is read and the next one is started
+    while (refresh_step != 0) {
+        if (!proc->waitForFinished()) {
+            qWarning("InfoReader::waitForInfo: process didn't finish");
+            refresh_step = 0;
+            proc->kill();
+        }
+    }
+
+#endif
+
+    if (!has_info) getInfo();
+}
+
+#if USE_QPROCESS
+void InfoReader::refresh()
+{
+    qDebug("InfoReader::refresh");
+
+    if (refresh_step != 0) {
+        // Running with another binary, start again
+        refresh_step = 0;
+        proc->kill();
+        proc->waitForFinished();
+    }
+
+    refresh_key = cacheKey();
+    refresh_step = 1;
+    startRefreshStep(INFO_OPTIONS);
+}
+
+void InfoReader::startRefreshStep(QString options)
+{
+    qDebug("InfoReader::startRefreshStep: '%s'", options.toUtf8().data());
+    proc->start(mplayerbin, options.split(" "));
+}
+
+void InfoReader::refreshStepFinished()
+{
+    qDebug("InfoReader::refreshStepFinished: step %d", refresh_step);
+
+    if (refresh_step == 1) {
+        clearInfo();
+        readOutput();
+
+        refresh_step = 2;
+        startRefreshStep(CMDLIST_OPTIONS);
+    } else if (refresh_step == 2) {
+        clearCommands();
+        readOutput();
+
+        refresh_step = 0;
+        has_info = true;
+        saveCache();
+    }
+}
+
+void InfoReader::refreshFailed()
+{
+    if ((refresh_step != 0) && (proc->error() == QProcess::FailedToStart)) {
+        qWarning("InfoReader::refreshFailed: process can't start!");
+        refresh_step = 0;
+        // Nothing to wait for, keep the lists as they are
+        has_info = true;
+    }
+}
+#else
+void InfoReader::refresh()
+{
+    // MyProcess can't run in the background
+    getInfo();
+}
+#endif
+
+// Returns the file of the binary, looking for it in the PATH if needed
+static QFileInfo binaryFileInfo(const QString &bin)
+{
+    QFileInfo fi(bin);
+
+    if (fi.exists() || bin.contains("/") || bin.contains("\\")) return fi;
+
+#ifdef Q_OS_WIN
+    QStringList path = QString::fromLocal8Bit(qgetenv("PATH")).split(";", QString::SkipEmptyParts);
+#else
+    QStringList path = QString::fromLocal8Bit(qgetenv("PATH")).split(":", QString::SkipEmptyParts);
+#endif
+
+    for (int n = 0; n < path.count(); n++) {
+        QFileInfo f(QDir(path[n]), bin);
+
+        if (f.exists()) return f;
+
+#ifdef Q_OS_WIN
+        f = QFileInfo(QDir(path[n]), bin + ".exe");
+
+        if (f.exists()) return f;
+
+#endif
+    }
+
+    return fi;
+}
+
+QString InfoReader::cacheKey()
+{
+    QFileInfo fi = binaryFileInfo(mplayerbin);
+
+    if (!fi.exists()) return QString::null;
+
+    return QString("%1|%2|%3").arg(fi.absoluteFilePath())
+           .arg(fi.size())
+           .arg(fi.lastModified().toTime_t());
+}
+
+static void saveList(QSettings *set, const QString &name, InfoList list)
+{
+    set->beginWriteArray(name, list.count());
+
+    for (int n = 0; n < list.count(); n++) {
+        set->setArrayIndex(n);
+        set->setValue("name", list[n].name());
+        set->setValue("desc", list[n].desc());
+    }
+
+    set->endArray();
+}
+
+static InfoList loadList(QSettings *set, const QString &name)
+{
+    InfoList list;
+
+    int count = set->beginReadArray(name);
+
+    for (int n = 0; n < count; n++) {
+        set->setArrayIndex(n);
+        list.append(InfoData(set->value("name").toString(), set->value("desc").toString()));
+    }
+
+    set->endArray();
+
+    return list;
+}
+
+void InfoReader::saveCache()
+{
+    // Don't save the info of a binary which doesn't exist
+    if (refresh_key.isEmpty()) return;
+
+    qDebug("InfoReader::saveCache: key: '%s'", refresh_key.toUtf8().data());
+
+    QSettings set(Paths::configPath() + "/smplayer2_info.ini", QSettings::IniFormat);
+    set.clear();
+
+    set.setValue("cache_version", CACHE_VERSION);
+    set.setValue("key", refresh_key);
+    set.setValue("mplayer_version", mplayer_svn);
+
+    saveList(&set, "vo", vo_list);
+    saveList(&set, "ao", ao_list);
+    saveList(&set, "demuxer", demuxer_list);
+    saveList(&set, "vc", vc_list);
+    saveList(&set, "ac", ac_list);
+    set.setValue("commands", cmd_list);
+}
+
+bool InfoReader::loadCache()
+{
+    QSettings set(Paths::configPath() + "/smplayer2_info.ini", QSettings::IniFormat);
+
+    if (set.value("cache_version", 0).toInt() != CACHE_VERSION) {
+        qDebug("InfoReader::loadCache: no cache");
+        return false;
+    }
+
+    // The info of another binary is better than nothing while refreshing
+    mplayer_svn = set.value("mplayer_version", 0).toInt();
+    vo_list = loadList(&set, "vo");
+    ao_list = loadList(&set, "ao");
+    demuxer_list = loadList(&set, "demuxer");
+    vc_list = loadList(&set, "vc");
+    ac_list = loadList(&set, "ac");
+    cmd_list = set.value("commands").toStringList();
+    has_info = true;
+
+    QString key = cacheKey();
+    bool up_to_date = ((!key.isEmpty()) && (set.value("key").toString() == key));
+
+    qDebug("InfoReader::loadCache: up to date: %d", up_to_date);
+
+    return up_to_date;
+}
+
 void InfoReader::list()
 {
     qDebug("InfoReader::list");
@@ -131,6 +405,7 @@ static QRegExp rx_vc_key("^ID_VIDEO_CODECS");
 static QRegExp rx_driver("\\t(.*)\\t(.*)");
 static QRegExp rx_demuxer("^\\s+([A-Z,a-z,0-9]+)\\s+(\\S.*)");
 static QRegExp rx_codec("^([A-Z,a-z,0-9]+)\\s+([A-Z,a-z,0-9]+)\\s+([A-Z,a-z,0-9]+)\\s+(\\S.*)");
+static QRegExp rx_command("^([a-z_0-9]+)(\\s|$)");
 
 void InfoReader::readLine(QByteArray ba)
 {
@@ -146,6 +421,14 @@ void InfoReader::readLine(QByteArray ba)
     qDebug("InfoReader::readLine: line: '%s'", line.toUtf8().data());
     //qDebug("waiting_for_key: %d", waiting_for_key);
 
+    if ((!waiting_for_key) && (reading_type == CMD)) {
+        if (rx_command.indexIn(line) > -1) {
+            cmd_list.append(rx_command.cap(1));
+        }
+
+        return;
+    }
+
     if (!waiting_for_key) {
         if (rx_driver.indexIn(line) > -1) {
             QString name = rx_driver.cap(1);
@@ -236,6 +519,13 @@ bool InfoReader::run(QString options)
 
     qDebug("InfoReader::run : terminating");
 
+    readOutput();
+
+    return true;
+}
+
+void InfoReader::readOutput()
+{
     QByteArray ba;
 
     while (proc->canReadLine()) {
@@ -244,8 +534,6 @@ bool InfoReader::run(QString options)
         ba.replace("\r", "");
         readLine(ba);
     }
-
-    return true;
 }
 #else
 bool InfoReader::run(QString options)
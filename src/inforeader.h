@@ -22,6 +22,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QStringList>
 
 #define USE_QPROCESS 1
 
@@ -72,8 +73,23 @@ public:
     InfoReader(QString mplayer_bin, QObject *parent = 0);
     ~InfoReader();
 
+    //! Runs mplayer and waits until it finishes to get the info
     void getInfo();
 
+    //! Gets the info from mplayer in the background. The lists keep their
+    //! current values until it finishes, then the cache is updated.
+    void refresh();
+
+    //! Loads the info saved by a previous run. Returns false if there's
+    //! no cache or it was made with a different binary (path, size or
+    //! modification time), in which case it should be refreshed.
+    bool loadCache();
+    void saveCache();
+
+    //! Changes the mplayer binary. The info is taken from the cache if
+    //! it's up to date, otherwise it's refreshed in the background.
+    void setMplayerBin(const QString &mplayer_bin);
+
     InfoList voList() {
         return vo_list;
     };
@@ -90,20 +106,43 @@ public:
         return ac_list;
     };
 
+    //! Slave commands known by mplayer (from -input cmdlist)
+    QStringList commandList() {
+        return cmd_list;
+    };
+
     int mplayerVersion() {
         return mplayer_svn;
     };
 
     //! Returns an InfoReader objects. If it didn't exist before, one
-    //! is created and getInfo() is called.
+    //! is created with preload(). If there's no info yet it waits for it.
     static InfoReader *obj();
 
+    //! Creates the InfoReader object and loads the cache, starting a
+    //! refresh if needed. Doesn't wait for mplayer.
+    static void preload();
+
 protected slots:
     virtual void readLine(QByteArray);
+#if USE_QPROCESS
+    void refreshStepFinished();
+    void refreshFailed();
+#endif
 
 protected:
     bool run(QString options);
     void list();
+    void waitForInfo();
+    //! Key of the cache: path, size and modification time of the binary
+    QString cacheKey();
+
+#if USE_QPROCESS
+    void startRefreshStep(QString options);
+    void readOutput();
+#endif
+    void clearInfo();
+    void clearCommands();
 
 protected:
 #if USE_QPROCESS
@@ -118,6 +157,7 @@ protected:
     InfoList demuxer_list;
     InfoList vc_list;
     InfoList ac_list;
+    QStringList cmd_list;
 
     int mplayer_svn;
 
@@ -125,6 +165,12 @@ private:
     bool waiting_for_key;
     int reading_type;
 
+    //! True once the lists have been filled, from mplayer or the cache
+    bool has_info;
+    //! 0 if no refresh is running, otherwise the mplayer run in progress
+    int refresh_step;
+    QString refresh_key;
+
     static InfoReader *static_obj;
 };
 
@@ -0,0 +1,133 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "infoscanner.h"
+#include "infoprovider.h"
+#include "mplayerprocess.h"
+#include "global.h"
+#include "preferences.h"
+#include "mediainfocache.h"
+#include "filechecker.h"
+#include <QThread>
+
+using namespace Global;
+
+InfoScanner::InfoScanner(QObject *parent)
+    : QObject(parent)
+{
+    max_processes = QThread::idealThreadCount();
+
+    if (max_processes < 1) max_processes = 1;
+
+    file_checker = new FileChecker(this);
+    connect(file_checker, SIGNAL(filesMissing(QStringList)),
+            this, SIGNAL(filesMissing(QStringList)));
+}
+
+InfoScanner::~InfoScanner()
+{
+    cancel();
+}
+
+void InfoScanner::setMaxProcesses(int n)
+{
+    if (n < 1) n = 1;
+
+    max_processes = n;
+    startNext();
+}
+
+void InfoScanner::scan(const QStringList &files)
+{
+    qDebug("InfoScanner::scan: %d files", files.count());
+
+    queue += files;
+    startNext();
+}
+
+void InfoScanner::checkExistence(const QStringList &files)
+{
+    file_checker->check(files);
+}
+
+void InfoScanner::cancel()
+{
+    qDebug("InfoScanner::cancel: %d files in the queue, %d running", queue.count(), running.count());
+
+    queue.clear();
+    file_checker->cancel();
+
+    QHash<MplayerProcess *, QString>::iterator it;
+
+    for (it = running.begin(); it != running.end(); ++it) {
+        MplayerProcess *proc = it.key();
+        disconnect(proc, 0, this, 0);
+        proc->kill();
+        proc->deleteLater();
+    }
+
+    running.clear();
+}
+
+void InfoScanner::startNext()
+{
+    bool failed = false;
+
+    while ((running.count() < max_processes) && (!queue.isEmpty())) {
+        QString filename = queue.takeFirst();
+
+        MplayerProcess *proc = new MplayerProcess(this);
+        InfoProvider::addArguments(proc, pref->mplayer_bin, filename);
+
+        connect(proc, SIGNAL(processExited()), this, SLOT(processExited()));
+
+        running.insert(proc, filename);
+
+        if (!proc->start()) {
+            qWarning("InfoScanner::startNext: process can't start for '%s'", filename.toUtf8().data());
+            running.remove(proc);
+            proc->deleteLater();
+            failed = true;
+        }
+    }
+
+    // No processExited() will come for the ones which couldn't start
+    if ((failed) && (!isScanning())) emit finished();
+}
+
+void InfoScanner::processExited()
+{
+    MplayerProcess *proc = qobject_cast<MplayerProcess *>(sender());
+
+    if ((!proc) || (!running.contains(proc))) return;
+
+    QString filename = running.take(proc);
+    MediaData data = proc->mediaData();
+    proc->deleteLater();
+
+    if (media_info_cache) media_info_cache->insert(filename, data);
+
+    // Otherwise startNext() sends finished() if none of the rest can start
+    bool last = !isScanning();
+
+    startNext();
+
+    emit infoAvailable(filename, data);
+
+    if (last) emit finished();
+}
@@ -0,0 +1,93 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _INFOSCANNER_H_
+#define _INFOSCANNER_H_
+
+#include <QObject>
+#include <QStringList>
+#include <QHash>
+#include "mediadata.h"
+
+class MplayerProcess;
+class FileChecker;
+
+//! InfoScanner gets info about many files in the background.
+
+/*!
+ The files are queued and identified by several mplayer processes
+ running at the same time, as many as cores by default. Each result is
+ sent with infoAvailable() as soon as its process finishes, so the GUI
+ never waits for mplayer.
+
+ It can also check in a thread that many files exist, without running
+ mplayer, with checkExistence().
+*/
+
+class InfoScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    InfoScanner(QObject *parent = 0);
+    ~InfoScanner();
+
+    //! Adds the files to the queue
+    void scan(const QStringList &files);
+
+    //! Checks in the background that the files exist. The ones which
+    //! don't are sent with filesMissing().
+    void checkExistence(const QStringList &files);
+
+    //! Forgets the files in the queue and stops the running processes.
+    //! No more results will be sent.
+    void cancel();
+
+    bool isScanning() {
+        return (!queue.isEmpty()) || (!running.isEmpty());
+    };
+
+    //! Maximum number of mplayer processes running at the same time
+    void setMaxProcesses(int n);
+    int maxProcesses() {
+        return max_processes;
+    };
+
+signals:
+    void infoAvailable(QString filename, MediaData data);
+
+    //! Some of the files passed to checkExistence() don't exist
+    void filesMissing(QStringList files);
+
+    //! All files in the queue have been scanned
+    void finished();
+
+protected slots:
+    void processExited();
+
+protected:
+    void startNext();
+
+    QStringList queue;
+    QHash<MplayerProcess *, QString> running;
+    int max_processes;
+
+    FileChecker *file_checker;
+};
+
+#endif
@@ -0,0 +1,193 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "logbuffer.h"
+#include <QMutexLocker>
+
+LogBuffer::LogBuffer(int capacity, bool timestamps)
+{
+    max_lines = qMax(capacity, 1);
+    head = 0;
+    first_line = 0;
+    end_line = 0;
+    clear_count = 0;
+    show_time = timestamps;
+}
+
+LogBuffer::~LogBuffer()
+{
+}
+
+void LogBuffer::setCapacity(int capacity)
+{
+    QMutexLocker locker(&mutex);
+
+    capacity = qMax(capacity, 1);
+
+    if (capacity == max_lines) return;
+
+    // Keep the newest lines, in order, starting at the beginning of the ring
+    int keep = qMin(ring.count(), capacity);
+    QVector<Entry> r;
+    r.reserve(keep);
+
+    for (qint64 n = end_line - keep; n < end_line; n++) {
+        r.append(ring[index(n)]);
+    }
+
+    ring = r;
+    head = 0;
+    first_line = end_line - keep;
+    max_lines = capacity;
+}
+
+int LogBuffer::capacity() const
+{
+    QMutexLocker locker(&mutex);
+    return max_lines;
+}
+
+void LogBuffer::setTimestamps(bool b)
+{
+    QMutexLocker locker(&mutex);
+    show_time = b;
+}
+
+bool LogBuffer::timestamps() const
+{
+    QMutexLocker locker(&mutex);
+    return show_time;
+}
+
+void LogBuffer::append(const QString &text, Severity severity)
+{
+    Entry e;
+    e.text = text;
+    e.time = QTime::currentTime();
+    e.severity = severity;
+
+    // Don't use qDebug here, the smplayer2 log is written from the message handler
+    QMutexLocker locker(&mutex);
+
+    if (ring.count() < max_lines) {
+        ring.append(e);
+    } else {
+        ring[head] = e;
+        head = (head + 1) % max_lines;
+        first_line++;
+    }
+
+    end_line++;
+}
+
+void LogBuffer::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    ring.clear();
+    head = 0;
+    first_line = 0;
+    end_line = 0;
+    clear_count++;
+}
+
+int LogBuffer::count() const
+{
+    QMutexLocker locker(&mutex);
+    return ring.count();
+}
+
+qint64 LogBuffer::firstLine() const
+{
+    QMutexLocker locker(&mutex);
+    return first_line;
+}
+
+qint64 LogBuffer::endLine() const
+{
+    QMutexLocker locker(&mutex);
+    return end_line;
+}
+
+void LogBuffer::state(qint64 *first, qint64 *end, int *clears) const
+{
+    QMutexLocker locker(&mutex);
+
+    *first = first_line;
+    *end = end_line;
+    *clears = clear_count;
+}
+
+QString LogBuffer::line(qint64 n) const
+{
+    QMutexLocker locker(&mutex);
+
+    if ((n < first_line) || (n >= end_line)) return QString();
+
+    return format(ring[index(n)]);
+}
+
+QString LogBuffer::toText() const
+{
+    QMutexLocker locker(&mutex);
+
+    QString s;
+
+    for (qint64 n = first_line; n < end_line; n++) {
+        s += format(ring[index(n)]);
+        s += '\n';
+    }
+
+    return s;
+}
+
+QString LogBuffer::format(const Entry &e) const
+{
+    return format(e.text, e.time, (Severity) e.severity, show_time);
+}
+
+QString LogBuffer::format(const QString &text, const QTime &time,
+                          Severity severity, bool timestamps)
+{
+    QString s;
+
+    if (timestamps) {
+        s = "[" + time.toString("hh:mm:ss:zzz") + "] ";
+    }
+
+    switch (severity) {
+    case Warning:
+        s += "WARNING: ";
+        break;
+    case Critical:
+        s += "CRITICAL: ";
+        break;
+    case Fatal:
+        s += "FATAL: ";
+        break;
+    default:
+        break;
+    }
+
+    return s + text;
+}
+
+int LogBuffer::index(qint64 n) const
+{
+    return (head + (int)(n - first_line)) % ring.count();
+}
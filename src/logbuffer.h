@@ -0,0 +1,106 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _LOGBUFFER_H_
+#define _LOGBUFFER_H_
+
+#include <QString>
+#include <QTime>
+#include <QVector>
+#include <QMutex>
+
+//! LogBuffer keeps the last lines of a log in a ring of fixed capacity.
+
+/*!
+ Each line stores its text, the time it was received and its severity,
+ the prefix shown in the log ("[hh:mm:ss:zzz] WARNING: ") is only built
+ when the line is read. When the buffer is full the oldest line is
+ dropped, so a log that runs for days uses the same memory as one that
+ has just reached its capacity.
+
+ Lines are numbered from the last clear(), so a number keeps pointing
+ to the same line while older ones are dropped. Lines from firstLine()
+ to endLine() - 1 are available.
+
+ The buffer can be written from any thread, readers (like LogWindow)
+ poll state() to know what has changed.
+*/
+
+class LogBuffer
+{
+public:
+    enum Severity { Debug = 0, Warning = 1, Critical = 2, Fatal = 3 };
+
+    LogBuffer(int capacity = 10000, bool timestamps = false);
+    ~LogBuffer();
+
+    //! Maximum number of lines. If it's reduced the oldest lines are dropped.
+    void setCapacity(int capacity);
+    int capacity() const;
+
+    //! If true every line starts with the time it was received
+    void setTimestamps(bool b);
+    bool timestamps() const;
+
+    void append(const QString &text, Severity severity = Debug);
+    void clear();
+
+    //! Number of lines available
+    int count() const;
+    qint64 firstLine() const;
+    qint64 endLine() const;
+
+    //! Gets the range of lines and the number of times the buffer has
+    //! been cleared, all at once.
+    void state(qint64 *first, qint64 *end, int *clears) const;
+
+    //! Returns the line \a n formatted, or an empty string if the line
+    //! has already been dropped.
+    QString line(qint64 n) const;
+
+    //! All lines, each one followed by a newline
+    QString toText() const;
+
+    //! Builds a line as it's shown in the log
+    static QString format(const QString &text, const QTime &time,
+                          Severity severity, bool timestamps);
+
+protected:
+    struct Entry {
+        QString text;
+        QTime time;
+        quint8 severity;
+    };
+
+    QString format(const Entry &e) const;
+    //! Position in the ring of the line \a n, which must be available
+    int index(qint64 n) const;
+
+    QVector<Entry> ring;
+    int max_lines;
+    int head;
+    qint64 first_line;
+    qint64 end_line;
+    int clear_count;
+    bool show_time;
+
+    mutable QMutex mutex;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "loglevels.h"
+#include <QStringList>
+
+int Log::levels[Log::NumCategories] = { Log::Normal, Log::Normal, Log::Normal,
+                                        Log::Normal, Log::Normal
+                                      };
+
+static const char *category_names[Log::NumCategories] = {
+    "process", "playlist", "gui", "net", "settings"
+};
+
+static int levelFromString(const QString &s)
+{
+    if (s == "quiet" || s == "off") return Log::Quiet;
+    if (s == "normal" || s == "on") return Log::Normal;
+    if (s == "verbose") return Log::Verbose;
+
+    bool ok;
+    int l = s.toInt(&ok);
+
+    if (!ok) return -1;
+
+    return qBound((int) Log::Quiet, l, (int) Log::Verbose);
+}
+
+void Log::setLevels(const QString &spec)
+{
+    for (int n = 0; n < NumCategories; n++) {
+        levels[n] = Normal;
+    }
+
+    QStringList entries = spec.toLower().split(",", QString::SkipEmptyParts);
+
+    foreach(QString entry, entries) {
+        int pos = entry.indexOf('=');
+
+        if (pos == -1) {
+            qWarning("Log::setLevels: invalid entry '%s'", entry.toUtf8().constData());
+            continue;
+        }
+
+        QString name = entry.left(pos).trimmed();
+        int level = levelFromString(entry.mid(pos + 1).trimmed());
+
+        if (level == -1) {
+            qWarning("Log::setLevels: invalid level in '%s'", entry.toUtf8().constData());
+            continue;
+        }
+
+        bool found = false;
+
+        for (int n = 0; n < NumCategories; n++) {
+            if ((name == "all") || (name == category_names[n])) {
+                levels[n] = level;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            qWarning("Log::setLevels: unknown category '%s'", name.toUtf8().constData());
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _LOGLEVELS_H_
+#define _LOGLEVELS_H_
+
+#include <QString>
+#include <QtGlobal>
+
+//! Debug messages by subsystem, each one with its own level.
+
+/*!
+ LOG_DEBUG(category, format, ...) and LOG_VERBOSE(category, format, ...)
+ take the same arguments as qDebug() after the category. The level is
+ checked before the arguments are evaluated, so something like
+ str.toUtf8().data() costs nothing when the category is off.
+
+ LOG_DEBUG is for normal messages, LOG_VERBOSE for the ones written
+ many times per second or per item (every line from mplayer, every
+ icon lookup...), which are off by default.
+
+ Building with NO_DEBUG_LOG defined (cmake -DDISABLE_DEBUG_LOG=ON)
+ removes both from the binary. Warnings are not affected.
+*/
+
+namespace Log
+{
+
+enum Category { Process = 0, Playlist = 1, Gui = 2, Net = 3, Settings = 4,
+                NumCategories = 5
+              };
+
+enum Level { Quiet = 0, Normal = 1, Verbose = 2 };
+
+//! Current level of each category
+extern int levels[NumCategories];
+
+//! Sets the levels from a string like "all=quiet,process=verbose".
+//! The level can be a name or a number, entries are applied in order.
+//! Categories not mentioned are set to Normal.
+void setLevels(const QString &spec);
+
+inline bool enabled(Category category, Level level)
+{
+    return (levels[category] >= level);
+}
+
+}
+
+#ifdef NO_DEBUG_LOG
+#define LOG_DEBUG(category, ...) do { } while (0)
+#define LOG_VERBOSE(category, ...) do { } while (0)
+#else
+#define LOG_DEBUG(category, ...) \
+    do { if (Log::enabled(category, Log::Normal)) qDebug(__VA_ARGS__); } while (0)
+#define LOG_VERBOSE(category, ...) \
+    do { if (Log::enabled(category, Log::Verbose)) qDebug(__VA_ARGS__); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "logmodel.h"
+#include "logbuffer.h"
+
+LogModel::LogModel(LogBuffer *buffer, QObject *parent)
+    : QAbstractListModel(parent)
+{
+    this->buffer = buffer;
+    buffer->state(&first_line, &end_line, &clear_count);
+}
+
+LogModel::~LogModel()
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+
+    return end_line - first_line;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if ((!index.isValid()) || (role != Qt::DisplayRole)) return QVariant();
+
+    // The line may have been dropped after the last update, then it's empty
+    return buffer->line(first_line + index.row());
+}
+
+bool LogModel::update()
+{
+    qint64 first, end;
+    int clears;
+    buffer->state(&first, &end, &clears);
+
+    if ((first == first_line) && (end == end_line) && (clears == clear_count)) {
+        return false;
+    }
+
+    if ((clears != clear_count) || (first >= end_line)) {
+        // Nothing in common with what is shown
+        beginResetModel();
+        first_line = first;
+        end_line = end;
+        clear_count = clears;
+        endResetModel();
+        return true;
+    }
+
+    if (first > first_line) {
+        beginRemoveRows(QModelIndex(), 0, first - first_line - 1);
+        first_line = first;
+        endRemoveRows();
+    }
+
+    if (end > end_line) {
+        beginInsertRows(QModelIndex(), end_line - first_line, end - first_line - 1);
+        end_line = end;
+        endInsertRows();
+    }
+
+    return true;
+}
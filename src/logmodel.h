@@ -0,0 +1,60 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _LOGMODEL_H_
+#define _LOGMODEL_H_
+
+#include <QAbstractListModel>
+
+class LogBuffer;
+
+//! LogModel shows the lines of a LogBuffer in a QListView.
+
+/*!
+ The lines are not copied, the model reads them from the buffer when
+ the view paints them, so only the visible ones are formatted. The
+ buffer doesn't notify changes, update() must be called to add the new
+ lines and remove the dropped ones, all of them at once.
+*/
+
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    LogModel(LogBuffer *buffer, QObject *parent = 0);
+    ~LogModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    //! Synchronizes the rows with the buffer. Returns true if there
+    //! was any change.
+    bool update();
+
+protected:
+    LogBuffer *buffer;
+
+    //! Lines of the buffer shown in the rows
+    qint64 first_line;
+    qint64 end_line;
+    int clear_count;
+};
+
+#endif
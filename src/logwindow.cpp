@@ -24,8 +24,15 @@
 #include <QMessageBox>
 #include <QFileInfo>
 #include <QPushButton>
+#include <QListView>
+#include <QScrollBar>
+#include <QTimer>
+#include <QClipboard>
+#include <QApplication>
 
 #include "images.h"
+#include "logbuffer.h"
+#include "logmodel.h"
 
 LogWindow::LogWindow(QWidget *parent)
     : QWidget(parent, Qt::Window)
@@ -33,6 +40,16 @@ LogWindow::LogWindow(QWidget *parent)
     setupUi(this);
 
     browser->setFont(QFont("fixed"));
+    lines->setFont(QFont("fixed"));
+    lines->hide();
+
+    log_buffer = 0;
+    log_model = 0;
+
+    // About 25 updates per second at most, no matter how fast lines arrive
+    update_timer = new QTimer(this);
+    update_timer->setInterval(40);
+    connect(update_timer, SIGNAL(timeout()), this, SLOT(updateLines()));
 
     retranslateStrings();
 }
@@ -68,6 +85,8 @@ void LogWindow::setText(QString log)
 
 QString LogWindow::text()
 {
+    if (log_buffer) return log_buffer->toText();
+
     return browser->toPlainText();
 }
 
@@ -98,8 +117,72 @@ void LogWindow::appendHtml(QString text)
     browser->insertHtml(text);
 }
 
+void LogWindow::setLogBuffer(LogBuffer *buffer)
+{
+    if (buffer == log_buffer) return;
+
+    lines->setModel(0);
+    delete log_model;
+    log_model = 0;
+
+    log_buffer = buffer;
+
+    if (log_buffer) {
+        log_model = new LogModel(log_buffer, this);
+        lines->setModel(log_model);
+        browser->hide();
+        lines->show();
+
+        if (isVisible()) {
+            lines->scrollToBottom();
+            update_timer->start();
+        }
+    } else {
+        update_timer->stop();
+        lines->hide();
+        browser->show();
+    }
+}
+
+void LogWindow::updateLines()
+{
+    if (!log_model) return;
+
+    // Follow the new lines only if the user hasn't scrolled up
+    QScrollBar *bar = lines->verticalScrollBar();
+    bool at_bottom = (bar->value() == bar->maximum());
+
+    if (log_model->update() && at_bottom) {
+        lines->scrollToBottom();
+    }
+}
+
+void LogWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    if (log_model) {
+        log_model->update();
+        lines->scrollToBottom();
+        update_timer->start();
+    }
+}
+
+void LogWindow::hideEvent(QHideEvent *event)
+{
+    // Nothing to paint, the model catches up when it's shown again
+    update_timer->stop();
+
+    QWidget::hideEvent(event);
+}
+
 void LogWindow::on_copyButton_clicked()
 {
+    if (log_buffer) {
+        QApplication::clipboard()->setText(log_buffer->toText());
+        return;
+    }
+
     browser->selectAll();
     browser->copy();
 }
@@ -129,7 +212,7 @@ void LogWindow::on_saveButton_clicked()
 
         if (file.open(QIODevice::WriteOnly)) {
             QTextStream stream(&file);
-            stream << browser->toPlainText();
+            stream << text();
             file.close();
         } else {
             // Error opening file
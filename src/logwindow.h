@@ -22,6 +22,9 @@
 #include "ui_logwindowbase.h"
 
 class QTextEdit;
+class QTimer;
+class LogBuffer;
+class LogModel;
 
 class LogWindow : public QWidget, public Ui::LogWindowBase
 {
@@ -42,15 +45,28 @@ public:
     void appendText(QString text);
     void appendHtml(QString text);
 
+    //! Shows the lines of \a buffer instead of a text. Only the visible
+    //! lines are painted, and the new ones are added a few times per
+    //! second while the window is visible. Setting 0 goes back to text.
+    void setLogBuffer(LogBuffer *buffer);
+
     /* QTextEdit * editor(); */
 
 protected:
     virtual void retranslateStrings();
     virtual void changeEvent(QEvent *event) ;
+    virtual void showEvent(QShowEvent *event);
+    virtual void hideEvent(QHideEvent *event);
 
 protected slots:
     void on_copyButton_clicked();
     void on_saveButton_clicked();
+    void updateLines();
+
+protected:
+    LogBuffer *log_buffer;
+    LogModel *log_model;
+    QTimer *update_timer;
 };
 
 
@@ -0,0 +1,145 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "logwriter.h"
+#include "paths.h"
+#include <QFileInfo>
+
+LogWriter::LogWriter(QObject *parent)
+    : QThread(parent)
+    , pending(0)
+    , stopping(0)
+{
+    max_size = 4 * 1024 * 1024;
+    backups = 3;
+}
+
+LogWriter::~LogWriter()
+{
+    stop();
+}
+
+void LogWriter::write(const QString &text, LogBuffer::Severity severity)
+{
+    Record *r = new Record;
+    r->text = text;
+    r->time = QTime::currentTime();
+    r->severity = severity;
+
+    Record *head;
+
+    do {
+        head = pending;
+        r->next = head;
+    } while (!pending.testAndSetRelease(head, r));
+}
+
+void LogWriter::stop()
+{
+    if (isRunning()) {
+        stopping = 1;
+        wait();
+    }
+
+    // Lines queued after the thread finished
+    flushPending();
+
+    if (file.isOpen()) file.close();
+}
+
+void LogWriter::run()
+{
+    while (stopping == 0) {
+        flushPending();
+        msleep(250);
+    }
+
+    flushPending();
+}
+
+void LogWriter::flushPending()
+{
+    Record *r = pending.fetchAndStoreAcquire(0);
+
+    if (!r) return;
+
+    // The list is newest first, reverse it
+    Record *list = 0;
+
+    while (r) {
+        Record *next = r->next;
+        r->next = list;
+        list = r;
+        r = next;
+    }
+
+    QString s;
+
+    while (list) {
+        s += LogBuffer::format(list->text, list->time, list->severity, true);
+        s += "\r\n";
+
+        Record *next = list->next;
+        delete list;
+        list = next;
+    }
+
+    if (!file.isOpen() && !openFile()) return;
+
+    QByteArray data = s.toUtf8();
+
+    if ((file.size() > 0) && (file.size() + data.size() > max_size)) {
+        rotate();
+
+        if (!file.isOpen()) return;
+    }
+
+    file.write(data);
+    file.flush();
+}
+
+bool LogWriter::openFile()
+{
+    // A new log is started every time smplayer2 is run
+    file.setFileName(Paths::configPath() + "/smplayer2_log.txt");
+    return file.open(QIODevice::WriteOnly);
+}
+
+void LogWriter::rotate()
+{
+    file.close();
+
+    QFile::remove(backupName(backups));
+
+    for (int n = backups - 1; n >= 1; n--) {
+        if (QFile::exists(backupName(n))) {
+            QFile::rename(backupName(n), backupName(n + 1));
+        }
+    }
+
+    if (backups > 0) {
+        QFile::rename(file.fileName(), backupName(1));
+    }
+
+    file.open(QIODevice::WriteOnly);
+}
+
+QString LogWriter::backupName(int n)
+{
+    return Paths::configPath() + QString("/smplayer2_log.%1.txt").arg(n);
+}
@@ -0,0 +1,97 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _LOGWRITER_H_
+#define _LOGWRITER_H_
+
+#include <QThread>
+#include <QAtomicPointer>
+#include <QAtomicInt>
+#include <QString>
+#include <QTime>
+#include <QFile>
+#include "logbuffer.h"
+
+//! LogWriter saves the smplayer2 log to a file in the background.
+
+/*!
+ write() only links the line to a lock-free list, so the thread which
+ logs never waits for the disk or for other threads. The writer thread
+ takes the whole list a few times per second and saves it with a single
+ write, adding the time and severity prefix. When the file grows over
+ maxSize() it's renamed to smplayer2_log.1.txt (the previous backups
+ are moved one number up) and a new one is started.
+
+ The writer must not use qDebug, its messages would be written again.
+*/
+
+class LogWriter : public QThread
+{
+public:
+    LogWriter(QObject *parent = 0);
+    ~LogWriter();
+
+    //! Queues a line. Can be called from any thread.
+    void write(const QString &text, LogBuffer::Severity severity);
+
+    //! Writes the pending lines and finishes the thread
+    void stop();
+
+    void setMaxSize(qint64 bytes) {
+        max_size = bytes;
+    };
+    qint64 maxSize() {
+        return max_size;
+    };
+
+    void setBackups(int n) {
+        backups = n;
+    };
+    int numBackups() {
+        return backups;
+    };
+
+protected:
+    struct Record {
+        QString text;
+        QTime time;
+        LogBuffer::Severity severity;
+        Record *next;
+    };
+
+    virtual void run();
+
+    //! Saves the lines queued so far
+    void flushPending();
+    bool openFile();
+    void rotate();
+    QString backupName(int n);
+
+protected:
+    //! Most recent record first
+    QAtomicPointer<Record> pending;
+    QAtomicInt stopping;
+
+    // Only used by the thread
+    QFile file;
+    qint64 max_size;
+    int backups;
+};
+
+#endif
@@ -18,12 +18,15 @@
 
 #include <QApplication>
 #include <QFile>
-#include <QTime>
+#include <QMutex>
+#include <QRegExp>
 
 #include "smplayer2.h"
 #include "global.h"
 #include "helper.h"
 #include "paths.h"
+#include "logbuffer.h"
+#include "logwriter.h"
 
 #include <stdio.h>
 
@@ -42,93 +45,79 @@ using namespace Global;
 
 BaseGui *basegui_instance = 0;
 
-QFile output_log;
+LogWriter *log_writer = 0;
 
-void myMessageOutput(QtMsgType type, const char *msg)
+//! Returns true if the line matches pref->log_filter. The regexp is
+//! only compiled again when the filter changes.
+static bool passesLogFilter(const QString &line)
 {
-    static QStringList saved_lines;
-    static QString orig_line;
-    static QString line2;
-    static QRegExp rx_log;
+    static QMutex mutex;
+    static QString pattern(".*");
+    static QRegExp rx_log(pattern);
 
-    if (pref) {
-        if (!pref->log_smplayer2) return;
+    QRegExp rx;
 
-        rx_log.setPattern(pref->log_filter);
-    } else {
-        rx_log.setPattern(".*");
+    {
+        QMutexLocker locker(&mutex);
+
+        QString p = pref ? pref->log_filter : QString(".*");
+
+        if (p != pattern) {
+            pattern = p;
+            rx_log.setPattern(pattern);
+        }
+
+        if ((pattern.isEmpty()) || (pattern == ".*")) return true;
+
+        // Copies share the compiled regexp, but not the match state,
+        // so each thread can use its own
+        rx = rx_log;
     }
 
-    line2.clear();
+    return (rx.indexIn(line) > -1);
+}
+
+void myMessageOutput(QtMsgType type, const char *msg)
+{
+    if ((pref) && (!pref->log_smplayer2)) return;
 
-    orig_line = QString::fromUtf8(msg);
+    QString line = QString::fromUtf8(msg);
+    LogBuffer::Severity severity = LogBuffer::Debug;
 
     switch (type) {
     case QtDebugMsg:
 
-        if (rx_log.indexIn(orig_line) > -1) {
+        if (!passesLogFilter(line)) return;
+
 #ifndef NO_DEBUG_ON_CONSOLE
-            fprintf(stderr, "Debug: %s\n", orig_line.toLocal8Bit().data());
+        fprintf(stderr, "Debug: %s\n", line.toLocal8Bit().data());
 #endif
-            line2 = orig_line;
-        }
-
         break;
     case QtWarningMsg:
 #ifndef NO_DEBUG_ON_CONSOLE
-        fprintf(stderr, "Warning: %s\n", orig_line.toLocal8Bit().data());
+        fprintf(stderr, "Warning: %s\n", line.toLocal8Bit().data());
 #endif
-        line2 = "WARNING: " + orig_line;
+        severity = LogBuffer::Warning;
         break;
     case QtFatalMsg:
 #ifndef NO_DEBUG_ON_CONSOLE
-        fprintf(stderr, "Fatal: %s\n", orig_line.toLocal8Bit().data());
+        fprintf(stderr, "Fatal: %s\n", line.toLocal8Bit().data());
 #endif
-        line2 = "FATAL: " + orig_line;
         abort();                    // deliberately core dump
     case QtCriticalMsg:
 #ifndef NO_DEBUG_ON_CONSOLE
-        fprintf(stderr, "Critical: %s\n", orig_line.toLocal8Bit().data());
+        fprintf(stderr, "Critical: %s\n", line.toLocal8Bit().data());
 #endif
-        line2 = "CRITICAL: " + orig_line;
+        severity = LogBuffer::Critical;
         break;
     }
 
-    if (line2.isEmpty()) return;
-
-    line2 = "[" + QTime::currentTime().toString("hh:mm:ss:zzz") + "] " + line2;
-
-    if (basegui_instance) {
-        if (!saved_lines.isEmpty()) {
-            // Send saved lines first
-            for (int n = 0; n < saved_lines.count(); n++) {
-                basegui_instance->recordSmplayerLog(saved_lines[n]);
-            }
-
-            saved_lines.clear();
-        }
+    // The buffer keeps the time and severity, the log window adds the prefix
+    smplayer2_log->append(line, severity);
 
-        basegui_instance->recordSmplayerLog(line2);
-    } else {
-        // GUI is not created yet, save lines for later
-        saved_lines.append(line2);
-    }
-
-    if (pref) {
-        if (pref->save_smplayer2_log) {
-            // Save log to file
-            if (!output_log.isOpen()) {
-                // FIXME: the config path may not be initialized if USE_LOCKS is not defined
-                output_log.setFileName(Paths::configPath() + "/smplayer2_log.txt");
-                output_log.open(QIODevice::WriteOnly);
-            }
-
-            if (output_log.isOpen()) {
-                QString l = line2 + "\r\n";
-                output_log.write(l.toUtf8().constData());
-                output_log.flush();
-            }
-        }
+    if ((pref) && (pref->save_smplayer2_log) && (log_writer)) {
+        // Formatted and saved by the writer thread
+        log_writer->write(line, severity);
     }
 }
 
@@ -220,6 +209,9 @@ int main(int argc, char **argv)
         }
     }
 
+    log_writer = new LogWriter();
+    log_writer->start(QThread::LowPriority);
+
     qInstallMsgHandler(myMessageOutput);
 
 #if USE_LOCKS
@@ -321,7 +313,9 @@ int main(int argc, char **argv)
     basegui_instance = 0;
     delete smplayer2;
 
-    if (output_log.isOpen()) output_log.close();
+    LogWriter *w = log_writer;
+    log_writer = 0;
+    delete w;
 
     return r;
 }
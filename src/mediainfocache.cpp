@@ -0,0 +1,529 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "mediainfocache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtAlgorithms>
+
+// Increase it if the format of the file changes
+#define CACHE_MAGIC 0x534d4943 // SMIC
+#define CACHE_VERSION 1
+
+// Upper limit of the number of tracks, subtitles or chapters of a file.
+// A bigger count means the file is corrupt.
+#define MAX_ITEMS 10000
+
+// The cache is saved in the background after this number of changes,
+// or if it has changes and it was saved more than SAVE_INTERVAL ms ago
+#define SAVE_CHANGES 50
+#define SAVE_INTERVAL 300000
+
+//! Reads the number of items of a list, and checks it
+static qint32 readCount(QDataStream &stream)
+{
+    qint32 count;
+    stream >> count;
+
+    if ((count < 0) || (count > MAX_ITEMS)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return 0;
+    }
+
+    return count;
+}
+
+static void writeTracks(QDataStream &stream, Tracks &tracks)
+{
+    stream << (qint32) tracks.numItems();
+
+    for (int n = 0; n < tracks.numItems(); n++) {
+        TrackData t = tracks.itemAt(n);
+        stream << (qint32) t.ID() << t.lang() << t.name();
+    }
+}
+
+static void readTracks(QDataStream &stream, Tracks &tracks)
+{
+    qint32 count = readCount(stream);
+
+    for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+        qint32 ID;
+        QString lang, name;
+        stream >> ID >> lang >> name;
+
+        tracks.addID(ID);
+
+        if (!lang.isEmpty()) tracks.addLang(ID, lang);
+
+        if (!name.isEmpty()) tracks.addName(ID, name);
+    }
+}
+
+static void writeSubs(QDataStream &stream, SubTracks &subs)
+{
+    stream << (qint32) subs.numItems();
+
+    for (int n = 0; n < subs.numItems(); n++) {
+        SubData s = subs.itemAt(n);
+        stream << (qint32) s.type() << (qint32) s.ID() << s.lang() << s.name() << s.filename();
+    }
+}
+
+static void readSubs(QDataStream &stream, SubTracks &subs)
+{
+    qint32 count = readCount(stream);
+
+    for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+        qint32 type, ID;
+        QString lang, name, filename;
+        stream >> type >> ID >> lang >> name >> filename;
+
+        SubData::Type t = (SubData::Type) type;
+        subs.add(t, ID);
+
+        if (!lang.isEmpty()) subs.changeLang(t, ID, lang);
+
+        if (!name.isEmpty()) subs.changeName(t, ID, name);
+
+        if (!filename.isEmpty()) subs.changeFilename(t, ID, filename);
+    }
+}
+
+static void writeMediaData(QDataStream &stream, MediaData &md)
+{
+    stream << md.filename << md.duration
+           << (qint32) md.video_width << (qint32) md.video_height << md.video_aspect
+           << (qint32) md.type << md.novideo;
+
+#if PROGRAM_SWITCH
+    writeTracks(stream, md.programs);
+#else
+    stream << (qint32) 0;
+#endif
+    writeTracks(stream, md.videos);
+    writeTracks(stream, md.audios);
+    writeSubs(stream, md.subs);
+
+    stream << (qint32) md.chapters << md.chapters_name;
+
+    stream << (qint32) md.chapters_timestamp.count();
+    QMap<int, long long>::const_iterator it;
+
+    for (it = md.chapters_timestamp.constBegin(); it != md.chapters_timestamp.constEnd(); ++it) {
+        stream << (qint32) it.key() << (qint64) it.value();
+    }
+
+    stream << (qint32) md.editions;
+
+    stream << md.clip_name << md.clip_artist << md.clip_author << md.clip_album
+           << md.clip_genre << md.clip_date << md.clip_track << md.clip_copyright
+           << md.clip_comment << md.clip_software;
+
+    stream << md.demuxer << md.video_format << md.audio_format
+           << (qint32) md.video_bitrate << md.video_fps << (qint32) md.audio_bitrate
+           << (qint32) md.audio_rate << (qint32) md.audio_nch
+           << md.video_codec << md.audio_codec;
+}
+
+static void readMediaData(QDataStream &stream, MediaData &md)
+{
+    qint32 video_width, video_height, type;
+    stream >> md.filename >> md.duration
+           >> video_width >> video_height >> md.video_aspect
+           >> type >> md.novideo;
+    md.video_width = video_width;
+    md.video_height = video_height;
+    md.type = type;
+
+#if PROGRAM_SWITCH
+    readTracks(stream, md.programs);
+#else
+    Tracks programs;
+    readTracks(stream, programs);
+#endif
+    readTracks(stream, md.videos);
+    readTracks(stream, md.audios);
+    readSubs(stream, md.subs);
+
+    qint32 chapters;
+    stream >> chapters >> md.chapters_name;
+    md.chapters = chapters;
+
+    qint32 count = readCount(stream);
+
+    for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+        qint32 chapter;
+        qint64 timestamp;
+        stream >> chapter >> timestamp;
+        md.chapters_timestamp[chapter] = timestamp;
+    }
+
+    qint32 editions;
+    stream >> editions;
+    md.editions = editions;
+
+    stream >> md.clip_name >> md.clip_artist >> md.clip_author >> md.clip_album
+           >> md.clip_genre >> md.clip_date >> md.clip_track >> md.clip_copyright
+           >> md.clip_comment >> md.clip_software;
+
+    qint32 video_bitrate, audio_bitrate, audio_rate, audio_nch;
+    stream >> md.demuxer >> md.video_format >> md.audio_format
+           >> video_bitrate >> md.video_fps >> audio_bitrate
+           >> audio_rate >> audio_nch
+           >> md.video_codec >> md.audio_codec;
+    md.video_bitrate = video_bitrate;
+    md.audio_bitrate = audio_bitrate;
+    md.audio_rate = audio_rate;
+    md.audio_nch = audio_nch;
+}
+
+
+MediaInfoCache::Writer::Writer(const QString &filename)
+    : save_failed(0)
+{
+    file = filename;
+    has_pending = false;
+    pending_use_counter = 0;
+    thread_active = false;
+}
+
+void MediaInfoCache::Writer::queue(const EntryHash &entries, quint32 use_counter)
+{
+    QMutexLocker locker(&mutex);
+
+    // Copying the hash is cheap, it's shared until one of them changes
+    pending = entries;
+    pending_use_counter = use_counter;
+    has_pending = true;
+
+    if (!thread_active) {
+        thread_active = true;
+        // The previous run() may still be returning
+        wait();
+        start(QThread::LowPriority);
+    }
+}
+
+void MediaInfoCache::Writer::run()
+{
+    while (true) {
+        EntryHash entries;
+        quint32 use_counter;
+
+        {
+            QMutexLocker locker(&mutex);
+
+            if (!has_pending) {
+                thread_active = false;
+                return;
+            }
+
+            entries = pending;
+            use_counter = pending_use_counter;
+            pending = EntryHash();
+            has_pending = false;
+        }
+
+        save_failed = writeFile(file, entries, use_counter) ? 0 : 1;
+    }
+}
+
+
+MediaInfoCache::MediaInfoCache(const QString &filename, int max_entries)
+{
+    file = filename;
+    use_counter = 0;
+    changed = false;
+    unsaved_changes = 0;
+    writer = new Writer(filename);
+
+    setMaxEntries(max_entries);
+    load();
+}
+
+MediaInfoCache::~MediaInfoCache()
+{
+    writer->wait();
+
+    if ((changed) || (writer->failed())) save();
+
+    delete writer;
+}
+
+MediaData MediaInfoCache::identifyInfo(const MediaData &data)
+{
+    MediaData info = data;
+    SubTracks subs = info.subs;
+
+    // Subtitles given with -sub or loaded with sub_load
+    info.subs.clear();
+
+    for (int n = 0; n < subs.numItems(); n++) {
+        SubData sub = subs.itemAt(n);
+
+        if (sub.type() == SubData::File) continue;
+
+        info.subs.add(sub.type(), sub.ID());
+
+        if (!sub.lang().isEmpty()) info.subs.changeLang(sub.type(), sub.ID(), sub.lang());
+
+        if (!sub.name().isEmpty()) info.subs.changeName(sub.type(), sub.ID(), sub.name());
+    }
+
+    info.stream_title.clear();
+    info.stream_url.clear();
+    info.initialized = false;
+
+    return info;
+}
+
+bool MediaInfoCache::find(const QString &filename, MediaData &data)
+{
+    QFileInfo fi(filename);
+
+    if (!fi.exists()) return false;
+
+    EntryHash::iterator it = entries.find(fi.absoluteFilePath());
+
+    if (it == entries.end()) return false;
+
+    if ((it->size != fi.size()) || (it->modified != fi.lastModified().toTime_t())) {
+        qDebug("MediaInfoCache::find: '%s' has changed", filename.toUtf8().data());
+        entries.erase(it);
+        setChanged();
+        return false;
+    }
+
+    // Not worth saving the file just for this, the order of use is
+    // written along with the next real change
+    it->last_used = ++use_counter;
+
+    data = it->data;
+    data.filename = filename;
+
+    return true;
+}
+
+void MediaInfoCache::insert(const QString &filename, MediaData data)
+{
+    QFileInfo fi(filename);
+
+    if (!fi.exists()) return;
+
+    // mplayer failed, maybe it can play it next time
+    if ((data.duration <= 0) && (data.demuxer.isEmpty())) return;
+
+    Entry e;
+    e.size = fi.size();
+    e.modified = fi.lastModified().toTime_t();
+    e.last_used = ++use_counter;
+    e.data = data;
+
+    entries.insert(fi.absoluteFilePath(), e);
+
+    if (entries.count() > max_entries) prune();
+
+    setChanged();
+}
+
+void MediaInfoCache::remove(const QString &filename)
+{
+    if (entries.remove(QFileInfo(filename).absoluteFilePath()) > 0) setChanged();
+}
+
+void MediaInfoCache::clear()
+{
+    entries.clear();
+    use_counter = 0;
+    setChanged();
+}
+
+void MediaInfoCache::setMaxEntries(int n)
+{
+    max_entries = n;
+
+    if (max_entries < 0) max_entries = 0;
+
+    if (entries.count() > max_entries) prune();
+}
+
+void MediaInfoCache::setChanged()
+{
+    changed = true;
+    unsaved_changes++;
+
+    if ((unsaved_changes >= SAVE_CHANGES) ||
+            ((save_time.isValid()) && (save_time.elapsed() > SAVE_INTERVAL))) {
+        qDebug("MediaInfoCache::setChanged: saving %d entries in the background", entries.count());
+
+        writer->queue(entries, use_counter);
+
+        changed = false;
+        unsaved_changes = 0;
+        save_time.start();
+    }
+}
+
+void MediaInfoCache::prune()
+{
+    // Remove a bit more than needed, so it doesn't happen on every insert
+    int keep = max_entries - max_entries / 10;
+    int to_remove = entries.count() - keep;
+
+    if (to_remove <= 0) return;
+
+    qDebug("MediaInfoCache::prune: removing %d entries", to_remove);
+
+    QVector<quint32> uses;
+    uses.reserve(entries.count());
+
+    EntryHash::const_iterator it;
+
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        uses.append(it->last_used);
+    }
+
+    qSort(uses);
+    quint32 oldest_kept = (to_remove < uses.count()) ? uses[to_remove] : uses.last() + 1;
+
+    EntryHash::iterator i = entries.begin();
+
+    while (i != entries.end()) {
+        if (i->last_used < oldest_kept) i = entries.erase(i);
+        else ++i;
+    }
+
+    changed = true;
+}
+
+bool MediaInfoCache::load()
+{
+    qDebug("MediaInfoCache::load: '%s'", file.toUtf8().data());
+
+    // Don't read a file which is being replaced
+    writer->wait();
+
+    entries.clear();
+    use_counter = 0;
+
+    save_time.start();
+
+    QFile f(file);
+
+    // The program may have died while replacing it
+    if ((!f.exists()) && (QFile::exists(file + ".new"))) {
+        f.setFileName(file + ".new");
+    }
+
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    quint32 magic;
+    qint32 version, count;
+    stream >> magic >> version;
+
+    if ((magic != CACHE_MAGIC) || (version != CACHE_VERSION)) {
+        qWarning("MediaInfoCache::load: unknown format, ignoring the file");
+        return false;
+    }
+
+    stream >> use_counter >> count;
+
+    if (count < 0) count = 0;
+
+    for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+        QString key;
+        Entry e;
+        stream >> key >> e.size >> e.modified >> e.last_used;
+        readMediaData(stream, e.data);
+
+        if (stream.status() == QDataStream::Ok) entries.insert(key, e);
+    }
+
+    changed = false;
+    unsaved_changes = 0;
+
+    qDebug("MediaInfoCache::load: %d entries", entries.count());
+
+    return true;
+}
+
+bool MediaInfoCache::save()
+{
+    qDebug("MediaInfoCache::save: %d entries", entries.count());
+
+    // A save in the background would replace this one with older entries
+    writer->wait();
+
+    if (!writeFile(file, entries, use_counter)) return false;
+
+    changed = false;
+    unsaved_changes = 0;
+    save_time.start();
+
+    return true;
+}
+
+bool MediaInfoCache::writeFile(const QString &filename, EntryHash entries, quint32 use_counter)
+{
+    // Written to another file first, so there's always a complete one
+    QFile f(filename + ".new");
+
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("MediaInfoCache::writeFile: can't write '%s'", f.fileName().toUtf8().data());
+        return false;
+    }
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    stream << (quint32) CACHE_MAGIC << (qint32) CACHE_VERSION;
+    stream << use_counter << (qint32) entries.count();
+
+    EntryHash::iterator it;
+
+    for (it = entries.begin(); it != entries.end(); ++it) {
+        stream << it.key() << it->size << it->modified << it->last_used;
+        writeMediaData(stream, it->data);
+    }
+
+    bool ok = (f.error() == QFile::NoError);
+    f.close();
+
+    if (!ok) {
+        qWarning("MediaInfoCache::writeFile: error writing '%s'", f.fileName().toUtf8().data());
+        f.remove();
+        return false;
+    }
+
+    QFile::remove(filename);
+
+    if (!f.rename(filename)) {
+        qWarning("MediaInfoCache::writeFile: can't rename '%s'", f.fileName().toUtf8().data());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,157 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _MEDIAINFOCACHE_H_
+#define _MEDIAINFOCACHE_H_
+
+#include <QString>
+#include <QHash>
+#include <QTime>
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include "mediadata.h"
+
+//! MediaInfoCache remembers the info mplayer gives about local files.
+
+/*!
+ The info (duration, name, tracks, chapters, resolution...) is saved to a
+ file in the config directory, so a file which was identified before
+ doesn't need to be identified again, even after restarting the program.
+
+ The entries are found by the absolute path of the file. Its size and
+ modification time are stored too; if they change the entry is discarded.
+ When there are more than maxEntries() the ones not used for longer are
+ removed.
+
+ After a number of changes, or when there's a change some minutes after
+ the last save, a copy of the entries is written by a thread, so the GUI
+ doesn't wait for the disk during a scan. The destructor and save()
+ write it right away.
+
+ Only what mplayer reports with -identify should be stored, see
+ identifyInfo().
+*/
+
+class MediaInfoCache
+{
+
+public:
+    MediaInfoCache(const QString &filename, int max_entries = 5000);
+    //! Saves the cache if it has been modified
+    ~MediaInfoCache();
+
+    //! Returns true if there's up to date info about the file,
+    //! which is copied to \a data.
+    bool find(const QString &filename, MediaData &data);
+
+    //! Stores the info about a local file. Nothing is stored if the
+    //! file doesn't exist or mplayer couldn't identify it.
+    void insert(const QString &filename, MediaData data);
+
+    //! Returns \a data without the things which depend on how the file
+    //! was played rather than on the file: the subtitles loaded from
+    //! other files and the stream title.
+    static MediaData identifyInfo(const MediaData &data);
+
+    void remove(const QString &filename);
+    void clear();
+
+    int count() {
+        return entries.count();
+    };
+
+    void setMaxEntries(int n);
+    int maxEntries() {
+        return max_entries;
+    };
+
+    bool load();
+    //! Saves the cache now, after any save in progress in the background
+    bool save();
+
+protected:
+    class Entry
+    {
+    public:
+        Entry() {
+            size = 0;
+            modified = 0;
+            last_used = 0;
+        };
+
+        qint64 size;
+        uint modified;
+        quint32 last_used;
+        MediaData data;
+    };
+
+    typedef QHash<QString, Entry> EntryHash;
+
+    //! Saves a copy of the entries in the background
+    class Writer : public QThread
+    {
+    public:
+        Writer(const QString &filename);
+
+        //! Saves \a entries, when the save in progress (if any) is done.
+        //! Only the newest entries queued are saved.
+        void queue(const EntryHash &entries, quint32 use_counter);
+
+        //! True if the last save in the background has failed
+        bool failed() {
+            return (save_failed != 0);
+        };
+
+    protected:
+        virtual void run();
+
+        QString file;
+        QMutex mutex;
+        bool has_pending;
+        EntryHash pending;
+        quint32 pending_use_counter;
+        //! True from queue() until run() has nothing more to save
+        bool thread_active;
+        QAtomicInt save_failed;
+    };
+
+    //! Writes \a entries to \a filename. Can be called from any thread.
+    static bool writeFile(const QString &filename, EntryHash entries, quint32 use_counter);
+
+    //! Marks the cache as modified, and saves it if it's time to
+    void setChanged();
+
+    //! Removes the entries not used for longer, until there are no more
+    //! than max_entries
+    void prune();
+
+    QString file;
+    EntryHash entries;
+    int max_entries;
+    Writer *writer;
+
+    //! Increased every time an entry is used
+    quint32 use_counter;
+    bool changed;
+    //! Number of changes since the last save
+    int unsaved_changes;
+    QTime save_time;
+};
+
+#endif
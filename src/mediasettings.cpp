@@ -304,7 +304,7 @@ void MediaSettings::list()
 }
 
 #ifndef NO_USE_INI_FILES
-void MediaSettings::save(QSettings *set)
+void MediaSettings::save(QVariantMap &map)
 {
     qDebug("MediaSettings::save");
 
@@ -312,93 +312,93 @@ void MediaSettings::save(QSettings *set)
 
     /*set->beginGroup( "mediasettings" );*/
 
-    set->setValue("current_sec", current_sec);
-    set->setValue("current_sub_id", current_sub_id);
+    map.insert("current_sec", current_sec);
+    map.insert("current_sub_id", current_sub_id);
 #if PROGRAM_SWITCH
-    set->setValue("current_program_id", current_program_id);
+    map.insert("current_program_id", current_program_id);
 #endif
-    set->setValue("current_video_id", current_video_id);
-    set->setValue("current_audio_id", current_audio_id);
-    set->setValue("current_title_id", current_title_id);
-    set->setValue("current_chapter_id", current_chapter_id);
-    set->setValue("current_edition_id", current_edition_id);
-    set->setValue("current_angle_id", current_angle_id);
+    map.insert("current_video_id", current_video_id);
+    map.insert("current_audio_id", current_audio_id);
+    map.insert("current_title_id", current_title_id);
+    map.insert("current_chapter_id", current_chapter_id);
+    map.insert("current_edition_id", current_edition_id);
+    map.insert("current_angle_id", current_angle_id);
 
-    set->setValue("aspect_ratio", aspect_ratio_id);
-    //set->setValue( "fullscreen", fullscreen );
-    set->setValue("volume", volume);
-    set->setValue("mute", mute);
-    set->setValue("external_subtitles", external_subtitles);
-    set->setValue("external_audio", external_audio);
-    set->setValue("sub_delay", sub_delay);
-    set->setValue("audio_delay", audio_delay);
-    set->setValue("sub_scale_ass", sub_scale_ass);
+    map.insert("aspect_ratio", aspect_ratio_id);
+    //map.insert( "fullscreen", fullscreen );
+    map.insert("volume", volume);
+    map.insert("mute", mute);
+    map.insert("external_subtitles", external_subtitles);
+    map.insert("external_audio", external_audio);
+    map.insert("sub_delay", sub_delay);
+    map.insert("audio_delay", audio_delay);
+    map.insert("sub_scale_ass", sub_scale_ass);
 
-    set->setValue("closed_caption_channel", closed_caption_channel);
+    map.insert("closed_caption_channel", closed_caption_channel);
 
-    set->setValue("brightness", brightness);
-    set->setValue("contrast", contrast);
-    set->setValue("gamma", gamma);
-    set->setValue("hue", hue);
-    set->setValue("saturation", saturation);
+    map.insert("brightness", brightness);
+    map.insert("contrast", contrast);
+    map.insert("gamma", gamma);
+    map.insert("hue", hue);
+    map.insert("saturation", saturation);
 
-    set->setValue("audio_equalizer", audio_equalizer);
+    map.insert("audio_equalizer", audio_equalizer);
 
-    set->setValue("speed", speed);
+    map.insert("speed", speed);
 
-    set->setValue("phase_filter", phase_filter);
-    set->setValue("current_denoiser", current_denoiser);
-    set->setValue("deblock_filter", deblock_filter);
-    set->setValue("dering_filter", dering_filter);
-    set->setValue("noise_filter", noise_filter);
-    set->setValue("upscaling_filter", upscaling_filter);
+    map.insert("phase_filter", phase_filter);
+    map.insert("current_denoiser", current_denoiser);
+    map.insert("deblock_filter", deblock_filter);
+    map.insert("dering_filter", dering_filter);
+    map.insert("noise_filter", noise_filter);
+    map.insert("upscaling_filter", upscaling_filter);
 
-    set->setValue("current_deinterlacer", current_deinterlacer);
+    map.insert("current_deinterlacer", current_deinterlacer);
 
-    set->setValue("add_letterbox", add_letterbox);
+    map.insert("add_letterbox", add_letterbox);
 
-    set->setValue("karaoke_filter", karaoke_filter);
-    set->setValue("extrastereo_filter", extrastereo_filter);
-    set->setValue("volnorm_filter", volnorm_filter);
+    map.insert("karaoke_filter", karaoke_filter);
+    map.insert("extrastereo_filter", extrastereo_filter);
+    map.insert("volnorm_filter", volnorm_filter);
 
-    set->setValue("audio_use_channels", audio_use_channels);
-    set->setValue("stereo_mode", stereo_mode);
+    map.insert("audio_use_channels", audio_use_channels);
+    map.insert("stereo_mode", stereo_mode);
 
-    set->setValue("zoom_factor", zoom_factor);
+    map.insert("zoom_factor", zoom_factor);
 
-    set->setValue("panscan_factor", zoom_factor);
+    map.insert("panscan_factor", zoom_factor);
 
-    set->setValue("rotate", rotate);
-    set->setValue("flip", flip);
-    set->setValue("mirror", mirror);
+    map.insert("rotate", rotate);
+    map.insert("flip", flip);
+    map.insert("mirror", mirror);
 
-    set->setValue("loop", loop);
-    set->setValue("A_marker", A_marker);
-    set->setValue("B_marker", B_marker);
+    map.insert("loop", loop);
+    map.insert("A_marker", A_marker);
+    map.insert("B_marker", B_marker);
 
-    set->setValue("forced_demuxer", forced_demuxer);
-    set->setValue("forced_video_codec", forced_video_codec);
-    set->setValue("forced_audio_codec", forced_audio_codec);
+    map.insert("forced_demuxer", forced_demuxer);
+    map.insert("forced_video_codec", forced_video_codec);
+    map.insert("forced_audio_codec", forced_audio_codec);
 
-    set->setValue("original_demuxer", original_demuxer);
-    set->setValue("original_video_codec", original_video_codec);
-    set->setValue("original_audio_codec", original_audio_codec);
+    map.insert("original_demuxer", original_demuxer);
+    map.insert("original_video_codec", original_video_codec);
+    map.insert("original_audio_codec", original_audio_codec);
 
-    set->setValue("mplayer_additional_options", mplayer_additional_options);
-    set->setValue("mplayer_additional_video_filters", mplayer_additional_video_filters);
-    set->setValue("mplayer_additional_audio_filters", mplayer_additional_audio_filters);
+    map.insert("mplayer_additional_options", mplayer_additional_options);
+    map.insert("mplayer_additional_video_filters", mplayer_additional_video_filters);
+    map.insert("mplayer_additional_audio_filters", mplayer_additional_audio_filters);
 
-    set->setValue("win_width", win_width);
-    set->setValue("win_height", win_height);
+    map.insert("win_width", win_width);
+    map.insert("win_height", win_height);
 
-    set->setValue("starting_time", starting_time);
+    map.insert("starting_time", starting_time);
 
-    set->setValue("is264andHD", is264andHD);
+    map.insert("is264andHD", is264andHD);
 
     /*set->endGroup();*/
 }
 
-void MediaSettings::load(QSettings *set)
+void MediaSettings::load(const QVariantMap &map)
 {
     qDebug("MediaSettings::load");
 
@@ -406,88 +406,88 @@ void MediaSettings::load(QSettings *set)
 
     /*set->beginGroup( "mediasettings" );*/
 
-    current_sec = set->value("current_sec", current_sec).toDouble();
-    current_sub_id = set->value("current_sub_id", current_sub_id).toInt();
+    current_sec = map.value("current_sec", current_sec).toDouble();
+    current_sub_id = map.value("current_sub_id", current_sub_id).toInt();
 #if PROGRAM_SWITCH
-    current_program_id = set->value("current_program_id", current_program_id).toInt();
+    current_program_id = map.value("current_program_id", current_program_id).toInt();
 #endif
-    current_video_id = set->value("current_video_id", current_video_id).toInt();
-    current_audio_id = set->value("current_audio_id", current_audio_id).toInt();
-    current_title_id = set->value("current_title_id", current_title_id).toInt();
-    current_chapter_id = set->value("current_chapter_id", current_chapter_id).toInt();
-    current_edition_id = set->value("current_edition_id", current_edition_id).toInt();
-    current_angle_id = set->value("current_angle_id", current_angle_id).toInt();
+    current_video_id = map.value("current_video_id", current_video_id).toInt();
+    current_audio_id = map.value("current_audio_id", current_audio_id).toInt();
+    current_title_id = map.value("current_title_id", current_title_id).toInt();
+    current_chapter_id = map.value("current_chapter_id", current_chapter_id).toInt();
+    current_edition_id = map.value("current_edition_id", current_edition_id).toInt();
+    current_angle_id = map.value("current_angle_id", current_angle_id).toInt();
 
-    aspect_ratio_id = set->value("aspect_ratio", aspect_ratio_id).toInt();
-    //fullscreen = set->value( "fullscreen", fullscreen ).toBool();
-    volume = set->value("volume", volume).toInt();
-    mute = set->value("mute", mute).toBool();
-    external_subtitles = set->value("external_subtitles", external_subtitles).toString();
-    external_audio = set->value("external_audio", external_audio).toString();
-    sub_delay = set->value("sub_delay", sub_delay).toInt();
-    audio_delay = set->value("audio_delay", audio_delay).toInt();
-    sub_scale_ass = set->value("sub_scale_ass", sub_scale_ass).toDouble();
+    aspect_ratio_id = map.value("aspect_ratio", aspect_ratio_id).toInt();
+    //fullscreen = map.value( "fullscreen", fullscreen ).toBool();
+    volume = map.value("volume", volume).toInt();
+    mute = map.value("mute", mute).toBool();
+    external_subtitles = map.value("external_subtitles", external_subtitles).toString();
+    external_audio = map.value("external_audio", external_audio).toString();
+    sub_delay = map.value("sub_delay", sub_delay).toInt();
+    audio_delay = map.value("audio_delay", audio_delay).toInt();
+    sub_scale_ass = map.value("sub_scale_ass", sub_scale_ass).toDouble();
 
-    closed_caption_channel = set->value("closed_caption_channel", closed_caption_channel).toInt();
+    closed_caption_channel = map.value("closed_caption_channel", closed_caption_channel).toInt();
 
-    brightness = set->value("brightness", brightness).toInt();
-    contrast = set->value("contrast", contrast).toInt();
-    gamma = set->value("gamma", gamma).toInt();
-    hue = set->value("hue", hue).toInt();
-    saturation = set->value("saturation", saturation).toInt();
+    brightness = map.value("brightness", brightness).toInt();
+    contrast = map.value("contrast", contrast).toInt();
+    gamma = map.value("gamma", gamma).toInt();
+    hue = map.value("hue", hue).toInt();
+    saturation = map.value("saturation", saturation).toInt();
 
-    audio_equalizer = set->value("audio_equalizer", audio_equalizer).toList();
+    audio_equalizer = map.value("audio_equalizer", audio_equalizer).toList();
 
-    speed = set->value("speed", speed).toDouble();
+    speed = map.value("speed", speed).toDouble();
 
-    phase_filter = set->value("phase_filter", phase_filter).toBool();
-    current_denoiser = set->value("current_denoiser", current_denoiser).toInt();
-    deblock_filter = set->value("deblock_filter", deblock_filter).toBool();
-    dering_filter = set->value("dering_filter", dering_filter).toBool();
-    noise_filter = set->value("noise_filter", noise_filter).toBool();
-    upscaling_filter = set->value("upscaling_filter", upscaling_filter).toBool();
+    phase_filter = map.value("phase_filter", phase_filter).toBool();
+    current_denoiser = map.value("current_denoiser", current_denoiser).toInt();
+    deblock_filter = map.value("deblock_filter", deblock_filter).toBool();
+    dering_filter = map.value("dering_filter", dering_filter).toBool();
+    noise_filter = map.value("noise_filter", noise_filter).toBool();
+    upscaling_filter = map.value("upscaling_filter", upscaling_filter).toBool();
 
-    current_deinterlacer = set->value("current_deinterlacer", current_deinterlacer).toInt();
+    current_deinterlacer = map.value("current_deinterlacer", current_deinterlacer).toInt();
 
-    add_letterbox = set->value("add_letterbox", add_letterbox).toBool();
+    add_letterbox = map.value("add_letterbox", add_letterbox).toBool();
 
-    karaoke_filter = set->value("karaoke_filter", karaoke_filter).toBool();
-    extrastereo_filter = set->value("extrastereo_filter", extrastereo_filter).toBool();
-    volnorm_filter = set->value("volnorm_filter", volnorm_filter).toBool();
+    karaoke_filter = map.value("karaoke_filter", karaoke_filter).toBool();
+    extrastereo_filter = map.value("extrastereo_filter", extrastereo_filter).toBool();
+    volnorm_filter = map.value("volnorm_filter", volnorm_filter).toBool();
 
-    audio_use_channels = set->value("audio_use_channels", audio_use_channels).toInt();
-    stereo_mode = set->value("stereo_mode", stereo_mode).toInt();
+    audio_use_channels = map.value("audio_use_channels", audio_use_channels).toInt();
+    stereo_mode = map.value("stereo_mode", stereo_mode).toInt();
 
-    zoom_factor = set->value("zoom_factor", zoom_factor).toDouble();
+    zoom_factor = map.value("zoom_factor", zoom_factor).toDouble();
 
-    panscan_factor = set->value("panscan_factor", panscan_factor).toDouble();
+    panscan_factor = map.value("panscan_factor", panscan_factor).toDouble();
 
-    rotate = set->value("rotate", rotate).toInt();
-    flip = set->value("flip", flip).toBool();
-    mirror = set->value("mirror", mirror).toBool();
+    rotate = map.value("rotate", rotate).toInt();
+    flip = map.value("flip", flip).toBool();
+    mirror = map.value("mirror", mirror).toBool();
 
-    loop = set->value("loop", loop).toBool();
-    A_marker = set->value("A_marker", A_marker).toInt();
-    B_marker = set->value("B_marker", B_marker).toInt();
+    loop = map.value("loop", loop).toBool();
+    A_marker = map.value("A_marker", A_marker).toInt();
+    B_marker = map.value("B_marker", B_marker).toInt();
 
-    forced_demuxer = set->value("forced_demuxer", forced_demuxer).toString();
-    forced_video_codec = set->value("forced_video_codec", forced_video_codec).toString();
-    forced_audio_codec = set->value("forced_audio_codec", forced_audio_codec).toString();
+    forced_demuxer = map.value("forced_demuxer", forced_demuxer).toString();
+    forced_video_codec = map.value("forced_video_codec", forced_video_codec).toString();
+    forced_audio_codec = map.value("forced_audio_codec", forced_audio_codec).toString();
 
-    original_demuxer = set->value("original_demuxer", original_demuxer).toString();
-    original_video_codec = set->value("original_video_codec", original_video_codec).toString();
-    original_audio_codec = set->value("original_audio_codec", original_audio_codec).toString();
+    original_demuxer = map.value("original_demuxer", original_demuxer).toString();
+    original_video_codec = map.value("original_video_codec", original_video_codec).toString();
+    original_audio_codec = map.value("original_audio_codec", original_audio_codec).toString();
 
-    mplayer_additional_options = set->value("mplayer_additional_options", mplayer_additional_options).toString();
-    mplayer_additional_video_filters = set->value("mplayer_additional_video_filters", mplayer_additional_video_filters).toString();
-    mplayer_additional_audio_filters = set->value("mplayer_additional_audio_filters", mplayer_additional_audio_filters).toString();
+    mplayer_additional_options = map.value("mplayer_additional_options", mplayer_additional_options).toString();
+    mplayer_additional_video_filters = map.value("mplayer_additional_video_filters", mplayer_additional_video_filters).toString();
+    mplayer_additional_audio_filters = map.value("mplayer_additional_audio_filters", mplayer_additional_audio_filters).toString();
 
-    win_width = set->value("win_width", win_width).toInt();
-    win_height = set->value("win_height", win_height).toInt();
+    win_width = map.value("win_width", win_width).toInt();
+    win_height = map.value("win_height", win_height).toInt();
 
-    starting_time = set->value("starting_time", starting_time).toDouble();
+    starting_time = map.value("starting_time", starting_time).toDouble();
 
-    is264andHD = set->value("is264andHD", is264andHD).toBool();
+    is264andHD = map.value("is264andHD", is264andHD).toBool();
 
     /*set->endGroup();*/
 
@@ -495,4 +495,28 @@ void MediaSettings::load(QSettings *set)
     if (audio_use_channels == ChDefault) audio_use_channels = ChStereo;
 }
 
+void MediaSettings::save(QSettings *set)
+{
+    QVariantMap map;
+    save(map);
+
+    QVariantMap::const_iterator it;
+
+    for (it = map.constBegin(); it != map.constEnd(); ++it) {
+        set->setValue(it.key(), it.value());
+    }
+}
+
+void MediaSettings::load(QSettings *set)
+{
+    QVariantMap map;
+    QStringList keys = set->childKeys();
+
+    for (int n = 0; n < keys.count(); n++) {
+        map.insert(keys[n], set->value(keys[n]));
+    }
+
+    load(map);
+}
+
 #endif // NO_USE_INI_FILES
@@ -25,6 +25,7 @@
 
 #include <QString>
 #include <QSize>
+#include <QVariantMap>
 #include "config.h"
 #include "audioequalizerlist.h"
 
@@ -171,6 +172,10 @@ public:
 #ifndef NO_USE_INI_FILES
     void save(QSettings *set);
     void load(QSettings *set);
+
+    //! The same settings as a map, for other kinds of storage
+    void save(QVariantMap &map);
+    void load(const QVariantMap &map);
 #endif
 };
 
@@ -25,6 +25,7 @@
 #include "global.h"
 #include "preferences.h"
 #include "colorutils.h"
+#include "loglevels.h"
 
 using namespace Global;
 
@@ -47,8 +48,15 @@ MplayerProcess::MplayerProcess(QObject *parent) : MyProcess(parent)
     connect(this, SIGNAL(error(QProcess::ProcessError)),
             this, SLOT(gotError(QProcess::ProcessError)));
 
+    connect(&position_timer, SIGNAL(timeout()),
+            this, SLOT(publishPosition()));
+
     notified_mplayer_is_running = false;
+    received_id_line = false;
     last_sub_id = -1;
+    position_pending = false;
+    idle_mode = false;
+    replacing_file = false;
 }
 
 MplayerProcess::~MplayerProcess()
@@ -56,9 +64,31 @@ MplayerProcess::~MplayerProcess()
 }
 
 bool MplayerProcess::start()
+{
+    resetFileInfo();
+
+    idle_mode = arguments().contains("-idle");
+    replacing_file = false;
+
+    MyProcess::start();
+    return waitForStarted();
+}
+
+void MplayerProcess::prepareNewFile(bool closing_file)
+{
+    LOG_DEBUG(Log::Process, "MplayerProcess::prepareNewFile: closing_file: %d", closing_file);
+
+    flushPosition();
+    resetFileInfo();
+
+    replacing_file = closing_file;
+}
+
+void MplayerProcess::resetFileInfo()
 {
     md.reset();
     notified_mplayer_is_running = false;
+    received_id_line = false;
     last_sub_id = -1;
     received_end_of_file = false;
 
@@ -75,699 +105,837 @@ bool MplayerProcess::start()
 
     dvd_current_title = -1;
 
-    MyProcess::start();
-    return waitForStarted();
+    position_timer.stop();
+    position_pending = false;
 }
 
 void MplayerProcess::writeToStdin(QString text)
 {
     if (isRunning()) {
-        //qDebug("MplayerProcess::writeToStdin");
+        //LOG_DEBUG(Log::Process, "MplayerProcess::writeToStdin");
+        // Don't let a position from before the seek arrive late
+        if (text.startsWith("seek") || text.contains(" seek")) flushPosition();
+
         write(text.toLocal8Bit() + "\n");
     } else {
         qWarning("MplayerProcess::writeToStdin: process not running");
     }
 }
 
-static QRegExp rx_av("^[AV]: *([0-9,:.-]+)");
-static QRegExp rx_v("V: *([0-9,:.-]+)");
-static QRegExp rx_frame("^[AV]:.* (\\d+)\\/.\\d+");// [0-9,.]+");
-static QRegExp rx("^(.*)=(.*)");
-#if !NOTIFY_AUDIO_CHANGES
-static QRegExp rx_audio_mat("^ID_AID_(\\d+)_(LANG|NAME)=(.*)");
-#endif
-static QRegExp rx_video("^ID_VID_(\\d+)_(LANG|NAME)=(.*)");
-static QRegExp rx_title("^ID_DVD_TITLE_(\\d+)_(LENGTH|CHAPTERS|ANGLES)=(.*)");
-static QRegExp rx_winresolution("^VO: \\[(.*)\\] (\\d+)x(\\d+) => (\\d+)x(\\d+)");
-static QRegExp rx_ao("^AO: \\[(.*)\\]");
-static QRegExp rx_paused("^ID_PAUSED");
-#if !CHECK_VIDEO_CODEC_FOR_NO_VIDEO
-static QRegExp rx_novideo("^Video: no video");
-#endif
-static QRegExp rx_cache("^Cache fill:.*");
-static QRegExp rx_create_index("^Generating Index:.*");
-static QRegExp rx_play("^Starting playback...");
-static QRegExp rx_connecting("^Connecting to .*");
-static QRegExp rx_resolving("^Resolving .*");
-static QRegExp rx_screenshot("^\\*\\*\\* screenshot '(.*)'");
-static QRegExp rx_endoffile("^Exiting... \\(End of file\\)|^ID_EXIT=EOF");
-static QRegExp rx_mkvchapters_name("^ID_CHAPTER_(\\d+)_NAME=(.*)");
-static QRegExp rx_mkvchapters_timestamp("^ID_CHAPTER_(\\d+)_START=(\\d+)");
-static QRegExp rx_mkveditions("\\[mkv\\] Found (\\d+) editions, will play #(\\d+)");
-static QRegExp rx_chapter("^ANS_chapter=(.*)");
+// Most lines are dispatched by their prefix and parsed straight from the
+// raw bytes. The regular expressions below are only used for the few
+// lines that don't start with a known keyword, and most of them are
+// printed only once per file.
 static QRegExp rx_aspect2("^Movie-Aspect is ([0-9,.]+):1");
 static QRegExp rx_fontcache("^\\[ass\\] Updating font cache|^\\[ass\\] Init|^\\[fontconfig\\] Scanning dir");
 static QRegExp rx_scanning_font("Scanning file|^\\[\\d+/\\d+\\]");
 #if DVDNAV_SUPPORT
 static QRegExp rx_dvdnav_switch_title("^DVDNAV, switched to title: (\\d+)");
-static QRegExp rx_dvdnav_length("^ANS_length=(.*)");
-static QRegExp rx_dvdnav_title_is_menu("^DVDNAV_TITLE_IS_MENU");
-static QRegExp rx_dvdnav_title_is_movie("^DVDNAV_TITLE_IS_MOVIE");
-#endif
-
-// VCD
-static QRegExp rx_vcd("^ID_VCD_TRACK_(\\d+)_MSF=(.*)");
-
-// Audio CD
-static QRegExp rx_cdda("^ID_CDDA_TRACK_(\\d+)_MSF=(.*)");
-
-//Subtitles
-static QRegExp rx_subtitle("^ID_(SUBTITLE|FILE_SUB|VOBSUB)_ID=(\\d+)");
-static QRegExp rx_sid("^ID_(SID|VSID)_(\\d+)_(LANG|NAME)=(.*)");
-static QRegExp rx_subtitle_file("^ID_FILE_SUB_FILENAME=(.*)");
-
-// Audio
-#if NOTIFY_AUDIO_CHANGES
-static QRegExp rx_audio("^ID_AUDIO_ID=(\\d+)");
-static QRegExp rx_audio_info("^ID_AID_(\\d+)_(LANG|NAME)=(.*)");
 #endif
 
 #if PROGRAM_SWITCH
 static QRegExp rx_program("^PROGRAM_ID=(\\d+)");
 #endif
 
-//Clip info
-static QRegExp rx_clip_name("^ (name|title): (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_artist("^ artist: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_author("^ author: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_album("^ album: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_genre("^ genre: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_date("^ (creation date|year): (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_track("^ track: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_copyright("^ copyright: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_comment("^ comment: (.*)", Qt::CaseInsensitive);
-static QRegExp rx_clip_software("^ software: (.*)", Qt::CaseInsensitive);
-
 static QRegExp rx_stream_title("^.* StreamTitle='(.*)';");
 static QRegExp rx_stream_title_and_url("^.* StreamTitle='(.*)';StreamUrl='(.*)';");
 
+//Clip info
+struct ClipInfoTag {
+    const char *name;
+    QString MediaData::*field;
+};
+
+static const ClipInfoTag clip_info_tags[] = {
+    { "name", &MediaData::clip_name },
+    { "title", &MediaData::clip_name },
+    { "artist", &MediaData::clip_artist },
+    { "author", &MediaData::clip_author },
+    { "album", &MediaData::clip_album },
+    { "genre", &MediaData::clip_genre },
+    { "creation date", &MediaData::clip_date },
+    { "year", &MediaData::clip_date },
+    { "track", &MediaData::clip_track },
+    { "copyright", &MediaData::clip_copyright },
+    { "comment", &MediaData::clip_comment },
+    { "software", &MediaData::clip_software }
+};
+
+static inline QString decodeOutput(const QByteArray &ba)
+{
+#ifdef WIN32
+    return QString::fromUtf8(ba);
+#else
+    return QString::fromLocal8Bit(ba);
+#endif
+}
+
+static inline bool isStatusNumberChar(char c)
+{
+    return ((c >= '0') && (c <= '9')) || (c == '.') || (c == ',') || (c == ':') || (c == '-');
+}
+
+//! Parses the number in the status line which begins at \a from
+//! (leading spaces are skipped). Returns false if there's no number there.
+static bool statusNumberAt(const QByteArray &ba, int from, double *value)
+{
+    const int size = ba.size();
+    const char *data = ba.constData();
+
+    while ((from < size) && (data[from] == ' ')) from++;
+
+    int end = from;
+
+    while ((end < size) && isStatusNumberChar(data[end])) end++;
+
+    if (end == from) return false;
+
+    *value = QByteArray::fromRawData(data + from, end - from).toDouble();
+    return true;
+}
+
+//! Finds the frame counter in the status line ("... 123/123 ...").
+//! Returns -1 if there isn't any.
+static int statusFrame(const QByteArray &ba)
+{
+    const char *data = ba.constData();
+
+    for (int pos = ba.size() - 3; pos > 2; pos--) {
+        if ((data[pos] != '/') || (data[pos + 2] < '0') || (data[pos + 2] > '9')) continue;
+
+        int start = pos;
+
+        while ((start > 2) && (data[start - 1] >= '0') && (data[start - 1] <= '9')) start--;
+
+        if ((start == pos) || (data[start - 1] != ' ')) continue;
+
+        int frame = 0;
+
+        for (int n = start; n < pos; n++) frame = frame * 10 + (data[n] - '0');
+
+        return frame;
+    }
+
+    return -1;
+}
+
+//! Splits tags like ID_AID_1_LANG, whose prefix length is \a prefix_len,
+//! into the numeric id and the field name after it.
+static bool splitIndexedTag(const QByteArray &tag, int prefix_len, int *id, QByteArray *field)
+{
+    int n = prefix_len;
+    int value = 0;
+
+    while ((n < tag.size()) && (tag.at(n) >= '0') && (tag.at(n) <= '9')) {
+        value = value * 10 + (tag.at(n) - '0');
+        n++;
+    }
+
+    if ((n == prefix_len) || (n >= tag.size()) || (tag.at(n) != '_')) return false;
+
+    *id = value;
+    *field = tag.mid(n + 1);
+    return true;
+}
+
+static inline bool startsWithDigit(const QByteArray &ba)
+{
+    return !ba.isEmpty() && (ba.at(0) >= '0') && (ba.at(0) <= '9');
+}
 
 void MplayerProcess::parseLine(QByteArray ba)
 {
-    //qDebug("MplayerProcess::parseLine: '%s'", ba.data() );
+    //LOG_DEBUG(Log::Process, "MplayerProcess::parseLine: '%s'", ba.data() );
 
-    QString tag;
-    QString value;
+#if COLOR_OUTPUT_SUPPORT
 
+    // Only pay for stripping the colors if there's an escape sequence
+    if (ba.indexOf('\033') != -1) {
 #ifdef WIN32
-    QString line = QString::fromUtf8(ba);
+        ba = ColorUtils::stripColorsTags(decodeOutput(ba)).toUtf8();
 #else
-    QString line = QString::fromLocal8Bit(ba);
+        ba = ColorUtils::stripColorsTags(decodeOutput(ba)).toLocal8Bit();
 #endif
-#if COLOR_OUTPUT_SUPPORT
-    line = ColorUtils::stripColorsTags(line);
+    }
+
 #endif
 
     // Parse A: V: line
-    //qDebug("%s", line.toUtf8().data());
-    if (rx_av.indexIn(line) > -1) {
-        double sec = rx_av.cap(1).toDouble();
+    if ((ba.startsWith("A:") || ba.startsWith("V:")) && parseStatusLine(ba)) {
+        return;
+    }
+
+    QString line = decodeOutput(ba);
+
+    emit lineAvailable(line);
+
+    // Parse other things
+    LOG_VERBOSE(Log::Process, "MplayerProcess::parseLine: '%s'", line.toUtf8().data());
+
+    if (ba.startsWith("ID_")) {
+        if (!received_id_line) {
+            received_id_line = true;
+            emit receivedFirstIdLine();
+        }
+
+        parseIdLine(ba, line);
+    } else if (ba.startsWith("ANS_")) {
+        parseAnswerLine(ba);
+    } else if (ba.startsWith("VO:")) {
+        parseVOLine(ba);
+    } else if (ba.startsWith("AO:")) {
+        // AO
+        if (!notified_mplayer_is_running && ba.startsWith("AO: [")) {
+            int end = ba.lastIndexOf(']');
 
-        if (rx_v.indexIn(line) > -1) {
-            sec = rx_v.cap(1).toDouble();
+            if (end > 4) emit receivedAO(decodeOutput(ba.mid(5, end - 5)));
         }
+    } else if (ba.startsWith("[mkv]")) {
+        parseMkvLine(ba);
+    } else {
+        parseOtherLine(ba, line);
+    }
+}
+
+//! Parses the A: V: status line. Returns false if the line doesn't
+//! contain a valid time.
+bool MplayerProcess::parseStatusLine(const QByteArray &ba)
+{
+    double sec;
+
+    if (!statusNumberAt(ba, 2, &sec)) return false;
+
+    int v_pos = ba.indexOf("V:");
+
+    if (v_pos > -1) {
+        statusNumberAt(ba, v_pos + 2, &sec);
+    }
 
-        //qDebug("cap(1): '%s'", rx_av.cap(1).toUtf8().data() );
-        //qDebug("sec: %f", sec);
+    //qDebug("sec: %f", sec);
 
 #if NOTIFY_SUB_CHANGES
 
-        if (notified_mplayer_is_running) {
-            if (subtitle_info_changed) {
-                qDebug("MplayerProcess::parseLine: subtitle_info_changed");
-                subtitle_info_changed = false;
-                subtitle_info_received = false;
-                emit subtitleInfoChanged(subs);
-            }
+    if (notified_mplayer_is_running) {
+        if (subtitle_info_changed) {
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseStatusLine: subtitle_info_changed");
+            subtitle_info_changed = false;
+            subtitle_info_received = false;
+            emit subtitleInfoChanged(subs);
+        }
 
-            if (subtitle_info_received) {
-                qDebug("MplayerProcess::parseLine: subtitle_info_received");
-                subtitle_info_received = false;
-                emit subtitleInfoReceivedAgain(subs);
-            }
+        if (subtitle_info_received) {
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseStatusLine: subtitle_info_received");
+            subtitle_info_received = false;
+            emit subtitleInfoReceivedAgain(subs);
         }
+    }
 
 #endif
 
 #if NOTIFY_AUDIO_CHANGES
 
-        if (notified_mplayer_is_running) {
-            if (audio_info_changed) {
-                qDebug("MplayerProcess::parseLine: audio_info_changed");
-                audio_info_changed = false;
-                emit audioInfoChanged(audios);
-            }
+    if (notified_mplayer_is_running) {
+        if (audio_info_changed) {
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseStatusLine: audio_info_changed");
+            audio_info_changed = false;
+            emit audioInfoChanged(audios);
         }
+    }
 
 #endif
 
-        if (!notified_mplayer_is_running) {
-            qDebug("MplayerProcess::parseLine: starting sec: %f", sec);
+    if (!notified_mplayer_is_running) {
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseStatusLine: starting sec: %f", sec);
 
-            if ((md.chapters <= 0) && (dvd_current_title > 0) &&
-                    (md.titles.find(dvd_current_title) != -1)) {
-                int idx = md.titles.find(dvd_current_title);
-                md.chapters = md.titles.itemAt(idx).chapters();
-                qDebug("MplayerProcess::parseLine: setting chapters to %d", md.chapters);
-            }
+        if ((md.chapters <= 0) && (dvd_current_title > 0) &&
+                (md.titles.find(dvd_current_title) != -1)) {
+            int idx = md.titles.find(dvd_current_title);
+            md.chapters = md.titles.itemAt(idx).chapters();
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseStatusLine: setting chapters to %d", md.chapters);
+        }
 
 #if CHECK_VIDEO_CODEC_FOR_NO_VIDEO
 
-            // Another way to find out if there's no video
-            if (md.video_codec.isEmpty()) {
-                md.novideo = true;
-                emit receivedNoVideo();
-            }
+        // Another way to find out if there's no video
+        if (md.video_codec.isEmpty()) {
+            md.novideo = true;
+            emit receivedNoVideo();
+        }
 
 #endif
 
-            emit receivedStartingTime(sec);
-            emit mplayerFullyLoaded();
+        emit receivedStartingTime(sec);
+        emit mplayerFullyLoaded();
 
-            emit receivedCurrentFrame(0); // Ugly hack: set the frame counter to 0
+        emit receivedCurrentFrame(0); // Ugly hack: set the frame counter to 0
 
-            notified_mplayer_is_running = true;
-        }
+        notified_mplayer_is_running = true;
+    }
 
-        emit receivedCurrentSec(sec);
+    // Check for frame
+    int frame = statusFrame(ba);
+    //qDebug(" frame: %d", frame);
 
-        // Check for frame
-        if (rx_frame.indexIn(line) > -1) {
-            int frame = rx_frame.cap(1).toInt();
-            //qDebug(" frame: %d", frame);
-            emit receivedCurrentFrame(frame);
-        }
-    } else {
-        emit lineAvailable(line);
+    queuePosition(sec, frame);
 
-        // Parse other things
-        qDebug("MplayerProcess::parseLine: '%s'", line.toUtf8().data());
+    return true;
+}
 
-        // Screenshot
-        if (rx_screenshot.indexIn(line) > -1) {
-            QString shot = rx_screenshot.cap(1);
-            qDebug("MplayerProcess::parseLine: screenshot: '%s'", shot.toUtf8().data());
-            emit receivedScreenshot(shot);
-        } else
+void MplayerProcess::queuePosition(double sec, int frame)
+{
+    pending_sec = sec;
 
-            // End of file
-            if (rx_endoffile.indexIn(line) > -1)  {
-                qDebug("MplayerProcess::parseLine: detected end of file");
-
-                if (!received_end_of_file) {
-                    // In case of playing VCDs or DVDs, maybe the first title
-                    // is not playable, so the GUI doesn't get the info about
-                    // available titles. So if we received the end of file
-                    // first let's pretend the file has started so the GUI can have
-                    // the data.
-                    if (!notified_mplayer_is_running) {
-                        emit mplayerFullyLoaded();
-                    }
+    if (frame > -1) pending_frame = frame;
+    else if (!position_pending) pending_frame = -1;
 
-                    //emit receivedEndOfFile();
-                    // Send signal once the process is finished, not now!
-                    received_end_of_file = true;
-                }
-            } else
+    position_pending = true;
 
-                // Window resolution
-                if (rx_winresolution.indexIn(line) > -1) {
-                    /*
-                    md.win_width = rx_winresolution.cap(4).toInt();
-                    md.win_height = rx_winresolution.cap(5).toInt();
-                    md.video_aspect = (double) md.win_width / md.win_height;
-                    */
+    if (pref->position_update_rate <= 0) {
+        publishPosition();
+    } else if (!position_timer.isActive()) {
+        // The first position after a pause or a seek is sent right away,
+        // the following ones when the timer expires
+        publishPosition();
+        position_timer.start(1000 / pref->position_update_rate);
+    }
+}
 
-                    int w = rx_winresolution.cap(4).toInt();
-                    int h = rx_winresolution.cap(5).toInt();
+void MplayerProcess::publishPosition()
+{
+    if (!position_pending) {
+        // Nothing new since the last time, no need to keep waking up
+        position_timer.stop();
+        return;
+    }
 
-                    emit receivedVO(rx_winresolution.cap(1));
-                    emit receivedWindowResolution(w, h);
-                    //emit mplayerFullyLoaded();
-                } else
+    position_pending = false;
 
-#if !CHECK_VIDEO_CODEC_FOR_NO_VIDEO
+    emit receivedCurrentSec(pending_sec);
 
-                    // No video
-                    if (rx_novideo.indexIn(line) > -1) {
-                        md.novideo = TRUE;
-                        emit receivedNoVideo();
-                        //emit mplayerFullyLoaded();
-                    } else
-#endif
+    if (pending_frame > -1) emit receivedCurrentFrame(pending_frame);
+}
 
-                        // Pause
-                        if (rx_paused.indexIn(line) > -1) {
-                            emit receivedPause();
-                        }
+void MplayerProcess::flushPosition()
+{
+    position_timer.stop();
+    publishPosition();
+}
 
-        // Stream title
-        if (rx_stream_title_and_url.indexIn(line) > -1) {
-            QString s = rx_stream_title_and_url.cap(1);
-            QString url = rx_stream_title_and_url.cap(2);
-            qDebug("MplayerProcess::parseLine: stream_title: '%s'", s.toUtf8().data());
-            qDebug("MplayerProcess::parseLine: stream_url: '%s'", url.toUtf8().data());
-            md.stream_title = s;
-            md.stream_url = url;
-            emit receivedStreamTitleAndUrl(s, url);
-        } else if (rx_stream_title.indexIn(line) > -1) {
-            QString s = rx_stream_title.cap(1);
-            qDebug("MplayerProcess::parseLine: stream_title: '%s'", s.toUtf8().data());
-            md.stream_title = s;
-            emit receivedStreamTitle(s);
+void MplayerProcess::parseIdLine(const QByteArray &ba, const QString &line)
+{
+    int eq = ba.indexOf('=');
+    QByteArray tag = (eq > -1) ? ba.left(eq) : ba;
+    QByteArray value = (eq > -1) ? ba.mid(eq + 1) : QByteArray();
+
+    // End of file
+    if ((tag == "ID_EXIT") && (value == "EOF")) {
+        endOfFileDetected();
+    } else
+
+        // Pause
+        if (ba.startsWith("ID_PAUSED")) {
+            flushPosition();
+            emit receivedPause();
         }
 
+    // Everything else is a "tag=value" line
+    if (eq == -1) return;
+
+    int ID;
+    QByteArray field;
+
 #if NOTIFY_SUB_CHANGES
 
-        // Subtitles
-        if ((rx_subtitle.indexIn(line) > -1) || (rx_sid.indexIn(line) > -1) || (rx_subtitle_file.indexIn(line) > -1)) {
-            int r = subs.parse(line);
-            //qDebug("MplayerProcess::parseLine: result of parse: %d", r);
-            subtitle_info_received = true;
+    // Subtitles
+    if ((((tag == "ID_SUBTITLE_ID") || (tag == "ID_FILE_SUB_ID") || (tag == "ID_VOBSUB_ID")) && startsWithDigit(value)) ||
+            (tag.startsWith("ID_SID_") && splitIndexedTag(tag, 7, &ID, &field) && ((field == "LANG") || (field == "NAME"))) ||
+            (tag.startsWith("ID_VSID_") && splitIndexedTag(tag, 8, &ID, &field) && ((field == "LANG") || (field == "NAME"))) ||
+            (tag == "ID_FILE_SUB_FILENAME")) {
+        int r = subs.parse(line);
+        //LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: result of parse: %d", r);
+        subtitle_info_received = true;
 
-            if ((r == SubTracks::SubtitleAdded) || (r == SubTracks::SubtitleChanged)) subtitle_info_changed = true;
-        }
+        if ((r == SubTracks::SubtitleAdded) || (r == SubTracks::SubtitleChanged)) subtitle_info_changed = true;
+    }
 
 #endif
 
 #if NOTIFY_AUDIO_CHANGES
 
-        // Audio
-        if (rx_audio.indexIn(line) > -1) {
-            int ID = rx_audio.cap(1).toInt();
-            qDebug("MplayerProcess::parseLine: ID_AUDIO_ID: %d", ID);
+    // Audio
+    if ((tag == "ID_AUDIO_ID") && startsWithDigit(value)) {
+        ID = value.toInt();
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: ID_AUDIO_ID: %d", ID);
 
-            if (audios.find(ID) == -1) audio_info_changed = true;
+        if (audios.find(ID) == -1) audio_info_changed = true;
 
-            audios.addID(ID);
-        }
+        audios.addID(ID);
+    }
+
+    if (tag.startsWith("ID_AID_") && splitIndexedTag(tag, 7, &ID, &field) &&
+            ((field == "LANG") || (field == "NAME"))) {
+        QString lang = decodeOutput(value);
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Audio: ID: %d, Lang: '%s' Type: '%s'",
+               ID, lang.toUtf8().data(), field.constData());
 
-        if (rx_audio_info.indexIn(line) > -1) {
-            int ID = rx_audio_info.cap(1).toInt();
-            QString lang = rx_audio_info.cap(3);
-            QString t = rx_audio_info.cap(2);
-            qDebug("MplayerProcess::parseLine: Audio: ID: %d, Lang: '%s' Type: '%s'",
-                   ID, lang.toUtf8().data(), t.toUtf8().data());
+        int idx = audios.find(ID);
 
-            int idx = audios.find(ID);
+        if (idx == -1) {
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: audio %d doesn't exist, adding it", ID);
 
-            if (idx == -1) {
-                qDebug("MplayerProcess::parseLine: audio %d doesn't exist, adding it", ID);
+            audio_info_changed = true;
 
-                audio_info_changed = true;
+            if (field == "NAME")
+                audios.addName(ID, lang);
+            else
+                audios.addLang(ID, lang);
+        } else {
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: audio %d exists, modifing it", ID);
 
-                if (t == "NAME")
+            if (field == "NAME") {
+                if (audios.itemAt(idx).name() != lang) {
+                    audio_info_changed = true;
                     audios.addName(ID, lang);
-                else
-                    audios.addLang(ID, lang);
+                }
             } else {
-                qDebug("MplayerProcess::parseLine: audio %d exists, modifing it", ID);
-
-                if (t == "NAME") {
-                    //qDebug("MplayerProcess::parseLine: name of audio %d: %s", ID, audios.itemAt(idx).name().toUtf8().constData());
-                    if (audios.itemAt(idx).name() != lang) {
-                        audio_info_changed = true;
-                        audios.addName(ID, lang);
-                    }
-                } else {
-                    //qDebug("MplayerProcess::parseLine: language of audio %d: %s", ID, audios.itemAt(idx).lang().toUtf8().constData());
-                    if (audios.itemAt(idx).lang() != lang) {
-                        audio_info_changed = true;
-                        audios.addLang(ID, lang);
-                    }
+                if (audios.itemAt(idx).lang() != lang) {
+                    audio_info_changed = true;
+                    audios.addLang(ID, lang);
                 }
             }
         }
+    }
+
+#endif
+
+    // The following things are not sent when the file has started to play
+    // (or if sent, smplayer2 will ignore anyway...)
+    // So not process anymore, if video is playing to save some time
+    if (notified_mplayer_is_running) {
+        return;
+    }
+
+#if !NOTIFY_SUB_CHANGES
+
+    // Subtitles
+    if ((tag == "ID_SUBTITLE_ID") || (tag == "ID_FILE_SUB_ID") || (tag == "ID_VOBSUB_ID") ||
+            tag.startsWith("ID_SID_") || tag.startsWith("ID_VSID_") || (tag == "ID_FILE_SUB_FILENAME")) {
+        md.subs.parse(line);
+    }
 
 #endif
 
+#if !NOTIFY_AUDIO_CHANGES
+
+    // Matroska audio
+    if (tag.startsWith("ID_AID_") && splitIndexedTag(tag, 7, &ID, &field) &&
+            ((field == "LANG") || (field == "NAME"))) {
+        QString lang = decodeOutput(value);
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Audio: ID: %d, Lang: '%s' Type: '%s'",
+               ID, lang.toUtf8().data(), field.constData());
+
+        if (field == "NAME")
+            md.audios.addName(ID, lang);
+        else
+            md.audios.addLang(ID, lang);
+    } else
+
+        // Generic audio
+        if (tag == "ID_AUDIO_ID") {
+            ID = value.toInt();
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: ID_AUDIO_ID: %d", ID);
+            md.audios.addID(ID);
+        } else
+#endif
+
+            // Video tracks
+            if (tag.startsWith("ID_VID_") && splitIndexedTag(tag, 7, &ID, &field) &&
+                    ((field == "LANG") || (field == "NAME"))) {
+                QString lang = decodeOutput(value);
+                LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Video: ID: %d, Lang: '%s' Type: '%s'",
+                       ID, lang.toUtf8().data(), field.constData());
+
+                if (field == "NAME")
+                    md.videos.addName(ID, lang);
+                else
+                    md.videos.addLang(ID, lang);
+            } else
+
+                // Chapters
+                if (tag.startsWith("ID_CHAPTER_") && splitIndexedTag(tag, 11, &ID, &field)) {
+                    if (field == "NAME") {
+                        QString s = decodeOutput(value);
+                        LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: mkv chapters: ID %d, NAME %s", ID, s.toUtf8().data());
+
+                        if (!md.chapters_name.contains(ID))
+                            md.chapters_name.insert(ID, s);
+                    } else if ((field == "START") && startsWithDigit(value)) {
+                        int64_t timestamp = value.toLongLong();
+                        LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: mkv chapters: ID %d, START %" PRId64, ID, timestamp);
+
+                        if (!md.chapters_timestamp.contains(ID))
+                            md.chapters_timestamp.insert(ID, timestamp);
+                    }
+                } else
+
+                    // VCD titles
+                    if (tag.startsWith("ID_VCD_TRACK_") && splitIndexedTag(tag, 13, &ID, &field) && (field == "MSF")) {
+                        md.titles.addName(ID, decodeOutput(value));
+                    } else
+
+                        // Audio CD titles
+                        if (tag.startsWith("ID_CDDA_TRACK_") && splitIndexedTag(tag, 14, &ID, &field) && (field == "MSF")) {
+                            // Format is mm:ss:ff
+                            QList<QByteArray> msf = value.split(':');
+                            double duration = 0;
+
+                            if (msf.count() >= 3) {
+                                duration = msf[0].toInt() * 60;
+                                duration += msf[1].toInt();
+                            }
+
+                            md.titles.addID(ID);
+                            md.titles.addDuration(ID, duration);
+                        } else
+
+                            // DVD titles
+                            if (tag.startsWith("ID_DVD_TITLE_") && splitIndexedTag(tag, 13, &ID, &field)) {
+                                if (field == "LENGTH") {
+                                    double length = value.toDouble();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Title: ID: %d, Length: '%f'", ID, length);
+                                    md.titles.addDuration(ID, length);
+                                } else if (field == "CHAPTERS") {
+                                    int chapters = value.toInt();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Title: ID: %d, Chapters: '%d'", ID, chapters);
+                                    md.titles.addChapters(ID, chapters);
+                                } else if (field == "ANGLES") {
+                                    int angles = value.toInt();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: Title: ID: %d, Angles: '%d'", ID, angles);
+                                    md.titles.addAngles(ID, angles);
+                                }
+                            } else
+
+                                // Video
+                                if (tag == "ID_VIDEO_ID") {
+                                    ID = value.toInt();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: ID_VIDEO_ID: %d", ID);
+                                    md.videos.addID(ID);
+                                } else if (tag == "ID_LENGTH") {
+                                    md.duration = value.toDouble();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: md.duration set to %f", md.duration);
+                                } else if (tag == "ID_VIDEO_WIDTH") {
+                                    md.video_width = value.toInt();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: md.video_width set to %d", md.video_width);
+                                } else if (tag == "ID_VIDEO_HEIGHT") {
+                                    md.video_height = value.toInt();
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: md.video_height set to %d", md.video_height);
+                                } else if (tag == "ID_VIDEO_ASPECT") {
+                                    md.video_aspect = value.toDouble();
+
+                                    if (md.video_aspect == 0.0) {
+                                        // I hope width & height are already set.
+                                        md.video_aspect = (double) md.video_width / md.video_height;
+                                    }
+
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: md.video_aspect set to %f", md.video_aspect);
+                                } else if (tag == "ID_DVD_DISC_ID") {
+                                    md.dvd_id = decodeOutput(value);
+                                    LOG_DEBUG(Log::Process, "MplayerProcess::parseIdLine: md.dvd_id set to '%s'", md.dvd_id.toUtf8().data());
+                                } else if (tag == "ID_DEMUXER") {
+                                    md.demuxer = decodeOutput(value);
+                                } else if (tag == "ID_VIDEO_FORMAT") {
+                                    md.video_format = decodeOutput(value);
+                                } else if (tag == "ID_AUDIO_FORMAT") {
+                                    md.audio_format = decodeOutput(value);
+                                } else if (tag == "ID_VIDEO_BITRATE") {
+                                    md.video_bitrate = value.toInt();
+                                } else if (tag == "ID_VIDEO_FPS") {
+                                    md.video_fps = decodeOutput(value);
+                                } else if (tag == "ID_AUDIO_BITRATE") {
+                                    md.audio_bitrate = value.toInt();
+                                } else if (tag == "ID_AUDIO_RATE") {
+                                    md.audio_rate = value.toInt();
+                                } else if (tag == "ID_AUDIO_NCH") {
+                                    md.audio_nch = value.toInt();
+                                } else if (tag == "ID_VIDEO_CODEC") {
+                                    md.video_codec = decodeOutput(value);
+                                } else if (tag == "ID_AUDIO_CODEC") {
+                                    md.audio_codec = decodeOutput(value);
+                                } else if (tag == "ID_CHAPTERS") {
+                                    md.chapters = value.toInt();
+                                } else if (tag == "ID_DVD_CURRENT_TITLE") {
+                                    dvd_current_title = value.toInt();
+                                }
+}
+
+void MplayerProcess::parseAnswerLine(const QByteArray &ba)
+{
 #if DVDNAV_SUPPORT
 
-        if (rx_dvdnav_switch_title.indexIn(line) > -1) {
-            int title = rx_dvdnav_switch_title.cap(1).toInt();
-            qDebug("MplayerProcess::parseLine: dvd title: %d", title);
-            emit receivedDVDTitle(title);
+    if (ba.startsWith("ANS_length=")) {
+        double length = ba.mid(11).toDouble();
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseAnswerLine: length: %f", length);
+
+        if (length != md.duration) {
+            md.duration = length;
+            emit receivedDuration(length);
         }
+    }
 
-        if (rx_dvdnav_length.indexIn(line) > -1) {
-            double length = rx_dvdnav_length.cap(1).toDouble();
-            qDebug("MplayerProcess::parseLine: length: %f", length);
+#endif
 
-            if (length != md.duration) {
-                md.duration = length;
-                emit receivedDuration(length);
-            }
-        }
+    if (ba.startsWith("ANS_chapter=")) {
+        int id = ba.mid(12).toInt();
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseAnswerLine: chapter: %d", id);
+        emit receivedCurrentChapter(id);
+    }
+}
 
-        if (rx_dvdnav_title_is_menu.indexIn(line) > -1) {
-            emit receivedTitleIsMenu();
+void MplayerProcess::parseVOLine(const QByteArray &ba)
+{
+    // Window resolution: "VO: [name] 640x480 => 640x480 ..."
+    if (!ba.startsWith("VO: [")) return;
+
+    int end = ba.indexOf("] ", 5);
+
+    if (end == -1) return;
+
+    int arrow = ba.indexOf(" => ", end + 2);
+
+    if (arrow == -1) return;
+
+    int sep = ba.indexOf('x', arrow + 4);
+
+    if (sep == -1) return;
+
+    int n = sep + 1;
+
+    while ((n < ba.size()) && (ba.at(n) >= '0') && (ba.at(n) <= '9')) n++;
+
+    bool ok_w, ok_h;
+    int w = ba.mid(arrow + 4, sep - arrow - 4).toInt(&ok_w);
+    int h = ba.mid(sep + 1, n - sep - 1).toInt(&ok_h);
+
+    if (!ok_w || !ok_h) return;
+
+    emit receivedVO(decodeOutput(ba.mid(5, end - 5)));
+    emit receivedWindowResolution(w, h);
+}
+
+void MplayerProcess::parseMkvLine(const QByteArray &ba)
+{
+    if (notified_mplayer_is_running) return;
+
+    // "[mkv] Found 2 editions, will play #1"
+    if (ba.startsWith("[mkv] Found ")) {
+        int end = ba.indexOf(" editions, will play #", 12);
+
+        if (end > -1) {
+            int editions = ba.mid(12, end - 12).toInt();
+            int playing = ba.mid(end + 22).toInt();
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseMkvLine: mkv editions: %d", editions);
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseMkvLine: current edition: %d", playing);
+            md.editions = editions;
+            emit receivedCurrentEdition(playing);
         }
+    }
+}
 
-        if (rx_dvdnav_title_is_movie.indexIn(line) > -1) {
-            emit receivedTitleIsMovie();
+void MplayerProcess::parseOtherLine(const QByteArray &ba, const QString &line)
+{
+    // In idle mode mplayer doesn't exit at the end of the file,
+    // this (verbose) message is the only way to know it
+    if (idle_mode && ba.startsWith("EOF code:")) {
+        int code = ba.mid(9).trimmed().toInt();
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: EOF code: %d", code);
+
+        if (replacing_file) {
+            // The previous file has been closed by loadfile
+            replacing_file = false;
+        } else if (code == 1) {
+            flushPosition();
+
+            if (!notified_mplayer_is_running) {
+                emit mplayerFullyLoaded();
+            }
+
+            emit receivedEndOfFile();
         }
 
-#endif
+        return;
+    }
 
-        if (rx_chapter.indexIn(line) > -1) {
-            int id = rx_chapter.cap(1).toInt();
-            qDebug("MplayerProcess::parseLine: chapter: %d", id);
-            emit receivedCurrentChapter(id);
+    // Screenshot
+    if (ba.startsWith("*** screenshot '")) {
+        int end = ba.lastIndexOf('\'');
+
+        if (end > 15) {
+            QString shot = decodeOutput(ba.mid(16, end - 16));
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: screenshot: '%s'", shot.toUtf8().data());
+            emit receivedScreenshot(shot);
         }
+    } else
 
-        // The following things are not sent when the file has started to play
-        // (or if sent, smplayer2 will ignore anyway...)
-        // So not process anymore, if video is playing to save some time
-        if (notified_mplayer_is_running) {
-            return;
+        // End of file
+        if (ba.startsWith("Exiting... (End of file)")) {
+            endOfFileDetected();
         }
 
-#if !NOTIFY_SUB_CHANGES
+#if !CHECK_VIDEO_CODEC_FOR_NO_VIDEO
+        else
 
-        // Subtitles
-        if (rx_subtitle.indexIn(line) > -1) {
-            md.subs.parse(line);
-        } else if (rx_sid.indexIn(line) > -1) {
-            md.subs.parse(line);
-        } else if (rx_subtitle_file.indexIn(line) > -1) {
-            md.subs.parse(line);
-        }
+            // No video
+            if (ba.startsWith("Video: no video")) {
+                md.novideo = TRUE;
+                emit receivedNoVideo();
+            }
 
 #endif
 
-        // AO
-        if (rx_ao.indexIn(line) > -1) {
-            emit receivedAO(rx_ao.cap(1));
-        } else
+    // Stream title
+    if (ba.contains("StreamTitle='")) {
+        if (rx_stream_title_and_url.indexIn(line) > -1) {
+            QString s = rx_stream_title_and_url.cap(1);
+            QString url = rx_stream_title_and_url.cap(2);
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: stream_title: '%s'", s.toUtf8().data());
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: stream_url: '%s'", url.toUtf8().data());
+            md.stream_title = s;
+            md.stream_url = url;
+            emit receivedStreamTitleAndUrl(s, url);
+        } else if (rx_stream_title.indexIn(line) > -1) {
+            QString s = rx_stream_title.cap(1);
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: stream_title: '%s'", s.toUtf8().data());
+            md.stream_title = s;
+            emit receivedStreamTitle(s);
+        }
+    }
 
-#if !NOTIFY_AUDIO_CHANGES
+#if DVDNAV_SUPPORT
 
-            // Matroska audio
-            if (rx_audio_mat.indexIn(line) > -1) {
-                int ID = rx_audio_mat.cap(1).toInt();
-                QString lang = rx_audio_mat.cap(3);
-                QString t = rx_audio_mat.cap(2);
-                qDebug("MplayerProcess::parseLine: Audio: ID: %d, Lang: '%s' Type: '%s'",
-                       ID, lang.toUtf8().data(), t.toUtf8().data());
+    if (ba.startsWith("DVDNAV")) {
+        if (rx_dvdnav_switch_title.indexIn(line) > -1) {
+            int title = rx_dvdnav_switch_title.cap(1).toInt();
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: dvd title: %d", title);
+            emit receivedDVDTitle(title);
+        } else if (ba.startsWith("DVDNAV_TITLE_IS_MENU")) {
+            emit receivedTitleIsMenu();
+        } else if (ba.startsWith("DVDNAV_TITLE_IS_MOVIE")) {
+            emit receivedTitleIsMovie();
+        }
+    }
 
-                if (t == "NAME")
-                    md.audios.addName(ID, lang);
-                else
-                    md.audios.addLang(ID, lang);
-            } else
 #endif
 
+    // The following things are not sent when the file has started to play
+    // (or if sent, smplayer2 will ignore anyway...)
+    // So not process anymore, if video is playing to save some time
+    if (notified_mplayer_is_running) {
+        return;
+    }
+
 #if PROGRAM_SWITCH
 
-                // Program
-                if (rx_program.indexIn(line) > -1) {
-                    int ID = rx_program.cap(1).toInt();
-                    qDebug("MplayerProcess::parseLine: Program: ID: %d", ID);
-                    md.programs.addID(ID);
-                } else
+    // Program
+    if (rx_program.indexIn(line) > -1) {
+        int ID = rx_program.cap(1).toInt();
+        LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: Program: ID: %d", ID);
+        md.programs.addID(ID);
+    } else
 #endif
 
-                    // Video tracks
-                    if (rx_video.indexIn(line) > -1) {
-                        int ID = rx_video.cap(1).toInt();
-                        QString lang = rx_video.cap(3);
-                        QString t = rx_video.cap(2);
-                        qDebug("MplayerProcess::parseLine: Video: ID: %d, Lang: '%s' Type: '%s'",
-                               ID, lang.toUtf8().data(), t.toUtf8().data());
-
-                        if (t == "NAME")
-                            md.videos.addName(ID, lang);
-                        else
-                            md.videos.addLang(ID, lang);
-                    } else
+        // Catch cache messages
+        if (ba.startsWith("Cache fill:")) {
+            emit receivedCacheMessage(line);
+        } else
 
-                        if (rx_mkvchapters_name.indexIn(line) > -1) {
-                            int id = rx_mkvchapters_name.cap(1).toInt();
-                            QString s = rx_mkvchapters_name.cap(2);
-                            qDebug("MplayerProcess::parseLine: mkv chapters: ID %d, NAME %s", id, s.toUtf8().data());
+            // Creating index
+            if (ba.startsWith("Generating Index:")) {
+                emit receivedCreatingIndex(line);
+            } else
 
-                            if (!md.chapters_name.contains(id))
-                                md.chapters_name.insert(id, s);
-                        } else
+                // Catch connecting message
+                if (ba.startsWith("Connecting to ")) {
+                    emit receivedConnectingToMessage(line);
+                } else
+
+                    // Catch resolving message
+                    if (ba.startsWith("Resolving ")) {
+                        emit receivedResolvingMessage(line);
+                    } else
 
-                            if (rx_mkvchapters_timestamp.indexIn(line) > -1) {
-                                int id = rx_mkvchapters_timestamp.cap(1).toInt();
-                                int64_t timestamp = rx_mkvchapters_timestamp.cap(2).toLongLong();
-                                qDebug("MplayerProcess::parseLine: mkv chapters: ID %d, START %" PRId64, id, timestamp);
+                        // Aspect ratio for old versions of mplayer
+                        if (rx_aspect2.indexIn(line) > -1) {
+                            md.video_aspect = rx_aspect2.cap(1).toDouble();
+                            LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: md.video_aspect set to %f", md.video_aspect);
+                        } else
 
-                                if (!md.chapters_timestamp.contains(id))
-                                    md.chapters_timestamp.insert(id, timestamp);
+                            // Clip info
+                            if (ba.startsWith(' ') && parseClipInfo(line)) {
+                                // Nothing more to do
                             } else
 
-                                if (rx_mkveditions.indexIn(line) > -1) {
-                                    int editions = rx_mkveditions.cap(1).toInt();
-                                    int playing = rx_mkveditions.cap(2).toInt();
-                                    qDebug("MplayerProcess::parseLine: mkv editions: %d", editions);
-                                    qDebug("MplayerProcess::parseLine: current edition: %d", playing);
-                                    md.editions = editions;
-                                    emit receivedCurrentEdition(playing);
-                                } else
-
-                                    // VCD titles
-                                    if (rx_vcd.indexIn(line) > -1) {
-                                        int ID = rx_vcd.cap(1).toInt();
-                                        QString length = rx_vcd.cap(2);
-                                        //md.titles.addID( ID );
-                                        md.titles.addName(ID, length);
-                                    } else
-
-                                        // Audio CD titles
-                                        if (rx_cdda.indexIn(line) > -1) {
-                                            int ID = rx_cdda.cap(1).toInt();
-                                            QString length = rx_cdda.cap(2);
-                                            double duration = 0;
-                                            QRegExp r("(\\d+):(\\d+):(\\d+)");
-
-                                            if (r.indexIn(length) > -1) {
-                                                duration = r.cap(1).toInt() * 60;
-                                                duration += r.cap(2).toInt();
-                                            }
-
-                                            md.titles.addID(ID);
-                                            /*
-                                            QString name = QString::number(ID) + " (" + length + ")";
-                                            md.titles.addName( ID, name );
-                                            */
-                                            md.titles.addDuration(ID, duration);
-                                        } else
-
-                                            // DVD titles
-                                            if (rx_title.indexIn(line) > -1) {
-                                                int ID = rx_title.cap(1).toInt();
-                                                QString t = rx_title.cap(2);
-
-                                                if (t == "LENGTH") {
-                                                    double length = rx_title.cap(3).toDouble();
-                                                    qDebug("MplayerProcess::parseLine: Title: ID: %d, Length: '%f'", ID, length);
-                                                    md.titles.addDuration(ID, length);
-                                                } else if (t == "CHAPTERS") {
-                                                    int chapters = rx_title.cap(3).toInt();
-                                                    qDebug("MplayerProcess::parseLine: Title: ID: %d, Chapters: '%d'", ID, chapters);
-                                                    md.titles.addChapters(ID, chapters);
-                                                } else if (t == "ANGLES") {
-                                                    int angles = rx_title.cap(3).toInt();
-                                                    qDebug("MplayerProcess::parseLine: Title: ID: %d, Angles: '%d'", ID, angles);
-                                                    md.titles.addAngles(ID, angles);
-                                                }
-                                            } else
-
-                                                // Catch cache messages
-                                                if (rx_cache.indexIn(line) > -1) {
-                                                    emit receivedCacheMessage(line);
-                                                } else
-
-                                                    // Creating index
-                                                    if (rx_create_index.indexIn(line) > -1) {
-                                                        emit receivedCreatingIndex(line);
-                                                    } else
-
-                                                        // Catch connecting message
-                                                        if (rx_connecting.indexIn(line) > -1) {
-                                                            emit receivedConnectingToMessage(line);
-                                                        } else
-
-                                                            // Catch resolving message
-                                                            if (rx_resolving.indexIn(line) > -1) {
-                                                                emit receivedResolvingMessage(line);
-                                                            } else
-
-                                                                // Aspect ratio for old versions of mplayer
-                                                                if (rx_aspect2.indexIn(line) > -1) {
-                                                                    md.video_aspect = rx_aspect2.cap(1).toDouble();
-                                                                    qDebug("MplayerProcess::parseLine: md.video_aspect set to %f", md.video_aspect);
-                                                                } else
-
-                                                                    // Clip info
-
-                                                                    //QString::trimmed() is used for removing leading and trailing whitespaces
-                                                                    //Some .mp3 files contain tags with starting and ending whitespaces
-                                                                    //Unfortunately MPlayer gives us leading and trailing whitespaces, Winamp for example doesn't show them
-
-                                                                    // Name
-                                                                    if (rx_clip_name.indexIn(line) > -1) {
-                                                                        QString s = rx_clip_name.cap(2).trimmed();
-                                                                        qDebug("MplayerProcess::parseLine: clip_name: '%s'", s.toUtf8().data());
-                                                                        md.clip_name = s;
-                                                                    } else
-
-                                                                        // Artist
-                                                                        if (rx_clip_artist.indexIn(line) > -1) {
-                                                                            QString s = rx_clip_artist.cap(1).trimmed();
-                                                                            qDebug("MplayerProcess::parseLine: clip_artist: '%s'", s.toUtf8().data());
-                                                                            md.clip_artist = s;
-                                                                        } else
-
-                                                                            // Author
-                                                                            if (rx_clip_author.indexIn(line) > -1) {
-                                                                                QString s = rx_clip_author.cap(1).trimmed();
-                                                                                qDebug("MplayerProcess::parseLine: clip_author: '%s'", s.toUtf8().data());
-                                                                                md.clip_author = s;
-                                                                            } else
-
-                                                                                // Album
-                                                                                if (rx_clip_album.indexIn(line) > -1) {
-                                                                                    QString s = rx_clip_album.cap(1).trimmed();
-                                                                                    qDebug("MplayerProcess::parseLine: clip_album: '%s'", s.toUtf8().data());
-                                                                                    md.clip_album = s;
-                                                                                } else
-
-                                                                                    // Genre
-                                                                                    if (rx_clip_genre.indexIn(line) > -1) {
-                                                                                        QString s = rx_clip_genre.cap(1).trimmed();
-                                                                                        qDebug("MplayerProcess::parseLine: clip_genre: '%s'", s.toUtf8().data());
-                                                                                        md.clip_genre = s;
-                                                                                    } else
-
-                                                                                        // Date
-                                                                                        if (rx_clip_date.indexIn(line) > -1) {
-                                                                                            QString s = rx_clip_date.cap(2).trimmed();
-                                                                                            qDebug("MplayerProcess::parseLine: clip_date: '%s'", s.toUtf8().data());
-                                                                                            md.clip_date = s;
-                                                                                        } else
-
-                                                                                            // Track
-                                                                                            if (rx_clip_track.indexIn(line) > -1) {
-                                                                                                QString s = rx_clip_track.cap(1).trimmed();
-                                                                                                qDebug("MplayerProcess::parseLine: clip_track: '%s'", s.toUtf8().data());
-                                                                                                md.clip_track = s;
-                                                                                            } else
-
-                                                                                                // Copyright
-                                                                                                if (rx_clip_copyright.indexIn(line) > -1) {
-                                                                                                    QString s = rx_clip_copyright.cap(1).trimmed();
-                                                                                                    qDebug("MplayerProcess::parseLine: clip_copyright: '%s'", s.toUtf8().data());
-                                                                                                    md.clip_copyright = s;
-                                                                                                } else
-
-                                                                                                    // Comment
-                                                                                                    if (rx_clip_comment.indexIn(line) > -1) {
-                                                                                                        QString s = rx_clip_comment.cap(1).trimmed();
-                                                                                                        qDebug("MplayerProcess::parseLine: clip_comment: '%s'", s.toUtf8().data());
-                                                                                                        md.clip_comment = s;
-                                                                                                    } else
-
-                                                                                                        // Software
-                                                                                                        if (rx_clip_software.indexIn(line) > -1) {
-                                                                                                            QString s = rx_clip_software.cap(1).trimmed();
-                                                                                                            qDebug("MplayerProcess::parseLine: clip_software: '%s'", s.toUtf8().data());
-                                                                                                            md.clip_software = s;
-                                                                                                        } else
-
-                                                                                                            if (rx_fontcache.indexIn(line) > -1) {
-                                                                                                                //qDebug("MplayerProcess::parseLine: updating font cache");
-                                                                                                                emit receivedUpdatingFontCache();
-                                                                                                            } else if (rx_scanning_font.indexIn(line) > -1) {
-                                                                                                                emit receivedScanningFont(line.trimmed());
-                                                                                                            } else
-
-                                                                                                                // Catch starting message
-                                                                                                                /*
-                                                                                                                pos = rx_play.indexIn(line);
-                                                                                                                if (pos > -1) {
-                                                                                                                	emit mplayerFullyLoaded();
-                                                                                                                }
-                                                                                                                */
-
-                                                                                                                //Generic things
-                                                                                                                if (rx.indexIn(line) > -1) {
-                                                                                                                    tag = rx.cap(1);
-                                                                                                                    value = rx.cap(2);
-                                                                                                                    //qDebug("MplayerProcess::parseLine: tag: %s, value: %s", tag.toUtf8().data(), value.toUtf8().data());
+                                if (rx_fontcache.indexIn(line) > -1) {
+                                    //LOG_DEBUG(Log::Process, "MplayerProcess::parseOtherLine: updating font cache");
+                                    emit receivedUpdatingFontCache();
+                                } else if (rx_scanning_font.indexIn(line) > -1) {
+                                    emit receivedScanningFont(line.trimmed());
+                                }
+}
 
-#if !NOTIFY_AUDIO_CHANGES
+//! Parses the clip info lines (" Title: something").
+//! Returns true if the line was a known tag.
+bool MplayerProcess::parseClipInfo(const QString &line)
+{
+    int colon = line.indexOf(": ");
 
-                                                                                                                    // Generic audio
-                                                                                                                    if (tag == "ID_AUDIO_ID") {
-                                                                                                                        int ID = value.toInt();
-                                                                                                                        qDebug("MplayerProcess::parseLine: ID_AUDIO_ID: %d", ID);
-                                                                                                                        md.audios.addID(ID);
-                                                                                                                    } else
-#endif
+    if (colon < 2) return false;
+
+    QString name = line.mid(1, colon - 1);
 
-                                                                                                                        // Video
-                                                                                                                        if (tag == "ID_VIDEO_ID") {
-                                                                                                                            int ID = value.toInt();
-                                                                                                                            qDebug("MplayerProcess::parseLine: ID_VIDEO_ID: %d", ID);
-                                                                                                                            md.videos.addID(ID);
-                                                                                                                        } else if (tag == "ID_LENGTH") {
-                                                                                                                            md.duration = value.toDouble();
-                                                                                                                            qDebug("MplayerProcess::parseLine: md.duration set to %f", md.duration);
-                                                                                                                        } else if (tag == "ID_VIDEO_WIDTH") {
-                                                                                                                            md.video_width = value.toInt();
-                                                                                                                            qDebug("MplayerProcess::parseLine: md.video_width set to %d", md.video_width);
-                                                                                                                        } else if (tag == "ID_VIDEO_HEIGHT") {
-                                                                                                                            md.video_height = value.toInt();
-                                                                                                                            qDebug("MplayerProcess::parseLine: md.video_height set to %d", md.video_height);
-                                                                                                                        } else if (tag == "ID_VIDEO_ASPECT") {
-                                                                                                                            md.video_aspect = value.toDouble();
-
-                                                                                                                            if (md.video_aspect == 0.0) {
-                                                                                                                                // I hope width & height are already set.
-                                                                                                                                md.video_aspect = (double) md.video_width / md.video_height;
-                                                                                                                            }
-
-                                                                                                                            qDebug("MplayerProcess::parseLine: md.video_aspect set to %f", md.video_aspect);
-                                                                                                                        } else if (tag == "ID_DVD_DISC_ID") {
-                                                                                                                            md.dvd_id = value;
-                                                                                                                            qDebug("MplayerProcess::parseLine: md.dvd_id set to '%s'", md.dvd_id.toUtf8().data());
-                                                                                                                        } else if (tag == "ID_DEMUXER") {
-                                                                                                                            md.demuxer = value;
-                                                                                                                        } else if (tag == "ID_VIDEO_FORMAT") {
-                                                                                                                            md.video_format = value;
-                                                                                                                        } else if (tag == "ID_AUDIO_FORMAT") {
-                                                                                                                            md.audio_format = value;
-                                                                                                                        } else if (tag == "ID_VIDEO_BITRATE") {
-                                                                                                                            md.video_bitrate = value.toInt();
-                                                                                                                        } else if (tag == "ID_VIDEO_FPS") {
-                                                                                                                            md.video_fps = value;
-                                                                                                                        } else if (tag == "ID_AUDIO_BITRATE") {
-                                                                                                                            md.audio_bitrate = value.toInt();
-                                                                                                                        } else if (tag == "ID_AUDIO_RATE") {
-                                                                                                                            md.audio_rate = value.toInt();
-                                                                                                                        } else if (tag == "ID_AUDIO_NCH") {
-                                                                                                                            md.audio_nch = value.toInt();
-                                                                                                                        } else if (tag == "ID_VIDEO_CODEC") {
-                                                                                                                            md.video_codec = value;
-                                                                                                                        } else if (tag == "ID_AUDIO_CODEC") {
-                                                                                                                            md.audio_codec = value;
-                                                                                                                        } else if (tag == "ID_CHAPTERS") {
-                                                                                                                            md.chapters = value.toInt();
-                                                                                                                        } else if (tag == "ID_DVD_CURRENT_TITLE") {
-                                                                                                                            dvd_current_title = value.toInt();
-                                                                                                                        }
-                                                                                                                }
+    for (unsigned int n = 0; n < sizeof(clip_info_tags) / sizeof(ClipInfoTag); n++) {
+        if (name.compare(QLatin1String(clip_info_tags[n].name), Qt::CaseInsensitive) == 0) {
+            //QString::trimmed() is used for removing leading and trailing whitespaces
+            //Some .mp3 files contain tags with starting and ending whitespaces
+            //Unfortunately MPlayer gives us leading and trailing whitespaces, Winamp for example doesn't show them
+            QString s = line.mid(colon + 2).trimmed();
+            LOG_DEBUG(Log::Process, "MplayerProcess::parseClipInfo: clip_%s: '%s'", clip_info_tags[n].name, s.toUtf8().data());
+            md.*(clip_info_tags[n].field) = s;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MplayerProcess::endOfFileDetected()
+{
+    LOG_DEBUG(Log::Process, "MplayerProcess::endOfFileDetected");
+
+    flushPosition();
+
+    if (!received_end_of_file) {
+        // In case of playing VCDs or DVDs, maybe the first title
+        // is not playable, so the GUI doesn't get the info about
+        // available titles. So if we received the end of file
+        // first let's pretend the file has started so the GUI can have
+        // the data.
+        if (!notified_mplayer_is_running) {
+            emit mplayerFullyLoaded();
+        }
+
+        //emit receivedEndOfFile();
+        // Send signal once the process is finished, not now!
+        received_end_of_file = true;
     }
 }
 
 // Called when the process is finished
 void MplayerProcess::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-    qDebug("MplayerProcess::processFinished: exitCode: %d, status: %d", exitCode, (int) exitStatus);
+    LOG_DEBUG(Log::Process, "MplayerProcess::processFinished: exitCode: %d, status: %d", exitCode, (int) exitStatus);
+
+    flushPosition();
+
     // Send this signal before the endoffile one, otherwise
     // the playlist will start to play next file before all
     // objects are notified that the process has exited.
@@ -778,5 +946,5 @@ void MplayerProcess::processFinished(int exitCode, QProcess::ExitStatus exitStat
 
 void MplayerProcess::gotError(QProcess::ProcessError error)
 {
-    qDebug("MplayerProcess::gotError: %d", (int) error);
+    LOG_DEBUG(Log::Process, "MplayerProcess::gotError: %d", (int) error);
 }
@@ -20,6 +20,7 @@
 #define _MPLAYERPROCESS_H_
 
 #include <QString>
+#include <QTimer>
 #include "myprocess.h"
 #include "mediadata.h"
 #include "config.h"
@@ -41,6 +42,11 @@ public:
     bool start();
     void writeToStdin(QString text);
 
+    //! Forgets the info of the current file. To be called just before
+    //! a new file is loaded in the running process with loadfile.
+    //! \a closing_file must be true if a file is still open (not idle).
+    void prepareNewFile(bool closing_file);
+
     MediaData mediaData() {
         return md;
     };
@@ -60,6 +66,8 @@ signals:
     void receivedAO(QString);
     void receivedEndOfFile();
     void mplayerFullyLoaded();
+    //! The first ID_ line of a file has been received
+    void receivedFirstIdLine();
     void receivedStartingTime(double sec);
 
     void receivedCacheMessage(QString);
@@ -94,14 +102,44 @@ signals:
     void receivedTitleIsMovie();
 #endif
 
+public slots:
+    //! Sends the latest playback position right away, if there's one
+    //! waiting. The next position will also be sent immediately.
+    void flushPosition();
+
 protected slots:
     void parseLine(QByteArray ba);
+    void publishPosition();
     void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void gotError(QProcess::ProcessError);
 
 private:
+    //! parseLine() dispatches each line by its prefix to one of these
+    bool parseStatusLine(const QByteArray &ba);
+    void parseIdLine(const QByteArray &ba, const QString &line);
+    void parseAnswerLine(const QByteArray &ba);
+    void parseVOLine(const QByteArray &ba);
+    void parseMkvLine(const QByteArray &ba);
+    void parseOtherLine(const QByteArray &ba, const QString &line);
+    bool parseClipInfo(const QString &line);
+
+    void endOfFileDetected();
+
+    //! Keeps the position of the status line and sends it at most
+    //! pref->position_update_rate times per second
+    void queuePosition(double sec, int frame);
+
+    void resetFileInfo();
+
     bool notified_mplayer_is_running;
     bool received_end_of_file;
+    bool received_id_line;
+
+    //! True if mplayer has been started with -idle, so it doesn't exit
+    //! at the end of the file
+    bool idle_mode;
+    //! True until the previous file has been closed after a loadfile
+    bool replacing_file;
 
     MediaData md;
 
@@ -120,6 +158,11 @@ private:
 #endif
 
     int dvd_current_title;
+
+    QTimer position_timer;
+    bool position_pending;
+    double pending_sec;
+    int pending_frame;
 };
 
 
@@ -18,6 +18,7 @@
 
 #include "myprocess.h"
 #include <cinttypes>
+#include <cstring>
 
 #ifdef Q_OS_WIN
 
@@ -34,6 +35,10 @@
 
 MyProcess::MyProcess(QObject *parent) : QProcess(parent)
 {
+    output_size = 0;
+    reading_output = false;
+    output_reset = false;
+
     clearArguments();
     setProcessChannelMode(QProcess::MergedChannels);
 
@@ -86,7 +91,9 @@ QStringList MyProcess::arguments()
 
 void MyProcess::start()
 {
-    remaining_output.clear();
+    output_size = 0;
+    output_reset = true;
+    queued_output.clear();
 
     QProcess::start(program, arg);
 
@@ -100,7 +107,19 @@ void MyProcess::start()
 
 void MyProcess::readStdOut()
 {
-    genericRead(readAllStandardOutput());
+    if (reading_output) {
+        queued_output += readAllStandardOutput();
+        return;
+    }
+
+    qint64 available = bytesAvailable();
+
+    if (available <= 0) return;
+
+    // Read straight into the line buffer, no need for a temporary QByteArray
+    qint64 r = read(outputSpace((int) available), available);
+
+    if (r > 0) splitLines((int) r);
 }
 
 
@@ -109,59 +128,81 @@ void MyProcess::readTmpFile()
     genericRead(temp_file.readAll());
 }
 
-void MyProcess::genericRead(QByteArray buffer)
+void MyProcess::genericRead(const QByteArray &buffer)
 {
-    QByteArray ba = remaining_output + buffer;
-    int start = 0;
-    int from_pos = 0;
-    int pos = isLine(ba, from_pos);
-
-    //qDebug("MyProcess::read: pos: %d", pos);
-    while (pos > -1) {
-        // Readline
-        //QByteArray line = ba.left(pos);
-        QByteArray line = ba.mid(start, pos - start);
-        //ba = ba.mid(pos+1);
-        from_pos = pos + 1;
-#ifdef Q_OS_WIN
+    if (buffer.isEmpty()) return;
 
-        if ((from_pos < ba.size()) && (ba.at(from_pos) == '\n')) from_pos++;
+    if (reading_output) {
+        queued_output += buffer;
+        return;
+    }
 
-#endif
-        start = from_pos;
+    memcpy(outputSpace(buffer.size()), buffer.constData(), buffer.size());
+    splitLines(buffer.size());
+}
 
-        emit lineAvailable(line);
+char *MyProcess::outputSpace(int size)
+{
+    int needed = output_size + size;
 
-        pos = isLine(ba, from_pos);
+    if (needed > output_buffer.size()) {
+        output_buffer.resize(qMax(needed, output_buffer.size() * 2));
     }
 
-    remaining_output = ba.mid(from_pos);
+    return output_buffer.data() + output_size;
 }
 
-int MyProcess::isLine(const QByteArray &ba, int from)
+void MyProcess::splitLines(int new_bytes)
 {
-    int pos1 = ba.indexOf('\n', from);
-    int pos2 = ba.indexOf('\r', from);
+    reading_output = true;
+    output_reset = false;
+
+    while (true) {
+        char *data = output_buffer.data();
+        int end = output_size + new_bytes;
+        int start = 0;
+
+        // Only the new data has to be scanned: the incomplete line kept
+        // from the previous read doesn't have any terminator
+        for (int pos = output_size; pos < end; pos++) {
+            if ((data[pos] != '\n') && (data[pos] != '\r')) continue;
+
+            // Lines are handed out as views into the buffer, without copying them
+            emit lineAvailable(QByteArray::fromRawData(data + start, pos - start));
+
+            if (output_reset) {
+                // start() was called from a slot, the rest of the output is stale
+                output_size = 0;
+                reading_output = false;
+                return;
+            }
+
+            start = pos + 1;
+#ifdef Q_OS_WIN
+
+            if ((start < end) && (data[start] == '\n')) {
+                start++;
+                pos++;
+            }
 
-    //qDebug("MyProcess::isLine: pos2: %d", pos2);
+#endif
+        }
 
-    if ((pos1 == -1) && (pos2 == -1)) return -1;
+        // Move the incomplete line to the beginning of the buffer
+        output_size = end - start;
 
-    int pos = pos1;
+        if ((start > 0) && (output_size > 0)) memmove(data, data + start, output_size);
 
-    if ((pos1 != -1) && (pos2 != -1)) {
-        /*
-        if (pos2 == (pos1+1)) pos = pos2; // \r\n
-        else
-        */
-        if (pos1 < pos2) pos = pos1;
-        else pos = pos2;
-    } else {
-        if (pos1 == -1) pos = pos2;
-        else if (pos2 == -1) pos = pos1;
+        if (queued_output.isEmpty()) break;
+
+        // Process the output received while emitting the lines
+        QByteArray queued = queued_output;
+        queued_output.clear();
+        new_bytes = queued.size();
+        memcpy(outputSpace(new_bytes), queued.constData(), new_bytes);
     }
 
-    return pos;
+    reading_output = false;
 }
 
 /*!
@@ -54,6 +54,9 @@ public:
 
 signals:
     //! Emitted when there's a line available
+    /*! The line points into the internal buffer of MyProcess, so it's only
+        valid while the signal is being emitted. Receivers must be connected
+        with a direct connection and copy it if they need to keep it. */
     void lineAvailable(QByteArray ba);
 
 protected slots:
@@ -62,17 +65,25 @@ protected slots:
     void procFinished();		//!< Called when the process has finished
 
 protected:
-    //! Return true if it's possible to read an entire line.
-    /*! @param from specifies the position to begin. */
-    int isLine(const QByteArray &ba, int from = 0);
-    //! Called from readStdOut() and readTmpFile() to do all the work
-    void genericRead(QByteArray buffer);
+    //! Called from readTmpFile() to do all the work
+    void genericRead(const QByteArray &buffer);
+    //! Return a pointer to the buffer where \a size new bytes can be written
+    char *outputSpace(int size);
+    //! Split the \a new_bytes added to the buffer into lines and emit them
+    void splitLines(int new_bytes);
 
 private:
     QString program;
     QStringList arg;
 
-    QByteArray remaining_output;
+    //! Output of the process not yet emitted. Only the first output_size
+    //! bytes are valid, the rest is preallocated room for the next read.
+    QByteArray output_buffer;
+    int output_size;
+    //! Output received while lineAvailable() was being emitted
+    QByteArray queued_output;
+    bool reading_output;
+    bool output_reset;
 
     QTemporaryFile temp_file;
     QTimer timer;
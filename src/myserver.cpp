@@ -86,6 +86,7 @@ void Connection::parseLine(QString str)
         sendText(" view playlist");
         sendText(" view status");
         sendText(" view clip info");
+        sendText(" view startup times");
         sendText(" seek [position]");
         sendText(" get [action]");
         sendText(" get volume");
@@ -174,6 +175,11 @@ void Connection::parseLine(QString str)
         emit receivedViewClipInfo(&output);
         sendText(output);
 
+    } else if (str.toLower() == "view startup times") {
+        QString output = "";
+        emit receivedViewStartupTimes(&output);
+        sendText(output);
+
     } else if (rx_seek.indexIn(str) > -1) {
         qDebug("Connection::parseLine: asked to seek to %s", rx_seek.cap(1).toUtf8().data());
         emit receivedSeek(rx_seek.cap(1).toDouble());
@@ -223,6 +229,8 @@ void MyServer::newConnection_slot()
             this, SIGNAL(receivedViewStatus(QString *)));
     connect(c, SIGNAL(receivedViewClipInfo(QString *)),
             this, SIGNAL(receivedViewClipInfo(QString *)));
+    connect(c, SIGNAL(receivedViewStartupTimes(QString *)),
+            this, SIGNAL(receivedViewStartupTimes(QString *)));
     connect(c, SIGNAL(receivedSeek(double)),
             this, SIGNAL(receivedSeek(double)));
     connect(c, SIGNAL(receivedGetChecked(QString, QString *)),
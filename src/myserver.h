@@ -60,6 +60,7 @@ signals:
     void receivedViewPlaylist(QString *);
     void receivedViewStatus(QString *);
     void receivedViewClipInfo(QString *);
+    void receivedViewStartupTimes(QString *);
     void receivedSeek(double);
     void receivedGetChecked(QString, QString *);
     void receivedGetVolume(int *);
@@ -144,6 +145,10 @@ signals:
     //! Emitted when the client requests the clip info for the current track
     void receivedViewClipInfo(QString *);
 
+    //! Emitted when the client requests the time taken to open the last files
+    //! (and the number of restarts of mplayer2 avoided)
+    void receivedViewStartupTimes(QString *);
+
     //! Emitted when the client request the state of a checkable action
     void receivedGetChecked(QString, QString *);
 
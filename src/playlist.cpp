@@ -37,10 +37,17 @@
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QHeaderView>
+#include <QTableView>
+#include <QItemSelectionModel>
 #include <QTextCodec>
 #include <QApplication>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QXmlStreamWriter>
+#include <QVector>
+#include <QtAlgorithms>
 
-#include "mytablewidget.h"
+#include "playlistmodel.h"
 #include "myaction.h"
 #include "filedialog.h"
 #include "helper.h"
@@ -50,19 +57,20 @@
 #include "core.h"
 #include "extensions.h"
 #include "guiconfig.h"
+#include "directoryscanner.h"
+#include "playlistjournal.h"
+#include "playlistparser.h"
+#include "paths.h"
+#include "loglevels.h"
 
-#include <stdlib.h>
 
 #if USE_INFOPROVIDER
-#include "infoprovider.h"
+#include "infoscanner.h"
+#include "mediainfocache.h"
 #endif
 
 #define DRAG_ITEMS 0
 
-#define COL_PLAY 0
-#define COL_NAME 1
-#define COL_TIME 2
-
 using namespace Global;
 
 
@@ -84,15 +92,39 @@ Playlist::Playlist(Core *c, QWidget *parent, Qt::WindowFlags f)
     playlist_path = "";
     latest_dir = "";
 
+    info_scanner = 0;
+    start_play_pending = false;
+    scan_position = -1;
+    scan_position_known = false;
+    journal = 0;
+
     createTable();
     createActions();
     createToolbar();
+    createScanStatus();
+
+    dir_scanner = new DirectoryScanner(this);
+    connect(dir_scanner, SIGNAL(filesFound(QStringList)),
+            this, SLOT(directoryFilesFound(QStringList)));
+    connect(dir_scanner, SIGNAL(progress(int, int)),
+            this, SLOT(directoryScanProgress(int, int)));
+    connect(dir_scanner, SIGNAL(scanFinished()),
+            this, SLOT(directoryScanFinished()));
 
     connect(core, SIGNAL(mediaFinished()), this, SLOT(playNext()), Qt::QueuedConnection);
     connect(core, SIGNAL(mediaLoaded()), this, SLOT(getMediaInfo()));
 
+#if USE_INFOPROVIDER
+    info_scanner = new InfoScanner(this);
+    connect(info_scanner, SIGNAL(infoAvailable(QString, MediaData)),
+            this, SLOT(mediaInfoAvailable(QString, MediaData)));
+    connect(info_scanner, SIGNAL(filesMissing(QStringList)),
+            this, SLOT(filesMissing(QStringList)));
+#endif
+
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addWidget(listView);
+    layout->addWidget(scan_status);
     layout->addWidget(toolbar);
     setLayout(layout);
 
@@ -112,11 +144,6 @@ Playlist::Playlist(Core *c, QWidget *parent, Qt::WindowFlags f)
     setAcceptDrops(true);
     setAttribute(Qt::WA_NoMousePropagation);
 
-    // Random seed
-    QTime t;
-    t.start();
-    srand(t.hour() * 3600 + t.minute() * 60 + t.second());
-
     loadSettings();
 
     // Ugly hack to avoid to play next item automatically
@@ -133,6 +160,7 @@ Playlist::Playlist(Core *c, QWidget *parent, Qt::WindowFlags f)
 Playlist::~Playlist()
 {
     saveSettings();
+    delete journal;
 }
 
 void Playlist::setModified(bool mod)
@@ -140,12 +168,17 @@ void Playlist::setModified(bool mod)
     qDebug("Playlist::setModified: %d", mod);
 
     modified = mod;
+
+    if (journal) journal->setModified(modified);
     emit modifiedChanged(modified);
 }
 
 void Playlist::createTable()
 {
-    listView = new MyTableWidget(0, COL_TIME + 1, this);
+    model = new PlaylistModel(&pl, this);
+
+    listView = new QTableView(this);
+    listView->setModel(model);
     listView->setObjectName("playlist_table");
     listView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     listView->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -176,8 +209,8 @@ void Playlist::createTable()
     listView->setDragDropMode(QAbstractItemView::InternalMove);
 #endif
 
-    connect(listView, SIGNAL(cellActivated(int, int)),
-            this, SLOT(itemDoubleClicked(int)));
+    connect(listView, SIGNAL(activated(const QModelIndex &)),
+            this, SLOT(itemActivated(const QModelIndex &)));
 
     // EDIT BY NEO -->
     connect(listView->horizontalHeader(), SIGNAL(sectionClicked(int)), this, SLOT(sortBy(int)));
@@ -287,10 +320,29 @@ void Playlist::createToolbar()
             this, SLOT(showPopup(const QPoint &)));
 }
 
+void Playlist::createScanStatus()
+{
+    scan_status = new QWidget(this);
+
+    scan_label = new QLabel(scan_status);
+
+    scan_stop_button = new QToolButton(scan_status);
+    connect(scan_stop_button, SIGNAL(clicked()), this, SLOT(stopAddingDirectories()));
+
+    QHBoxLayout *scan_layout = new QHBoxLayout;
+    scan_layout->setMargin(0);
+    scan_layout->addWidget(scan_label, 1);
+    scan_layout->addWidget(scan_stop_button);
+    scan_status->setLayout(scan_layout);
+
+    scan_status->hide();
+}
+
 void Playlist::retranslateStrings()
 {
-    listView->setHorizontalHeaderLabels(QStringList() << "   " <<
-                                        tr("Name") << tr("Length"));
+    model->setHeaderLabels(QStringList() << "   " <<
+                           tr("Name") << tr("Length"));
+    model->updateIcons();
 
     openAct->change(Images::icon("open"), tr("&Load"));
     saveAct->change(Images::icon("save"), tr("&Save"));
@@ -328,6 +380,8 @@ void Playlist::retranslateStrings()
     // Edit
     editAct->change(tr("&Edit"));
 
+    scan_stop_button->setText(tr("Stop"));
+
     // Tool buttons
     add_button->setIcon(Images::icon("plus"));
     add_button->setToolTip(tr("Add..."));
@@ -369,95 +423,104 @@ QString Playlist::print(QString seperator)
 
 void Playlist::updateView()
 {
-    qDebug("Playlist::updateView");
-
-    listView->setRowCount(pl.count());
-
-    //QString number;
-    QString name;
-    QString time;
-
-    for (int n = 0; n < pl.count(); n++) {
-        name = pl[n].name();
-
-        if (name.isEmpty()) name = pl[n].filename();
-
-        time = Helper::formatTime((int) pl[n].duration());
-
-        //listView->setText(n, COL_POS, number);
-        qDebug("Playlist::updateView: name: '%s'", name.toUtf8().data());
-        listView->setText(n, COL_NAME, name);
-        listView->setText(n, COL_TIME, time);
+    LOG_DEBUG(Log::Playlist, "Playlist::updateView");
 
-        if (pl[n].played()) {
-            listView->setIcon(n, COL_PLAY, Images::icon("ok"));
-        } else {
-            listView->setIcon(n, COL_PLAY, QPixmap());
-        }
-
-        if (row_spacing > -1) listView->setRowHeight(n, listView->font().pointSize() + row_spacing);
+    // The changed rows have already been sent to the view by the model
+    if (row_spacing > -1) {
+        listView->verticalHeader()->setDefaultSectionSize(listView->font().pointSize() + row_spacing);
     }
 
     //listView->resizeColumnsToContents();
     listView->resizeColumnToContents(COL_PLAY);
     listView->resizeColumnToContents(COL_TIME);
 
-    setCurrentItem(current_item);
-
     //adjustSize();
 }
 
-void Playlist::setCurrentItem(int current)
+int Playlist::currentRow()
 {
-    QIcon play_icon;
-
-    if (qApp->isLeftToRight()) {
-        play_icon = Images::icon("play");
-    } else {
-        play_icon = Images::flippedIcon("play");
-    }
+    return listView->currentIndex().row();
+}
 
-    int old_current = current_item;
+void Playlist::setCurrentItem(int current)
+{
     current_item = current;
 
     if ((current_item > -1) && (current_item < pl.count())) {
         pl[current_item].setPlayed(TRUE);
     }
 
-    if ((old_current >= 0) && (old_current < listView->rowCount())) {
-        listView->setIcon(old_current, COL_PLAY, QPixmap());
-    }
+    model->setCurrentItem(current_item);
 
-    if ((current_item >= 0) && (current_item < listView->rowCount())) {
-        listView->setIcon(current_item, COL_PLAY, play_icon);
-    }
+    if (journal) journal->setCurrentItem(current_item);
 
     //if (current_item >= 0) listView->selectRow(current_item);
     if (current_item >= 0) {
         listView->clearSelection();
-        listView->setCurrentCell(current_item, 0);
+        listView->setCurrentIndex(model->index(current_item, 0));
     }
 }
 
+void Playlist::moveCurrentItem(int row)
+{
+    current_item = row;
+
+    model->setCurrentItem(current_item);
+
+    if (journal) journal->setCurrentItem(current_item);
+}
+
 void Playlist::clear()
 {
+#if USE_INFOPROVIDER
+    // The info of the old files is not needed anymore
+    info_scanner->cancel();
+#endif
+
+    // The files of the directories being added are not wanted anymore
+    dir_scanner->cancel();
+    scan_status->hide();
+    scan_position_known = false;
+    start_play_pending = false;
+
+    model->beginResetItems();
     pl.clear();
+    model->endResetItems();
 
-    listView->clearContents();
-    listView->setRowCount(0);
+    item_index.clear();
+
+    sort_keys.clear();
+
+    // A new list, a new order
+    shuffle.reset(0, ShuffleOrder::randomSeed());
 
     setCurrentItem(0);
 
     setModified(false);
+
+    if (journal) compactJournal();
 }
 
 void Playlist::remove(int i)
 {
     if (i > -1 && i < pl.count()) {
+        model->beginRemoveItems(i, i);
+        item_index.remove(pl[i].filename());
         pl.removeAt(i);
+        model->endRemoveItems();
+
+        shuffle.removeRows(i, i);
+
+        if (journal) journal->remove(i, i);
+
+        // The items after it have moved up
+        updateIndex(i);
 
-        if (current_item == i && i == (pl.count() - 1))
+        if (i < current_item) {
+            moveCurrentItem(current_item - 1);
+        } else if (current_item == i && i == (pl.count() - 1)) {
             setCurrentItem(i - 1);
+        }
 
         setModified(false);
         updateView();
@@ -481,254 +544,274 @@ void Playlist::addItem(QString filename, QString name, double duration)
 
 void Playlist::addItem(QString filename, QString name, double duration, int position)
 {
-    qDebug("Playlist::addItem: '%s'", filename.toUtf8().data());
+    LOG_VERBOSE(Log::Playlist, "Playlist::addItem: '%s'", filename.toUtf8().data());
 
 #ifdef Q_OS_WIN
     filename = Helper::changeSlashes(filename);
 #endif
 
     // Test if already is in the list
-    for (int n = 0; n < pl.count(); n++) {
-        if (pl[n].filename() == filename) {
-            qDebug("Playlist::addItem: item already in list (%d), skipped", n);
-            return;
-        }
+    if (item_index.contains(filename)) {
+        LOG_VERBOSE(Log::Playlist, "Playlist::addItem: item already in list, skipped");
+        return;
     }
 
-    if (name.isEmpty()) {
-        QFileInfo fi(filename);
+    if (name.isEmpty()) name = defaultName(filename);
 
-        // Let's see if it looks like a file (no dvd://1 or something)
-        if (filename.indexOf(QRegExp("^.*://.*")) == -1) {
-            // Local file
-            name = fi.fileName(); //fi.baseName(TRUE);
-        } else {
-            // Stream
-            name = filename;
-        }
-    }
+    int row = pl.count();
+    if (position >= 0 && position < pl.count())
+        row = position;
+
+    model->beginInsertItems(row, row);
+    pl.insert(row, PlaylistItem(filename, name, duration));
+    model->endInsertItems();
+
+    shuffle.insertRows(row, 1);
 
-    pl.append(PlaylistItem(filename, name, duration));
-    if (position >= 0 && position < pl.count() - 1)
-        pl.move(pl.count() - 1, position);
+    if (journal) journal->insert(row, pl[row]);
+
+    // The new item and the ones after it, which have moved down
+    updateIndex(row);
     //setModified( true ); // Better set the modified on a higher level
 }
 
-// EDIT BY NEO -->
-void Playlist::sortBy(int section)
+QString Playlist::defaultName(const QString &filename)
 {
-    qDebug("Playlist::sortBy");
+    // Let's see if it looks like a file (no dvd://1 or something)
+    if (filename.contains("://")) return filename;
 
-    sortBy(section, false, 0);
+    // Local file
+    return QFileInfo(filename).fileName();
 }
 
-void Playlist::sortBy(int section, bool revert, int count)
+int Playlist::addItems(const QList<PlaylistItem> &items, int position)
 {
-    // Bubble sort
-    bool swaped = false;
+    qDebug("Playlist::addItems: %d items", items.count());
 
-    for (int n = 0; n < (pl.count() - count); n++) {
+    QList<PlaylistItem> new_items;
 
-        int last = n - 1;
-        int current = n;
+    int first = pl.count();
 
-        // Revert the sort
-        if (revert) {
-            last = n;
-            current = n - 1;
-        }
+    if ((position >= 0) && (position < pl.count())) first = position;
 
-        if (n > 0) {
-            int compare = 0;
-
-            if (section == 0) {
-                // Sort by played
-                bool lastItem = pl[last].played();
-                bool currentItem = pl[current].played();
-
-                if (!lastItem && currentItem) {
-                    compare = 1;
-                } else if (lastItem && currentItem) {
-                    if (last == current_item) {
-                        compare = 1;
-                    } else {
-                        compare = -1;
-                    }
-                } else {
-                    compare = -1;
-                }
-            } else if (section == 1) {
-                // Sort alphabetically
-                QString lastItem = pl[last].name();
-                QString currentItem = pl[current].name();
-                compare = lastItem.compare(currentItem);
-            } else if (section == 2) {
-                // Sort by duration
-                double lastItem = pl[last].duration();
-                double currentItem = pl[current].duration();
-
-                if (lastItem == currentItem) {
-                    compare = 0;
-                } else if (lastItem > currentItem) {
-                    compare = 1;
-                } else {
-                    compare = -1;
-                }
-            }
+    for (int n = 0; n < items.count(); n++) {
+        PlaylistItem item = items[n];
+        QString filename = item.filename();
 
-            // Swap items
-            if (compare > 0) {
-                swapItems(n, n - 1);
+#ifdef Q_OS_WIN
+        filename = Helper::changeSlashes(filename);
+        item.setFilename(filename);
+#endif
 
-                if (current_item == (n - 1)) {
-                    current_item = n;
-                } else if (current_item == n) {
-                    current_item = n - 1;
-                }
+        // Duplicates are skipped, like in addItem(), also the ones in
+        // this batch. Its row is final, the ones after it are updated
+        // below.
+        if (filename.isEmpty() || item_index.contains(filename)) continue;
 
-                listView->clearSelection();
-                listView->setCurrentCell(n - 1, 0);
+        if (item.name().isEmpty()) item.setName(defaultName(filename));
 
-                swaped = true;
-            }
-        }
+        item_index.insert(filename, first + new_items.count());
+        new_items.append(item);
     }
 
-    if ((count == 0) && !swaped && !revert) {
-        // Revert sort
-        sortBy(section, true, 0);
-    } else if (swaped) {
-        // Sort until there is nothing to sort
-        sortBy(section, revert, ++count);
+    if (new_items.isEmpty()) return 0;
+
+    model->beginInsertItems(first, first + new_items.count() - 1);
+
+    if (first == pl.count()) {
+        pl += new_items;
     } else {
-        updateView();
+        for (int n = 0; n < new_items.count(); n++) pl.insert(first + n, new_items[n]);
+    }
+
+    model->endInsertItems();
+
+    shuffle.insertRows(first, new_items.count());
+
+    // One record for all of them
+    if (journal) journal->insert(first, new_items);
+
+    // The new items and the ones after them, which have moved down
+    updateIndex(first);
+
+    if ((current_item >= first) && (current_item < pl.count() - new_items.count())) {
+        // The current item is one of the ones which have moved
+        moveCurrentItem(current_item + new_items.count());
     }
+
+    return new_items.count();
 }
-// <--
 
-void Playlist::load_m3u(QString file)
+//! Compares items of the playlist (by their row) using a list of sort keys
+class PlaylistItemLess
 {
-    qDebug("Playlist::load_m3u");
+public:
+    PlaylistItemLess(const QList<PlaylistItem> &items, const QList<int> &keys, int current)
+        : pl(items), sort_keys(keys), current_item(current) {};
 
-    bool utf8 = (QFileInfo(file).suffix().toLower() == "m3u8");
+    bool operator()(int i1, int i2) const {
+        for (int n = 0; n < sort_keys.count(); n++) {
+            int key = sort_keys[n];
+            int r = compare(qAbs(key) - 1, i1, i2);
 
-    QRegExp m3u_id("^#EXTM3U|^#M3U");
-    QRegExp info("^#EXTINF:(.*),(.*)");
+            if (r != 0) return (key < 0) ? (r > 0) : (r < 0);
+        }
 
-    QFile f(file);
+        return false;
+    };
+
+protected:
+    int compare(int section, int i1, int i2) const {
+        const PlaylistItem &item1 = pl[i1];
+        const PlaylistItem &item2 = pl[i2];
+
+        if (section == COL_PLAY) {
+            // Played items first, the current one the last of them
+            return playedRank(i1) - playedRank(i2);
+        } else if (section == COL_NAME) {
+            return Helper::naturalCompare(sortName(item1), sortName(item2));
+        } else if (section == COL_TIME) {
+            if (item1.duration() < item2.duration()) return -1;
+
+            if (item1.duration() > item2.duration()) return 1;
+        }
 
-    if (f.open(QIODevice::ReadOnly)) {
-        playlist_path = QFileInfo(file).path();
+        return 0;
+    };
 
-        clear();
-        QString filename = "";
-        QString name = "";
-        double duration = 0;
+    int playedRank(int i) const {
+        if (i == current_item) return 1;
 
-        QTextStream stream(&f);
+        return pl[i].played() ? 0 : 2;
+    };
 
-        if (utf8)
-            stream.setCodec("UTF-8");
-        else
-            stream.setCodec(QTextCodec::codecForLocale());
+    static QString sortName(const PlaylistItem &item) {
+        return item.name().isEmpty() ? item.filename() : item.name();
+    };
 
-        QString line;
-
-        while (!stream.atEnd()) {
-            line = stream.readLine(); // line of text excluding '\n'
-            qDebug(" * line: '%s'", line.toUtf8().data());
-
-            if (m3u_id.indexIn(line) != -1) {
-                //#EXTM3U
-                // Ignore line
-            } else if (info.indexIn(line) != -1) {
-                duration = info.cap(1).toDouble();
-                name = info.cap(2);
-                qDebug(" * name: '%s', duration: %f", name.toUtf8().data(), duration);
-            } else if (line.startsWith("#")) {
-                // Comment
-                // Ignore
-            } else {
-                filename = line;
-                QFileInfo fi(filename);
-
-                if (fi.exists()) {
-                    filename = fi.absoluteFilePath();
-                }
-
-                if (!fi.exists()) {
-                    if (QFileInfo(playlist_path + "/" + filename).exists()) {
-                        filename = playlist_path + "/" + filename;
-                    }
-                }
-
-                addItem(filename, name, duration);
-                name = "";
-                duration = 0;
-            }
-        }
+    const QList<PlaylistItem> &pl;
+    QList<int> sort_keys;
+    int current_item;
+};
 
-        f.close();
-        list();
-        updateView();
+void Playlist::sortBy(int section)
+{
+    qDebug("Playlist::sortBy: %d", section);
 
-        setModified(false);
+    QList<int> keys = sort_keys;
+    int key = section + 1;
 
-        startPlay();
+    if (!keys.isEmpty() && (qAbs(keys[0]) == key)) {
+        // Same column: reverse the order
+        keys[0] = -keys[0];
+    } else {
+        keys.removeAll(key);
+        keys.removeAll(-key);
+        keys.prepend(key);
     }
+
+    sortBy(keys);
 }
 
-void Playlist::load_pls(QString file)
+void Playlist::sortBy(const QList<int> &keys)
 {
-    qDebug("Playlist::load_pls");
+    sort_keys = keys;
+    sortItems();
+}
 
-    if (!QFile::exists(file)) {
-        qDebug("Playlist::load_pls: '%s' doesn't exist, doing nothing", file.toUtf8().constData());
-        return;
+void Playlist::sortItems()
+{
+    qDebug("Playlist::sortItems: %d items, %d keys", pl.count(), sort_keys.count());
+
+    if ((pl.count() < 2) || sort_keys.isEmpty()) return;
+
+    QVector<int> order(pl.count());
+
+    for (int n = 0; n < order.count(); n++) order[n] = n;
+
+    qStableSort(order.begin(), order.end(), PlaylistItemLess(pl, sort_keys, current_item));
+
+    QList<PlaylistItem> sorted;
+    QVector<int> new_rows(pl.count());
+
+    for (int n = 0; n < order.count(); n++) {
+        sorted.append(pl[order[n]]);
+        new_rows[order[n]] = n;
     }
 
-    playlist_path = QFileInfo(file).path();
+    model->beginReorderItems();
+    pl = sorted;
+    model->endReorderItems(new_rows);
 
-    QSettings set(file, QSettings::IniFormat);
-    set.beginGroup("playlist");
+    shuffle.moveRows(new_rows);
 
-    if (set.status() == QSettings::NoError) {
-        clear();
-        QString filename;
-        QString name;
-        double duration;
+    if ((current_item >= 0) && (current_item < new_rows.count())) {
+        current_item = new_rows[current_item];
+    }
 
-        int num_items = set.value("NumberOfEntries", 0).toInt();
+    // Same filenames, only their rows change
+    QHash<QString, int>::iterator it;
 
-        for (int n = 0; n < num_items; n++) {
-            filename = set.value("File" + QString::number(n + 1), "").toString();
-            name = set.value("Title" + QString::number(n + 1), "").toString();
-            duration = (double) set.value("Length" + QString::number(n + 1), 0).toInt();
+    for (it = item_index.begin(); it != item_index.end(); ++it) {
+        it.value() = new_rows[it.value()];
+    }
 
-            QFileInfo fi(filename);
+    // The whole order has changed
+    if (journal) compactJournal();
 
-            if (fi.exists()) {
-                filename = fi.absoluteFilePath();
-            }
+    // The model has moved the rows, the selection and the current item
+    setModified(true);
+}
 
-            if (!fi.exists()) {
-                if (QFileInfo(playlist_path + "/" + filename).exists()) {
-                    filename = playlist_path + "/" + filename;
-                }
-            }
+void Playlist::load_m3u(QString file)
+{
+    qDebug("Playlist::load_m3u");
 
-            addItem(filename, name, duration);
-        }
+    loadPlaylistFile(file, PlaylistParser::M3U);
+}
+
+void Playlist::load_pls(QString file)
+{
+    qDebug("Playlist::load_pls");
+
+    loadPlaylistFile(file, PlaylistParser::PLS);
+}
+
+void Playlist::load_xspf(QString file)
+{
+    qDebug("Playlist::load_xspf");
+
+    loadPlaylistFile(file, PlaylistParser::XSPF);
+}
+
+void Playlist::loadPlaylistFile(QString file, int format)
+{
+    QList<PlaylistItem> items;
+
+    if (!PlaylistParser::parse(file, (PlaylistParser::Format) format, items)) {
+        qDebug("Playlist::loadPlaylistFile: '%s' can't be read, doing nothing", file.toUtf8().constData());
+        return;
     }
 
-    set.endGroup();
+    playlist_path = QFileInfo(file).path();
+
+    clear();
+    addItems(items);
+
+#if USE_INFOPROVIDER
+    // The parser doesn't check the files, it's done in the background
+    QStringList files;
+
+    for (int n = 0; n < pl.count(); n++) files << pl[n].filename();
+
+    info_scanner->checkExistence(files);
+#endif
 
-    list();
     updateView();
 
     setModified(false);
 
-    if (set.status() == QSettings::NoError) startPlay();
+    startPlay();
 }
 
 bool Playlist::save_m3u(QString file)
@@ -842,6 +925,63 @@ bool Playlist::save_pls(QString file)
     return ok;
 }
 
+bool Playlist::save_xspf(QString file)
+{
+    qDebug("Playlist::save_xspf: '%s'", file.toUtf8().data());
+
+    QString dir_path = QFileInfo(file).path();
+
+    if (!dir_path.endsWith("/")) dir_path += "/";
+
+    QFile f(file);
+
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    QXmlStreamWriter xml(&f);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    xml.writeStartElement("playlist");
+    xml.writeAttribute("version", "1");
+    xml.writeAttribute("xmlns", "http://xspf.org/ns/0/");
+    xml.writeStartElement("trackList");
+
+    QString filename;
+
+    for (int n = 0; n < pl.count(); n++) {
+        filename = pl[n].filename();
+
+        xml.writeStartElement("track");
+
+        if (filename.contains("://")) {
+            xml.writeTextElement("location", filename);
+        } else if (filename.startsWith(dir_path)) {
+            // Relative to the playlist
+            xml.writeTextElement("location", QString::fromLatin1(QUrl::toPercentEncoding(filename.mid(dir_path.length()), "/")));
+        } else {
+            xml.writeTextElement("location", QString::fromLatin1(QUrl::fromLocalFile(filename).toEncoded()));
+        }
+
+        if (!pl[n].name().isEmpty()) xml.writeTextElement("title", pl[n].name());
+
+        if (pl[n].duration() > 0) {
+            xml.writeTextElement("duration", QString::number((qint64)(pl[n].duration() * 1000)));
+        }
+
+        xml.writeEndElement();
+    }
+
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+
+    bool ok = (f.error() == QFile::NoError);
+    f.close();
+
+    if (ok) setModified(false);
+
+    return ok;
+}
+
 
 void Playlist::load()
 {
@@ -855,8 +995,12 @@ void Playlist::load()
         if (!s.isEmpty()) {
             latest_dir = QFileInfo(s).absolutePath();
 
-            if (QFileInfo(s).suffix().toLower() == "pls")
+            PlaylistParser::Format format = PlaylistParser::formatOf(s);
+
+            if (format == PlaylistParser::PLS)
                 load_pls(s);
+            else if (format == PlaylistParser::XSPF)
+                load_xspf(s);
             else
                 load_m3u(s);
         }
@@ -893,8 +1037,12 @@ bool Playlist::save()
 
         latest_dir = QFileInfo(s).absolutePath();
 
-        if (QFileInfo(s).suffix().toLower() == "pls")
+        PlaylistParser::Format format = PlaylistParser::formatOf(s);
+
+        if (format == PlaylistParser::PLS)
             return save_pls(s);
+        else if (format == PlaylistParser::XSPF)
+            return save_xspf(s);
         else
             return save_m3u(s);
 
@@ -926,7 +1074,7 @@ bool Playlist::maybeSave()
 
 void Playlist::playCurrent()
 {
-    int current = listView->currentRow();
+    int current = currentRow();
 
     if (current > -1) {
         playItem(current);
@@ -939,6 +1087,11 @@ void Playlist::itemDoubleClicked(int row)
     playItem(row);
 }
 
+void Playlist::itemActivated(const QModelIndex &index)
+{
+    if (index.isValid()) itemDoubleClicked(index.row());
+}
+
 void Playlist::showPopup(const QPoint &pos)
 {
     qDebug("Playlist::showPopup: x: %d y: %d", pos.x(), pos.y());
@@ -951,11 +1104,22 @@ void Playlist::showPopup(const QPoint &pos)
 
 void Playlist::startPlay()
 {
+    // Some directories are still being added, play when there are files
+    if ((pl.isEmpty()) && (dir_scanner->isScanning())) {
+        qDebug("Playlist::startPlay: waiting for the directory scan");
+        start_play_pending = true;
+        return;
+    }
+
     // Start to play
-    if (shuffleAct->isChecked())
+    if (shuffleAct->isChecked()) {
+        // Everything was played, start a new order
+        if (shuffle.next() == -1) reshuffle();
+
         playItem(chooseRandomItem());
-    else
+    } else {
         playItem(0);
+    }
 }
 
 void Playlist::playItem(int n)
@@ -977,6 +1141,11 @@ void Playlist::playItem(int n)
         //pl[n].setPlayed(TRUE);
         setCurrentItem(n);
 
+        // Played items go to the shuffle history
+        shuffle.setCurrent(n);
+
+        if (journal) journal->shufflePlay(n);
+
         if (play_files_from_start)
             core->open(filename, 0);
         else
@@ -996,7 +1165,10 @@ void Playlist::playNext()
         if (chosen_item == -1) {
             clearPlayedTag();
 
-            if (repeatAct->isChecked()) chosen_item = chooseRandomItem();
+            if (repeatAct->isChecked()) {
+                reshuffle();
+                chosen_item = chooseRandomItem();
+            }
         }
 
         playItem(chosen_item);
@@ -1017,6 +1189,15 @@ void Playlist::playPrev()
 {
     qDebug("Playlist::playPrev");
 
+    if (shuffleAct->isChecked()) {
+        // Back through the shuffle history
+        int previous = shuffle.previous();
+
+        if (previous > -1) playItem(previous);
+
+        return;
+    }
+
     if (current_item > 0) {
         playItem(current_item - 1);
     } else {
@@ -1051,33 +1232,82 @@ void Playlist::getMediaInfo()
 
     if (!artist.isEmpty()) name = artist + " - " + name;
 
-    int pos = 0;
-    PlaylistItemList::iterator it;
+#if USE_INFOPROVIDER
 
-    for (it = pl.begin(); it != pl.end(); ++it) {
-        if ((*it).filename() == filename) {
-            if ((*it).duration() < 1) {
-                if (!name.isEmpty()) {
-                    (*it).setName(name);
-                }
+    // Remember it, in case it's added again. Options which change what
+    // mplayer finds in the file would store wrong info.
+    if ((core->mdat.type == TYPE_FILE) && (core->mset.forced_demuxer.isEmpty()) &&
+            (core->mset.forced_video_codec.isEmpty()) && (core->mset.forced_audio_codec.isEmpty()) &&
+            (core->mset.external_audio.isEmpty())) {
+        media_info_cache->insert(core->mdat.filename, MediaInfoCache::identifyInfo(core->mdat));
+    }
+
+#endif
+
+    int pos = findItem(filename);
+
+    if (pos > -1) {
+        PlaylistItem &item = pl[pos];
 
-                (*it).setDuration(duration);
+        if (item.duration() < 1) {
+            if (!name.isEmpty()) {
+                item.setName(name);
+            }
+
+            item.setDuration(duration);
+            //setModified( true );
+        } else
+
+            // Edited name (sets duration to 1)
+            if (item.duration() == 1) {
+                item.setDuration(duration);
                 //setModified( true );
-            } else
+            }
 
-                // Edited name (sets duration to 1)
-                if ((*it).duration() == 1) {
-                    (*it).setDuration(duration);
-                    //setModified( true );
-                }
+        if (journal) journal->update(pos, item);
 
-            setCurrentItem(pos);
-        }
+        if (pos != current_item) setCurrentItem(pos);
 
-        pos++;
+        model->itemsChanged(pos, pos);
     }
+}
 
-    updateView();
+void Playlist::mediaInfoAvailable(QString filename, MediaData data)
+{
+    qDebug("Playlist::mediaInfoAvailable: '%s'", filename.toUtf8().data());
+
+#ifdef Q_OS_WIN
+    filename = Helper::changeSlashes(filename);
+#endif
+
+    int n = findItem(filename);
+
+    // Don't overwrite the info of an item already played or edited
+    if ((n > -1) && (pl[n].duration() < 1)) {
+        QString name = data.displayName();
+
+        if (!name.isEmpty()) pl[n].setName(name);
+
+        pl[n].setDuration(data.duration);
+
+        model->itemsChanged(n, n);
+
+        if (journal) journal->update(n, pl[n]);
+    }
+}
+
+void Playlist::filesMissing(QStringList files)
+{
+    qDebug("Playlist::filesMissing: %d files", files.count());
+
+    for (int i = 0; i < files.count(); i++) {
+        int n = findItem(files[i]);
+
+        if (n > -1) {
+            pl[n].setMissing(true);
+            model->itemsChanged(n, n);
+        }
+    }
 }
 
 // Add current file to playlist
@@ -1107,61 +1337,83 @@ void Playlist::addFiles(QStringList files, AutoGetInfo auto_get_info)
 {
     qDebug("Playlist::addFiles");
 
-#if USE_INFOPROVIDER
     bool get_info = (auto_get_info == GetInfo);
 
     if (auto_get_info == UserDefined) {
         get_info = automatically_get_info;
     }
 
-    MediaData data;
-    setCursor(Qt::WaitCursor);
-#endif
+    int position = files.isEmpty() ? -1 : consecutivePosition(files.first());
 
-    QStringList::Iterator it = files.begin();
+    insertFiles(files, get_info, position);
 
-    int placePos = pl.count();
-    if (current_item >= 0 && current_item < pl.count() &&
-        pref->add_to_playlist_consecutive_files
-    ) {
-        PlaylistItem plitem = pl.at(current_item);
-        QFileInfo fi = QFileInfo((*it));
-        QString item_dir = fi.absolutePath();
+    updateView();
+}
 
-        fi = QFileInfo(plitem.filename());
-        if(0 == item_dir.compare(fi.absolutePath()))
-            placePos = current_item + 1;
+int Playlist::consecutivePosition(const QString &file)
+{
+    if ((!pref->add_to_playlist_consecutive_files) ||
+            (current_item < 0) || (current_item >= pl.count())) {
+        return -1;
     }
 
+    QString item_dir = QFileInfo(file).absolutePath();
+    QString current_dir = QFileInfo(pl[current_item].filename()).absolutePath();
+
+    if (item_dir.compare(current_dir) == 0) return current_item + 1;
+
+    return -1;
+}
+
+int Playlist::insertFiles(const QStringList &files, bool get_info, int position)
+{
+#if USE_INFOPROVIDER
+    QStringList files_to_scan;
+#else
+    Q_UNUSED(get_info);
+#endif
+
+    QStringList::ConstIterator it = files.begin();
+    QList<PlaylistItem> items;
+
     while (it != files.end()) {
 #if USE_INFOPROVIDER
 
-        if ((get_info) && (QFile::exists((*it)))) {
-            data = InfoProvider::getInfo((*it));
-            addItem((*it), data.displayName(), data.duration, placePos++);
-            //updateView();
-            //qApp->processEvents();
+        MediaData data;
+        bool scan = ((get_info) && (QFile::exists((*it))));
+
+        if ((scan) && (media_info_cache->find((*it), data))) {
+            items.append(PlaylistItem((*it), data.displayName(), data.duration));
         } else {
-            addItem((*it), "", 0, placePos++);
+            items.append(PlaylistItem((*it), "", 0));
+
+            // The name and duration will be set when the info arrives
+            if (scan) files_to_scan << (*it);
         }
 
 #else
-        addItem((*it), "", 0);
+        items.append(PlaylistItem((*it), "", 0));
 #endif
 
-        if (QFile::exists(*it)) {
-            latest_dir = QFileInfo((*it)).absolutePath();
-        }
-
         ++it;
     }
 
+    // All at once, so the journal gets a single record
+    int added = addItems(items, position);
+
+    // Only the last file is checked, this can be called with thousands
+    // of files on a slow disk
+    if ((!files.isEmpty()) && (QFile::exists(files.last()))) {
+        latest_dir = QFileInfo(files.last()).absolutePath();
+    }
+
 #if USE_INFOPROVIDER
-    unsetCursor();
+    if (!files_to_scan.isEmpty()) info_scanner->scan(files_to_scan);
 #endif
-    updateView();
 
-    qDebug("Playlist::addFiles: latest_dir: '%s'", latest_dir.toUtf8().constData());
+    qDebug("Playlist::insertFiles: latest_dir: '%s'", latest_dir.toUtf8().constData());
+
+    return added;
 }
 
 void Playlist::addFile(QString file, AutoGetInfo auto_get_info)
@@ -1183,50 +1435,82 @@ void Playlist::addDirectory()
 
 void Playlist::addOneDirectory(QString dir)
 {
-    QStringList filelist;
+    startDirectoryScan(dir, false);
+}
 
-    Extensions e;
-    QRegExp rx_ext(e.multimedia().forRegExp());
-    rx_ext.setCaseSensitivity(Qt::CaseInsensitive);
+void Playlist::addDirectory(QString dir)
+{
+    startDirectoryScan(dir, recursive_add_directory);
+}
 
-    QStringList dir_list = QDir(dir).entryList();
+void Playlist::startDirectoryScan(const QString &dir, bool recursive)
+{
+    // The directories queued while a scan is running go after it
+    if (!dir_scanner->isScanning()) scan_position_known = false;
 
-    QString filename;
-    QStringList::Iterator it = dir_list.begin();
+    scan_status->show();
+    dir_scanner->scan(dir, recursive);
+}
 
-    while (it != dir_list.end()) {
-        filename = dir;
+void Playlist::stopAddingDirectories()
+{
+    qDebug("Playlist::stopAddingDirectories");
 
-        if (filename.right(1) != "/") filename += "/";
+    dir_scanner->cancel();
+    scan_status->hide();
 
-        filename += (*it);
-        QFileInfo fi(filename);
+    if (start_play_pending) {
+        start_play_pending = false;
 
-        if (!fi.isDir()) {
-            if (rx_ext.indexIn(fi.suffix()) > -1) {
-                filelist << filename;
-            }
-        }
+        if (!pl.isEmpty()) startPlay();
+    }
+}
 
-        ++it;
+void Playlist::directoryFilesFound(QStringList files)
+{
+    qDebug("Playlist::directoryFilesFound: %d files", files.count());
+
+    // Each batch goes after the previous one
+    if (!scan_position_known) {
+        scan_position = files.isEmpty() ? -1 : consecutivePosition(files.first());
+        scan_position_known = true;
     }
 
-    addFiles(filelist);
+    if (scan_position > pl.count()) scan_position = -1;
+
+    int added = insertFiles(files, automatically_get_info, scan_position);
+
+    if (scan_position > -1) scan_position += added;
+
+    // The rows are already in the view, the columns are resized when
+    // the scan finishes
+
+    // With shuffle it waits for the whole list
+    if ((start_play_pending) && (!shuffleAct->isChecked()) && (!pl.isEmpty())) {
+        start_play_pending = false;
+        startPlay();
+    }
 }
 
-void Playlist::addDirectory(QString dir)
+void Playlist::directoryScanProgress(int dirs, int files)
 {
-    addOneDirectory(dir);
+    scan_label->setText(tr("Adding files: %1 found in %2 folders").arg(files).arg(dirs));
+}
 
-    if (recursive_add_directory) {
-        QFileInfoList dir_list = QDir(dir).entryInfoList(QStringList() << "*", QDir::AllDirs | QDir::NoDotAndDotDot);
+void Playlist::directoryScanFinished()
+{
+    qDebug("Playlist::directoryScanFinished");
 
-        for (int n = 0; n < dir_list.count(); n++) {
-            if (dir_list[n].isDir()) {
-                qDebug("Playlist::addDirectory: adding directory: %s", dir_list[n].filePath().toUtf8().data());
-                addDirectory(dir_list[n].filePath());
-            }
-        }
+    scan_status->hide();
+    scan_label->clear();
+
+    listView->resizeColumnToContents(COL_PLAY);
+    listView->resizeColumnToContents(COL_TIME);
+
+    if (start_play_pending) {
+        start_play_pending = false;
+
+        if (!pl.isEmpty()) startPlay();
     }
 }
 
@@ -1235,45 +1519,68 @@ void Playlist::removeSelected()
 {
     qDebug("Playlist::removeSelected");
 
+    QList<int> selected;
+    QModelIndexList rows = listView->selectionModel()->selectedRows();
+
+    for (int n = 0; n < rows.count(); n++) {
+        selected.append(rows[n].row());
+    }
+
+    qSort(selected);
+
     int first_selected = -1;
-    int number_previous_item = 0;
+    int number_previous_item = selected.count();
+
+    if (!selected.isEmpty()) first_selected = selected.first();
+
+    // Remove from the end, a block of consecutive rows at a time
+    int n = selected.count() - 1;
 
-    for (int n = 0; n < listView->rowCount(); n++) {
-        if (listView->isSelected(n, 0)) {
-            qDebug(" row %d selected", n);
-            pl[n].setMarkForDeletion(TRUE);
-            number_previous_item++;
+    while (n >= 0) {
+        int last = selected[n];
+        int first = last;
 
-            if (first_selected == -1) first_selected = n;
+        while ((n > 0) && (selected[n - 1] == first - 1)) {
+            n--;
+            first--;
         }
-    }
 
-    PlaylistItemList::iterator it;
+        model->beginRemoveItems(first, last);
 
-    for (it = pl.begin(); it != pl.end(); ++it) {
-        if ((*it).markedForDeletion()) {
-            qDebug("Remove '%s'", (*it).filename().toUtf8().data());
-            it = pl.erase(it);
-            it--;
-            setModified(true);
+        for (int row = last; row >= first; row--) {
+            LOG_VERBOSE(Log::Playlist, "Playlist::removeSelected: '%s'", pl[row].filename().toUtf8().data());
+            item_index.remove(pl[row].filename());
+            pl.removeAt(row);
         }
+
+        model->endRemoveItems();
+
+        shuffle.removeRows(first, last);
+
+        if (journal) journal->remove(first, last);
+
+        setModified(true);
+
+        n--;
     }
 
+    // Renumber the items after the first removed row only once
+    if (first_selected > -1) updateIndex(first_selected);
 
     if (first_selected < current_item) {
-        current_item -= number_previous_item;
+        moveCurrentItem(current_item - number_previous_item);
     }
 
     if (isEmpty()) setModified(false);
 
     updateView();
 
-    if (first_selected >= listView->rowCount())
-        first_selected = listView->rowCount() - 1;
+    if (first_selected >= pl.count())
+        first_selected = pl.count() - 1;
 
-    if ((first_selected > -1) && (first_selected < listView->rowCount())) {
+    if ((first_selected > -1) && (first_selected < pl.count())) {
         listView->clearSelection();
-        listView->setCurrentCell(first_selected, 0);
+        listView->setCurrentIndex(model->index(first_selected, 0));
         //listView->selectRow( first_selected );
     }
 }
@@ -1290,72 +1597,83 @@ void Playlist::removeAll()
 
 void Playlist::clearPlayedTag()
 {
-    PlaylistItemList::iterator it;
+    int first = -1;
+    int last = -1;
 
-    for (it = pl.begin(); it != pl.end(); ++it) {
-        (*it).setPlayed(FALSE);
+    for (int n = 0; n < pl.count(); n++) {
+        if (pl[n].played()) {
+            if (first < 0) first = n;
+
+            last = n;
+            pl[n].setPlayed(FALSE);
+        }
     }
 
-    updateView();
+    if (first > -1) model->itemsChanged(first, last);
 }
 
 int Playlist::chooseRandomItem()
 {
-    qDebug("Playlist::chooseRandomItem");
-    QList <int> fi; //List of not played items (free items)
+    int n = shuffle.next();
 
-    int n = 0;
-    PlaylistItemList::iterator it;
+    LOG_VERBOSE(Log::Playlist, "Playlist::chooseRandomItem: %d", n);
+    return n;
+}
 
-    for (it = pl.begin(); it != pl.end(); ++it) {
-        if (!(*it).played()) fi.append(n);
+void Playlist::reshuffle()
+{
+    quint32 seed = ShuffleOrder::randomSeed();
 
-        n++;
-    }
+    shuffle.reset(pl.count(), seed);
 
-    qDebug(" * free items: %d", fi.count());
+    if (journal) journal->shuffleReset(seed);
+}
 
-    if (fi.count() == 0) return -1; // none free
+void Playlist::swapItems(int item1, int item2)
+{
+    pl.swap(item1, item2);
+    shuffle.swapRows(item1, item2);
 
-    qDebug(" * items: ");
+    if (journal) journal->swap(item1, item2);
 
-    for (int i = 0; i < fi.count(); i++) {
-        qDebug("   * item: %d", fi[i]);
-    }
+    item_index.insert(pl[item1].filename(), item1);
+    item_index.insert(pl[item2].filename(), item2);
 
-    int selected = (int)((double) fi.count() * rand() / (RAND_MAX + 1.0));
-    qDebug(" * selected item: %d (%d)", selected, fi[selected]);
-    return fi[selected];
+    setModified(true);
 }
 
-void Playlist::swapItems(int item1, int item2)
+int Playlist::findItem(const QString &filename)
 {
-    PlaylistItem it1 = pl[item1];
-    pl[item1] = pl[item2];
-    pl[item2] = it1;
-    setModified(true);
+    return item_index.value(filename, -1);
+}
+
+void Playlist::updateIndex(int from)
+{
+    for (int n = from; n < pl.count(); n++) {
+        item_index.insert(pl[n].filename(), n);
+    }
 }
 
 void Playlist::moveItems( int current, MoveItemsDirection moveUp )
 {
     // up(1) = 1, down(0) = -1
     int delta = (int) (moveUp)*2 - 1;
-    int limit = (int) (!moveUp)*( listView->rowCount() - 1 );
+    int limit = (int) (!moveUp)*( pl.count() - 1 );
 
     if( delta*current < delta*limit + 1 )
         return;
 
     int i;
     int near;
-    QTableWidgetSelectionRange range;
-    QList<QTableWidgetSelectionRange> rangeList;
-    foreach( range, listView->selectedRanges() )
+    QItemSelectionRange range;
+    QItemSelection new_selection;
+    foreach( range, listView->selectionModel()->selection() )
     {
-        near = moveUp ? range.topRow() : range.bottomRow();
+        near = moveUp ? range.top() : range.bottom();
         if( delta*near <= delta*limit )
             return;
 
-        for( i = 0; i < range.rowCount(); ++i )
+        for( i = 0; i < range.height(); ++i )
             swapItems( near + delta*i, near + delta*(i - 1) );
 
         // current_item increment is one of:
@@ -1365,36 +1683,35 @@ void Playlist::moveItems( int current, MoveItemsDirection moveUp )
         // =bottomRow+1     = bottomRow - topRow (if down)
         current_item -= delta * (
             (int) (
-                current_item >= range.topRow() &&
-                current_item <= range.bottomRow()
+                current_item >= range.top() &&
+                current_item <= range.bottom()
             ) - (int) (
                 current_item == near - delta
-            ) * range.rowCount()
+            ) * range.height()
         );
 
-        rangeList.append(
-            QTableWidgetSelectionRange(
-                range.topRow() - delta,
-                range.leftColumn(),
-                range.bottomRow() - delta,
-                range.rightColumn()
-            )
+        new_selection.select(
+            model->index( range.top() - delta, range.left() ),
+            model->index( range.bottom() - delta, range.right() )
         );
+
+        // The range and the row it has swapped places with
+        model->itemsChanged( qMin( range.top(), range.top() - delta ),
+                             qMax( range.bottom(), range.bottom() - delta ) );
     }
 
-    updateView();
+    moveCurrentItem(current_item);
     listView->clearSelection();
-    listView->setCurrentCell( current - delta, 0 );
+    listView->setCurrentIndex( model->index( current - delta, 0 ) );
 
-    foreach( range, rangeList )
-        listView->setRangeSelected( range, true );
+    listView->selectionModel()->select( new_selection, QItemSelectionModel::Select );
 }
 
 void Playlist::upItem()
 {
     qDebug("Playlist::upItem");
 
-    int current = listView->currentRow();
+    int current = currentRow();
     qDebug(" currentRow: %d", current);
 
     moveItems( current, MoveItemUp );
@@ -1404,7 +1721,7 @@ void Playlist::downItem()
 {
     qDebug("Playlist::downItem");
 
-    int current = listView->currentRow();
+    int current = currentRow();
     qDebug(" currentRow: %d", current);
 
     moveItems( current, MoveItemDown );
@@ -1424,7 +1741,7 @@ void Playlist::moveItemDown(int current)
 
 void Playlist::editCurrentItem()
 {
-    int current = listView->currentRow();
+    int current = currentRow();
 
     if (current > -1) editItem(current);
 }
@@ -1449,7 +1766,9 @@ void Playlist::editItem(int item)
         // If duration == 0 the name will be overwritten!
         if (pl[item].duration() < 1) pl[item].setDuration(1);
 
-        updateView();
+        if (journal) journal->update(item, pl[item]);
+
+        model->itemsChanged(item, item);
 
         setModified(true);
     }
@@ -1530,6 +1849,8 @@ void Playlist::maybeSaveSettings()
 {
     qDebug("Playlist::maybeSaveSettings");
 
+    if ((journal) && (journal->needsCompaction())) compactJournal();
+
     if (isModified()) saveSettings();
 }
 
@@ -1559,23 +1880,8 @@ void Playlist::saveSettings()
 
     set->endGroup();
 
-    if (save_playlist_in_config) {
-        //Save current list
-        set->beginGroup("playlist_contents");
-
-        set->setValue("count", (int) pl.count());
-
-        for (int n = 0; n < pl.count(); n++) {
-            set->setValue(QString("item_%1_filename").arg(n), pl[n].filename());
-            set->setValue(QString("item_%1_duration").arg(n), pl[n].duration());
-            set->setValue(QString("item_%1_name").arg(n), pl[n].name());
-        }
-
-        set->setValue("current_item", current_item);
-        set->setValue("modified", modified);
-
-        set->endGroup();
-    }
+    // The list itself is in the journal, already up to date
+    if ((journal) && (journal->needsCompaction())) compactJournal();
 }
 
 void Playlist::loadSettings()
@@ -1607,27 +1913,88 @@ void Playlist::loadSettings()
 
     if (save_playlist_in_config) {
         //Load latest list
-        set->beginGroup("playlist_contents");
+        PlaylistJournal::State state;
 
-        int count = set->value("count", 0).toInt();
-        QString filename, name;
-        double duration;
+        if (!PlaylistJournal::read(journalFile(), state)) {
+            // The list saved in the config by older versions
+            set->beginGroup("playlist_contents");
+
+            int count = set->value("count", 0).toInt();
+
+            for (int n = 0; n < count; n++) {
+                state.items.append(PlaylistItem(set->value(QString("item_%1_filename").arg(n), "").toString(),
+                                                set->value(QString("item_%1_name").arg(n), "").toString(),
+                                                set->value(QString("item_%1_duration").arg(n), -1).toDouble()));
+            }
 
-        for (int n = 0; n < count; n++) {
-            filename = set->value(QString("item_%1_filename").arg(n), "").toString();
-            duration = set->value(QString("item_%1_duration").arg(n), -1).toDouble();
-            name = set->value(QString("item_%1_name").arg(n), "").toString();
-            addItem(filename, name, duration);
+            state.current_item = set->value("current_item", -1).toInt();
+            state.modified = set->value("modified", false).toBool();
+
+            set->endGroup();
+        }
+
+        addItems(state.items);
+
+        if (state.shuffle.count() == pl.count()) {
+            shuffle = state.shuffle;
+        } else {
+            shuffle.reset(pl.count(), ShuffleOrder::randomSeed());
+        }
+
+        setCurrentItem(state.current_item);
+
+        for (int n = 0; n < state.sort_keys.count(); n++) {
+            int key = state.sort_keys[n];
+
+            if ((key != 0) && (qAbs(key) <= COL_TIME + 1)) sort_keys.append(key);
         }
 
-        setCurrentItem(set->value("current_item", -1).toInt());
-        setModified(set->value("modified", false).toBool());
+        setModified(state.modified);
         updateView();
 
-        set->endGroup();
+        // Not needed anymore, the journal is used instead
+        if (openJournal()) set->remove("playlist_contents");
+    } else {
+        PlaylistJournal::removeFile(journalFile());
     }
 }
 
+void Playlist::setSavePlaylistOnExit(bool b)
+{
+    save_playlist_in_config = b;
+
+    if ((save_playlist_in_config) && (!journal)) {
+        openJournal();
+    } else if ((!save_playlist_in_config) && (journal)) {
+        delete journal;
+        journal = 0;
+        PlaylistJournal::removeFile(journalFile());
+    }
+}
+
+QString Playlist::journalFile()
+{
+    return Paths::configPath() + "/smplayer2_playlist.dat";
+}
+
+bool Playlist::openJournal()
+{
+    journal = new PlaylistJournal(journalFile());
+    return compactJournal();
+}
+
+bool Playlist::compactJournal()
+{
+    PlaylistJournal::State state;
+    state.items = pl;
+    state.current_item = current_item;
+    state.modified = modified;
+    state.sort_keys = sort_keys;
+    state.shuffle = shuffle;
+
+    return journal->reset(state);
+}
+
 QString Playlist::lastDir()
 {
     QString last_dir = latest_dir;
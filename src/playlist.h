@@ -22,7 +22,11 @@
 
 #include <QList>
 #include <QStringList>
+#include <QHash>
 #include <QWidget>
+#include <QModelIndex>
+#include "mediadata.h"
+#include "shuffleorder.h"
 
 class PlaylistItem
 {
@@ -34,6 +38,7 @@ public:
         _duration = 0;
         _played = FALSE;
         _deleted = FALSE;
+        _missing = FALSE;
     };
     PlaylistItem(QString filename, QString name, double duration) {
         _filename = filename;
@@ -41,6 +46,7 @@ public:
         _duration = duration;
         _played = FALSE;
         _deleted = FALSE;
+        _missing = FALSE;
     };
     ~PlaylistItem() {};
 
@@ -59,30 +65,38 @@ public:
     void setMarkForDeletion(bool b) {
         _deleted = b;
     };
+    //! The file doesn't exist. Not saved, it's checked again on load.
+    void setMissing(bool b) {
+        _missing = b;
+    };
 
-    QString filename() {
+    QString filename() const {
         return _filename;
     };
-    QString name() {
+    QString name() const {
         return _name;
     };
-    double duration() {
+    double duration() const {
         return _duration;
     };
-    bool played() {
+    bool played() const {
         return _played;
     };
-    bool markedForDeletion() {
+    bool markedForDeletion() const {
         return _deleted;
     };
+    bool missing() const {
+        return _missing;
+    };
 
 private:
     QString _filename, _name;
     double _duration;
-    bool _played, _deleted;
+    bool _played, _deleted, _missing;
 };
 
-class MyTableWidget;
+class QTableView;
+class PlaylistModel;
 class QToolBar;
 class MyAction;
 class Core;
@@ -90,6 +104,10 @@ class QMenu;
 class QSettings;
 class QToolButton;
 class QTimer;
+class InfoScanner;
+class DirectoryScanner;
+class PlaylistJournal;
+class QLabel;
 
 class Playlist : public QWidget
 {
@@ -146,9 +164,13 @@ public slots:
     // Adds a directory, maybe with recursion (depends on user config)
     virtual void addDirectory(QString dir);
 
-    // EDIT BY NEO -->
+    //! Stops adding the files of the directories being scanned
+    virtual void stopAddingDirectories();
+
+    //! Sorts by the column \a section. If it's already sorted by it,
+    //! the order is reversed. The previous sort keys are kept as
+    //! secondary keys.
     virtual void sortBy(int section);
-    // <--
 
     virtual bool maybeSave();
     virtual void load();
@@ -160,6 +182,9 @@ public slots:
     virtual void load_pls(QString file);
     virtual bool save_pls(QString file);
 
+    virtual void load_xspf(QString file);
+    virtual bool save_xspf(QString file);
+
     virtual void getMediaInfo();
 
     void setModified(bool);
@@ -171,9 +196,8 @@ public slots:
     void setAutoGetInfo(bool b) {
         automatically_get_info = b;
     };
-    void setSavePlaylistOnExit(bool b) {
-        save_playlist_in_config = b;
-    };
+    //! The list is saved to a journal as it changes (see PlaylistJournal)
+    void setSavePlaylistOnExit(bool b);
     void setPlayFilesFromStart(bool b) {
         play_files_from_start = b;
     };
@@ -196,6 +220,18 @@ public:
         return pl;
     };
 
+    //! Sorts by several columns. Each key is the column + 1, negative
+    //! for descending order. The first key is the main one.
+    void sortBy(const QList<int> &keys);
+
+    //! Inserts many items at once at \a position (appends them if it's -1),
+    //! skipping the ones already in the list. Returns the number of items
+    //! inserted.
+    int addItems(const QList<PlaylistItem> &items, int position = -1);
+    QList<int> sortKeys() {
+        return sort_keys;
+    };
+
     /*
     public:
         MyAction * playPrevAct() { return prevAct; };
@@ -208,25 +244,60 @@ signals:
     void modifiedChanged(bool);
 
 protected:
+    //! Adjusts the view after rows have been added or removed. The
+    //! changed rows are sent to the view by the model.
     void updateView();
+    //! Row of the view with the focus, or -1
+    int currentRow();
+    //! Makes \a current the current item, marks it as played and
+    //! moves the focus of the view to it
     void setCurrentItem(int current);
+    //! The current item is now in \a row, after rows have been moved.
+    //! The selection is not changed.
+    void moveCurrentItem(int row);
     void clearPlayedTag();
+    //! Next item in the shuffle order, or -1 if all have been played
     int chooseRandomItem();
+    //! Starts a new shuffle order with a new seed
+    void reshuffle();
     void swapItems(int item1, int item2);
-    // EDIT BY NEO -->
-    void sortBy(int section, bool revert, int count);
-    // <--
+
+    //! Returns the position of the item with that filename, or -1
+    int findItem(const QString &filename);
+    //! Stores in item_index the rows of the items from \a from to the end
+    void updateIndex(int from);
+    //! Sorts the items by sort_keys. The sort is stable.
+    void sortItems();
     QString lastDir();
 
+    //! Adds the files at \a position (-1 appends them) without updating
+    //! the view. Returns the number of items added.
+    int insertFiles(const QStringList &files, bool get_info, int position);
+    //! Row after the current item if \a file is in its directory and
+    //! pref->add_to_playlist_consecutive_files is set, -1 otherwise
+    int consecutivePosition(const QString &file);
+    void startDirectoryScan(const QString &dir, bool recursive);
+
 protected slots:
     virtual void playCurrent();
     virtual void itemDoubleClicked(int row);
+    virtual void itemActivated(const QModelIndex &index);
     virtual void showPopup(const QPoint &pos);
     virtual void upItem();
     virtual void downItem();
     virtual void editCurrentItem();
     virtual void editItem(int item);
 
+    //! Sets the name and duration of an item with the info from InfoScanner
+    virtual void mediaInfoAvailable(QString filename, MediaData data);
+    //! Marks the items of files which don't exist
+    virtual void filesMissing(QStringList files);
+
+    //! Adds the files found by DirectoryScanner, without updating the view
+    virtual void directoryFilesFound(QStringList files);
+    virtual void directoryScanProgress(int dirs, int files);
+    virtual void directoryScanFinished();
+
     virtual void saveSettings();
     virtual void loadSettings();
 
@@ -236,6 +307,18 @@ protected:
     void createTable();
     void createActions();
     void createToolbar();
+    void createScanStatus();
+
+    //! Replaces the list with the contents of a playlist file.
+    //! \a format is a PlaylistParser::Format.
+    void loadPlaylistFile(QString file, int format);
+    static QString defaultName(const QString &filename);
+
+    QString journalFile();
+    //! Creates the journal with a snapshot of the current list
+    bool openJournal();
+    //! Replaces the journal with a snapshot of the current list
+    bool compactJournal();
 
 protected:
     void retranslateStrings();
@@ -251,6 +334,17 @@ protected:
     PlaylistItemList pl;
     int current_item;
 
+    //! Position of each filename in pl. Kept up to date by every change
+    //! of pl: after an insert or a removal only the rows from there to
+    //! the end are renumbered, after a sort the rows are remapped.
+    QHash<QString, int> item_index;
+
+    //! Current sort order (see sortBy()), saved with the list
+    QList<int> sort_keys;
+
+    //! Order used with shuffle, saved with the list
+    ShuffleOrder shuffle;
+
     QString playlist_path;
     QString latest_dir;
 
@@ -259,7 +353,8 @@ protected:
     QMenu *remove_menu;
     QMenu *popup;
 
-    MyTableWidget *listView;
+    QTableView *listView;
+    PlaylistModel *model;
 
     QToolBar *toolbar;
     QToolButton *add_button;
@@ -287,6 +382,22 @@ protected:
 private:
     bool modified;
     QTimer *save_timer;
+    InfoScanner *info_scanner;
+
+    //! Walks the directories added by addDirectory() in the background
+    DirectoryScanner *dir_scanner;
+    QWidget *scan_status;
+    QLabel *scan_label;
+    QToolButton *scan_stop_button;
+    //! startPlay() was called while the list was still being filled
+    bool start_play_pending;
+    //! Row where the next batch of the scan is inserted, -1 to append.
+    //! It's decided with the first batch.
+    int scan_position;
+    bool scan_position_known;
+
+    //! Saves every change of the list. 0 if the list is not saved.
+    PlaylistJournal *journal;
 
     //Preferences
     bool recursive_add_directory;
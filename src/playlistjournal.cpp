@@ -0,0 +1,495 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "playlistjournal.h"
+#include <QDataStream>
+#include <QByteArray>
+#include <QVector>
+
+// Increase it if the format of the file changes
+#define JOURNAL_MAGIC 0x534d504a // SMPJ
+#define JOURNAL_VERSION 3
+
+// Compact when there are more records than this, and more than twice
+// the number of items
+#define MIN_RECORDS_TO_COMPACT 1000
+
+enum JournalOp {
+    OpSnapshot = 1, OpInsert = 2, OpRemove = 3, OpSwap = 4,
+    OpUpdate = 5, OpCurrent = 6, OpModified = 7,
+    OpShufflePlay = 8, OpShuffleReset = 9, OpInsertItems = 10
+};
+
+static void writeItem(QDataStream &stream, const PlaylistItem &item)
+{
+    stream << item.filename() << item.name() << item.duration();
+}
+
+static PlaylistItem readItem(QDataStream &stream)
+{
+    QString filename, name;
+    double duration;
+    stream >> filename >> name >> duration;
+
+    return PlaylistItem(filename, name, duration);
+}
+
+//! Applies a record to \a state. Returns false if the record is not valid.
+static bool applyRecord(const QByteArray &data, int version, PlaylistJournal::State &state)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    quint8 op;
+    stream >> op;
+
+    QList<PlaylistItem> &pl = state.items;
+
+    switch (op) {
+    case OpSnapshot: {
+        qint32 count, current;
+        bool modified;
+        stream >> count;
+
+        pl.clear();
+
+        for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+            pl.append(readItem(stream));
+        }
+
+        stream >> current >> modified;
+
+        qint32 keys_count;
+        stream >> keys_count;
+
+        state.sort_keys.clear();
+
+        for (int n = 0; (n < keys_count) && (stream.status() == QDataStream::Ok); n++) {
+            qint32 key;
+            stream >> key;
+            state.sort_keys.append(key);
+        }
+
+        state.current_item = current;
+        state.modified = modified;
+
+        // Version 1 had no shuffle order
+        bool shuffle_ok = false;
+
+        if (version >= 2) {
+            qint32 cursor;
+            quint32 random_state;
+            QVector<qint32> rows;
+            stream >> rows >> cursor >> random_state;
+
+            QVector<int> order(rows.count());
+
+            for (int n = 0; n < rows.count(); n++) order[n] = rows[n];
+
+            shuffle_ok = (order.count() == pl.count()) &&
+                         (state.shuffle.restore(order, cursor, random_state));
+        }
+
+        if (!shuffle_ok) state.shuffle.reset(pl.count(), ShuffleOrder::randomSeed());
+
+        break;
+    }
+
+    case OpInsert: {
+        qint32 pos;
+        stream >> pos;
+        PlaylistItem item = readItem(stream);
+
+        if ((pos < 0) || (pos > pl.count())) return false;
+
+        pl.insert(pos, item);
+        state.shuffle.insertRows(pos, 1);
+        break;
+    }
+
+    case OpInsertItems: {
+        qint32 pos, count;
+        stream >> pos >> count;
+
+        if ((pos < 0) || (pos > pl.count()) || (count < 0)) return false;
+
+        QList<PlaylistItem> new_items;
+
+        for (int n = 0; (n < count) && (stream.status() == QDataStream::Ok); n++) {
+            new_items.append(readItem(stream));
+        }
+
+        // Nothing is applied from a damaged record
+        if (stream.status() != QDataStream::Ok) return false;
+
+        for (int n = 0; n < count; n++) pl.insert(pos + n, new_items[n]);
+
+        state.shuffle.insertRows(pos, count);
+        break;
+    }
+
+    case OpRemove: {
+        qint32 first, last;
+        stream >> first >> last;
+
+        if ((first < 0) || (last < first) || (last >= pl.count())) return false;
+
+        for (int n = last; n >= first; n--) pl.removeAt(n);
+
+        state.shuffle.removeRows(first, last);
+        break;
+    }
+
+    case OpSwap: {
+        qint32 item1, item2;
+        stream >> item1 >> item2;
+
+        if ((item1 < 0) || (item2 < 0) || (item1 >= pl.count()) || (item2 >= pl.count())) return false;
+
+        pl.swap(item1, item2);
+        state.shuffle.swapRows(item1, item2);
+        break;
+    }
+
+    case OpUpdate: {
+        qint32 pos;
+        stream >> pos;
+        PlaylistItem item = readItem(stream);
+
+        if ((pos < 0) || (pos >= pl.count())) return false;
+
+        pl[pos].setName(item.name());
+        pl[pos].setDuration(item.duration());
+        break;
+    }
+
+    case OpCurrent: {
+        qint32 current;
+        stream >> current;
+        state.current_item = current;
+        break;
+    }
+
+    case OpModified:
+        stream >> state.modified;
+        break;
+
+    case OpShufflePlay: {
+        qint32 row;
+        stream >> row;
+        state.shuffle.setCurrent(row);
+        break;
+    }
+
+    case OpShuffleReset: {
+        quint32 seed;
+        stream >> seed;
+        state.shuffle.reset(pl.count(), seed);
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+PlaylistJournal::PlaylistJournal(const QString &filename)
+{
+    file.setFileName(filename);
+    records = 0;
+    items = 0;
+    current_item = -1;
+    modified = false;
+}
+
+PlaylistJournal::~PlaylistJournal()
+{
+    file.close();
+}
+
+bool PlaylistJournal::read(const QString &filename, State &state)
+{
+    qDebug("PlaylistJournal::read: '%s'", filename.toUtf8().data());
+
+    QFile f(filename);
+
+    // The program may have died while replacing it
+    if ((!f.exists()) && (QFile::exists(filename + ".new"))) {
+        f.setFileName(filename + ".new");
+    }
+
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_4_4);
+
+    quint32 magic;
+    qint32 version;
+    stream >> magic >> version;
+
+    if ((magic != JOURNAL_MAGIC) || (version < 1) || (version > JOURNAL_VERSION)) {
+        qWarning("PlaylistJournal::read: unknown format, ignoring the file");
+        return false;
+    }
+
+    int count = 0;
+
+    while (!stream.atEnd()) {
+        quint32 size;
+        stream >> size;
+
+        // Truncated
+        if ((stream.status() != QDataStream::Ok) || (size > f.size() - f.pos())) break;
+
+        QByteArray data(size, 0);
+
+        if (stream.readRawData(data.data(), size) != (int) size) break;
+
+        quint16 checksum;
+        stream >> checksum;
+
+        if ((stream.status() != QDataStream::Ok) ||
+            (checksum != qChecksum(data.constData(), data.size()))) {
+            break;
+        }
+
+        // A valid record which can't be applied means the file is wrong
+        if (!applyRecord(data, version, state)) break;
+
+        count++;
+    }
+
+    if (!stream.atEnd()) {
+        qWarning("PlaylistJournal::read: damaged record after %d records, the rest is ignored", count);
+    }
+
+    if ((state.current_item < -1) || (state.current_item >= state.items.count())) {
+        state.current_item = -1;
+    }
+
+    qDebug("PlaylistJournal::read: %d records, %d items", count, state.items.count());
+
+    return (count > 0);
+}
+
+void PlaylistJournal::removeFile(const QString &filename)
+{
+    QFile::remove(filename);
+    QFile::remove(filename + ".new");
+}
+
+bool PlaylistJournal::reset(const State &state)
+{
+    qDebug("PlaylistJournal::reset: %d items", state.items.count());
+
+    file.close();
+
+    QString filename = file.fileName();
+
+    // Written to another file first, so there's always a complete one
+    QFile f(filename + ".new");
+
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("PlaylistJournal::reset: can't write '%s'", f.fileName().toUtf8().data());
+        return false;
+    }
+
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+
+    s << (quint8) OpSnapshot << (qint32) state.items.count();
+
+    for (int n = 0; n < state.items.count(); n++) writeItem(s, state.items[n]);
+
+    s << (qint32) state.current_item << state.modified;
+    s << (qint32) state.sort_keys.count();
+
+    for (int n = 0; n < state.sort_keys.count(); n++) s << (qint32) state.sort_keys[n];
+
+    QVector<int> order = state.shuffle.rows();
+    QVector<qint32> rows(order.count());
+
+    for (int n = 0; n < order.count(); n++) rows[n] = order[n];
+
+    s << rows << (qint32) state.shuffle.cursor() << state.shuffle.randomState();
+
+    QDataStream stream(&f);
+    stream.setVersion(QDataStream::Qt_4_4);
+    stream << (quint32) JOURNAL_MAGIC << (qint32) JOURNAL_VERSION;
+    stream << (quint32) data.size();
+    stream.writeRawData(data.constData(), data.size());
+    stream << qChecksum(data.constData(), data.size());
+
+    bool ok = (f.error() == QFile::NoError);
+    f.close();
+
+    if (!ok) {
+        qWarning("PlaylistJournal::reset: error writing '%s'", f.fileName().toUtf8().data());
+        f.remove();
+        return false;
+    }
+
+    QFile::remove(filename);
+
+    if (!f.rename(filename)) {
+        qWarning("PlaylistJournal::reset: can't rename '%s'", f.fileName().toUtf8().data());
+        return false;
+    }
+
+    records = 0;
+    items = state.items.count();
+    current_item = state.current_item;
+    modified = state.modified;
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning("PlaylistJournal::reset: can't open '%s'", filename.toUtf8().data());
+        return false;
+    }
+
+    return true;
+}
+
+void PlaylistJournal::writeRecord(const QByteArray &data)
+{
+    if (!file.isOpen()) return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_4);
+    stream << (quint32) data.size();
+    stream.writeRawData(data.constData(), data.size());
+    stream << qChecksum(data.constData(), data.size());
+
+    file.flush();
+
+    records++;
+}
+
+void PlaylistJournal::insert(int pos, const PlaylistItem &item)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpInsert << (qint32) pos;
+    writeItem(s, item);
+
+    writeRecord(data);
+    items++;
+}
+
+void PlaylistJournal::insert(int pos, const QList<PlaylistItem> &new_items)
+{
+    if (new_items.isEmpty()) return;
+
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpInsertItems << (qint32) pos << (qint32) new_items.count();
+
+    for (int n = 0; n < new_items.count(); n++) writeItem(s, new_items[n]);
+
+    writeRecord(data);
+    items += new_items.count();
+}
+
+void PlaylistJournal::remove(int first, int last)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpRemove << (qint32) first << (qint32) last;
+
+    writeRecord(data);
+    items -= (last - first + 1);
+}
+
+void PlaylistJournal::swap(int item1, int item2)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpSwap << (qint32) item1 << (qint32) item2;
+
+    writeRecord(data);
+}
+
+void PlaylistJournal::update(int pos, const PlaylistItem &item)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpUpdate << (qint32) pos;
+    writeItem(s, item);
+
+    writeRecord(data);
+}
+
+void PlaylistJournal::setCurrentItem(int n)
+{
+    if (n == current_item) return;
+
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpCurrent << (qint32) n;
+
+    writeRecord(data);
+    current_item = n;
+}
+
+void PlaylistJournal::setModified(bool b)
+{
+    if (b == modified) return;
+
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpModified << b;
+
+    writeRecord(data);
+    modified = b;
+}
+
+void PlaylistJournal::shufflePlay(int row)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpShufflePlay << (qint32) row;
+
+    writeRecord(data);
+}
+
+void PlaylistJournal::shuffleReset(quint32 seed)
+{
+    QByteArray data;
+    QDataStream s(&data, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_4_4);
+    s << (quint8) OpShuffleReset << seed;
+
+    writeRecord(data);
+}
+
+bool PlaylistJournal::needsCompaction()
+{
+    return (records > MIN_RECORDS_TO_COMPACT) && (records > items * 2);
+}
@@ -0,0 +1,107 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _PLAYLISTJOURNAL_H_
+#define _PLAYLISTJOURNAL_H_
+
+#include <QString>
+#include <QList>
+#include <QFile>
+#include "playlist.h"
+#include "shuffleorder.h"
+
+//! PlaylistJournal saves the contents of the playlist incrementally.
+
+/*!
+ The file starts with a snapshot of the whole list, followed by a record
+ for every change made after it (items inserted, removed, swapped or
+ renamed, current item...). Each record is written and flushed as soon
+ as the change happens, so a crash loses nothing but the change being
+ written. Records have a length and a checksum; a truncated or damaged
+ one ends the replay.
+
+ When there are many records compared with the size of the list, the
+ file should be compacted by writing a new snapshot with reset().
+*/
+
+class PlaylistJournal
+{
+
+public:
+    //! What the journal stores about the playlist
+    class State
+    {
+    public:
+        State() {
+            current_item = -1;
+            modified = false;
+        };
+
+        QList<PlaylistItem> items;
+        int current_item;
+        bool modified;
+        QList<int> sort_keys;
+        ShuffleOrder shuffle;
+    };
+
+    PlaylistJournal(const QString &filename);
+    ~PlaylistJournal();
+
+    //! Reads the snapshot and replays the changes after it. Returns false
+    //! if there's no journal or it can't be read.
+    static bool read(const QString &filename, State &state);
+
+    //! Deletes the journal file
+    static void removeFile(const QString &filename);
+
+    //! Replaces the file with a snapshot of \a state
+    bool reset(const State &state);
+
+    void insert(int pos, const PlaylistItem &item);
+    //! Several items inserted together at \a pos, written as one record
+    void insert(int pos, const QList<PlaylistItem> &new_items);
+    void remove(int first, int last);
+    void swap(int item1, int item2);
+    //! The name or duration of the item at \a pos has changed
+    void update(int pos, const PlaylistItem &item);
+    void setCurrentItem(int n);
+    void setModified(bool b);
+
+    //! ShuffleOrder::setCurrent() has been called with \a row
+    void shufflePlay(int row);
+    //! ShuffleOrder::reset() has been called with \a seed
+    void shuffleReset(quint32 seed);
+
+    //! True if the file has many more records than items
+    bool needsCompaction();
+
+protected:
+    void writeRecord(const QByteArray &data);
+
+    QFile file;
+    //! Records written after the last snapshot
+    int records;
+    int items;
+
+    // Last values written, to skip records which don't change anything
+    int current_item;
+    bool modified;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "playlistmodel.h"
+#include <QApplication>
+#include "images.h"
+#include "helper.h"
+
+PlaylistModel::PlaylistModel(const QList<PlaylistItem> *items, QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    this->items = items;
+    current_item = -1;
+
+    updateIcons();
+}
+
+PlaylistModel::~PlaylistModel()
+{
+}
+
+int PlaylistModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+
+    return items->count();
+}
+
+int PlaylistModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+
+    return COL_TIME + 1;
+}
+
+QVariant PlaylistModel::data(const QModelIndex &index, int role) const
+{
+    int row = index.row();
+
+    if ((!index.isValid()) || (row >= items->count())) return QVariant();
+
+    const PlaylistItem &item = items->at(row);
+
+    if (role == Qt::DisplayRole) {
+        if (index.column() == COL_NAME) {
+            if (item.name().isEmpty()) return item.filename();
+
+            return item.name();
+        }
+
+        if (index.column() == COL_TIME) {
+            return Helper::formatTime((int) item.duration());
+        }
+    } else if ((role == Qt::ForegroundRole) && (item.missing())) {
+        // The file doesn't exist
+        return QApplication::palette().color(QPalette::Disabled, QPalette::Text);
+    } else if ((role == Qt::DecorationRole) && (index.column() == COL_PLAY)) {
+        // Only requested for the visible rows
+        if (row == current_item) return play_icon;
+
+        if (item.played()) return played_icon;
+    }
+
+    return QVariant();
+}
+
+QVariant PlaylistModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) &&
+            (section >= 0) && (section < header_labels.count())) {
+        return header_labels[section];
+    }
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags PlaylistModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return 0;
+
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsDragEnabled;
+}
+
+void PlaylistModel::setCurrentItem(int row)
+{
+    int old_current = current_item;
+    current_item = row;
+
+    if ((old_current >= 0) && (old_current < items->count())) {
+        emit dataChanged(index(old_current, COL_PLAY), index(old_current, COL_PLAY));
+    }
+
+    if ((current_item >= 0) && (current_item < items->count())) {
+        emit dataChanged(index(current_item, COL_PLAY), index(current_item, COL_PLAY));
+    }
+}
+
+void PlaylistModel::setHeaderLabels(const QStringList &labels)
+{
+    header_labels = labels;
+    emit headerDataChanged(Qt::Horizontal, 0, COL_TIME);
+}
+
+void PlaylistModel::updateIcons()
+{
+    if (qApp->isLeftToRight()) {
+        play_icon = Images::icon("play");
+    } else {
+        play_icon = Images::flippedIcon("play");
+    }
+
+    played_icon = Images::icon("ok");
+
+    if (!items->isEmpty()) {
+        emit dataChanged(index(0, COL_PLAY), index(items->count() - 1, COL_PLAY));
+    }
+}
+
+void PlaylistModel::beginInsertItems(int first, int last)
+{
+    beginInsertRows(QModelIndex(), first, last);
+}
+
+void PlaylistModel::endInsertItems()
+{
+    endInsertRows();
+}
+
+void PlaylistModel::beginRemoveItems(int first, int last)
+{
+    beginRemoveRows(QModelIndex(), first, last);
+}
+
+void PlaylistModel::endRemoveItems()
+{
+    endRemoveRows();
+}
+
+void PlaylistModel::beginResetItems()
+{
+    beginResetModel();
+}
+
+void PlaylistModel::endResetItems()
+{
+    endResetModel();
+}
+
+void PlaylistModel::itemsChanged(int first, int last)
+{
+    if (first < 0) first = 0;
+
+    if (last >= items->count()) last = items->count() - 1;
+
+    if (first > last) return;
+
+    emit dataChanged(index(first, 0), index(last, COL_TIME));
+}
+
+void PlaylistModel::beginReorderItems()
+{
+    emit layoutAboutToBeChanged();
+}
+
+void PlaylistModel::endReorderItems(const QVector<int> &new_rows)
+{
+    // Keep the selection on the same items
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+
+    for (int n = 0; n < from.count(); n++) {
+        int row = from[n].row();
+
+        if ((row >= 0) && (row < new_rows.count())) {
+            to.append(index(new_rows[row], from[n].column()));
+        } else {
+            to.append(QModelIndex());
+        }
+    }
+
+    changePersistentIndexList(from, to);
+
+    if ((current_item >= 0) && (current_item < new_rows.count())) {
+        current_item = new_rows[current_item];
+    }
+
+    emit layoutChanged();
+}
@@ -0,0 +1,89 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _PLAYLISTMODEL_H_
+#define _PLAYLISTMODEL_H_
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QIcon>
+#include <QVector>
+#include "playlist.h"
+
+#define COL_PLAY 0
+#define COL_NAME 1
+#define COL_TIME 2
+
+//! PlaylistModel shows the items of a Playlist in a QTableView.
+
+/*!
+ The items are not copied, the model reads them from the list owned by
+ Playlist, which must tell the model about every change with the
+ begin/end functions or itemsChanged(). This way the view only repaints
+ the rows which have changed and are visible.
+*/
+
+class PlaylistModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    PlaylistModel(const QList<PlaylistItem> *items, QObject *parent = 0);
+    ~PlaylistModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+
+    //! Row with the play icon
+    void setCurrentItem(int row);
+    int currentItem() {
+        return current_item;
+    };
+
+    void setHeaderLabels(const QStringList &labels);
+
+    //! Loads the icons again, after a change of theme or layout direction
+    void updateIcons();
+
+    // To be called by Playlist when the list changes
+    void beginInsertItems(int first, int last);
+    void endInsertItems();
+    void beginRemoveItems(int first, int last);
+    void endRemoveItems();
+    void beginResetItems();
+    void endResetItems();
+    void itemsChanged(int first, int last);
+
+    //! For changes of the order of the items. \a new_rows has the new
+    //! position of every item, indexed by the old one.
+    void beginReorderItems();
+    void endReorderItems(const QVector<int> &new_rows);
+
+protected:
+    const QList<PlaylistItem> *items;
+    int current_item;
+    QStringList header_labels;
+
+    QIcon play_icon;
+    QIcon played_icon;
+};
+
+#endif
@@ -0,0 +1,310 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "playlistparser.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QUrl>
+#include <QByteArray>
+#include <QTextCodec>
+#include <QXmlStreamReader>
+#include <QMap>
+#include <QTime>
+
+PlaylistParser::Format PlaylistParser::formatOf(const QString &filename)
+{
+    QString extension = QFileInfo(filename).suffix().toLower();
+
+    if (extension == "pls") return PLS;
+
+    if (extension == "xspf") return XSPF;
+
+    return M3U;
+}
+
+bool PlaylistParser::parse(const QString &filename, Format format, QList<PlaylistItem> &items)
+{
+    qDebug("PlaylistParser::parse: '%s'", filename.toUtf8().data());
+
+    QFile f(filename);
+
+    if (!f.open(QIODevice::ReadOnly)) {
+        qDebug("PlaylistParser::parse: can't open '%s'", filename.toUtf8().data());
+        return false;
+    }
+
+    QTime t;
+    t.start();
+
+    // Mapped if possible, otherwise read
+    QByteArray data;
+    uchar *map = (f.size() > 0) ? f.map(0, f.size()) : 0;
+
+    if (map) {
+        data = QByteArray::fromRawData((const char *) map, f.size());
+    } else {
+        data = f.readAll();
+    }
+
+    QString dir = QFileInfo(filename).absolutePath();
+    bool ok = true;
+
+    switch (format) {
+    case PLS:
+        parsePLS(data, dir, items);
+        break;
+
+    case XSPF:
+        ok = parseXSPF(data, dir, items);
+        break;
+
+    default:
+        parseM3U(data, QFileInfo(filename).suffix().toLower() == "m3u8", dir, items);
+    }
+
+    // The data must not be used after unmapping
+    data = QByteArray();
+
+    if (map) f.unmap(map);
+
+    int ms = t.elapsed();
+    qDebug("PlaylistParser::parse: %d items, %lld bytes in %d ms (%.0f items/s)",
+           items.count(), (long long) f.size(), ms, (ms > 0) ? items.count() * 1000.0 / ms : 0.0);
+
+    return ok;
+}
+
+QString PlaylistParser::resolve(const QString &entry, const QString &dir)
+{
+    // Streams, dvd://, etc.
+    if (entry.contains("://")) return entry;
+
+    if (QDir::isRelativePath(entry)) return QDir::cleanPath(dir + "/" + entry);
+
+    return entry;
+}
+
+void PlaylistParser::parseM3U(const QByteArray &data, bool utf8, const QString &dir, QList<PlaylistItem> &items)
+{
+    QTextCodec *codec = utf8 ? QTextCodec::codecForName("UTF-8") : QTextCodec::codecForLocale();
+    QString text = codec->toUnicode(data);
+
+    QString name;
+    double duration = 0;
+
+    int pos = 0;
+    int length = text.length();
+
+    while (pos < length) {
+        int end = text.indexOf('\n', pos);
+
+        if (end < 0) end = length;
+
+        QString line = text.mid(pos, end - pos).trimmed();
+        pos = end + 1;
+
+        if (line.isEmpty()) continue;
+
+        if (line.startsWith('#')) {
+            if (line.startsWith("#EXTINF:")) {
+                // #EXTINF:duration,name (the name may have commas)
+                int comma = line.indexOf(',');
+
+                if (comma > -1) {
+                    duration = line.mid(8, comma - 8).toDouble();
+                    name = line.mid(comma + 1);
+                } else {
+                    duration = line.mid(8).toDouble();
+                }
+            }
+
+            // #EXTM3U and comments are ignored
+            continue;
+        }
+
+        items.append(PlaylistItem(resolve(line, dir), name, duration));
+        name.clear();
+        duration = 0;
+    }
+}
+
+void PlaylistParser::parsePLS(const QByteArray &data, const QString &dir, QList<PlaylistItem> &items)
+{
+    // Usually UTF-8 or just ASCII (QSettings escapes the rest)
+    QString text = QString::fromUtf8(data.constData(), data.size());
+
+    QMap<int, PlaylistItem> entries;
+
+    int pos = 0;
+    int length = text.length();
+
+    while (pos < length) {
+        int end = text.indexOf('\n', pos);
+
+        if (end < 0) end = length;
+
+        QString line = text.mid(pos, end - pos).trimmed();
+        pos = end + 1;
+
+        int equal = line.indexOf('=');
+
+        if (equal < 1) continue;
+
+        QString key = line.left(equal).trimmed().toLower();
+        QString value = unescapeIniValue(line.mid(equal + 1).trimmed());
+
+        // File1, Title1, Length1...
+        int digits = key.length();
+
+        while ((digits > 0) && (key[digits - 1].isDigit())) digits--;
+
+        if (digits == key.length()) continue;
+
+        int n = key.mid(digits).toInt();
+        QString field = key.left(digits);
+
+        if (field == "file") {
+            entries[n].setFilename(resolve(value, dir));
+        } else if (field == "title") {
+            entries[n].setName(value);
+        } else if (field == "length") {
+            double duration = value.toDouble();
+            entries[n].setDuration((duration > 0) ? duration : 0);
+        }
+    }
+
+    QMap<int, PlaylistItem>::const_iterator it;
+
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (!it->filename().isEmpty()) items.append(it.value());
+    }
+}
+
+static bool isHexDigit(QChar c)
+{
+    return (c.isDigit()) || ((c.toLower() >= 'a') && (c.toLower() <= 'f'));
+}
+
+QString PlaylistParser::unescapeIniValue(const QString &value)
+{
+    QString s = value;
+
+    if ((s.length() >= 2) && (s.startsWith('"')) && (s.endsWith('"'))) {
+        s = s.mid(1, s.length() - 2);
+    }
+
+    if (!s.contains('\\')) return s;
+
+    QString r;
+    r.reserve(s.length());
+
+    for (int n = 0; n < s.length(); n++) {
+        QChar c = s[n];
+
+        if ((c != '\\') || (n + 1 >= s.length())) {
+            r += c;
+            continue;
+        }
+
+        QChar next = s[n + 1];
+
+        if ((next == '\\') || (next == '"')) {
+            r += next;
+            n++;
+        } else if (next == 'x') {
+            // \xhhhh
+            int i = n + 2;
+
+            while ((i < s.length()) && (i < n + 6) && (isHexDigit(s[i]))) i++;
+
+            if (i > n + 2) {
+                r += QChar(s.mid(n + 2, i - n - 2).toUShort(0, 16));
+                n = i - 1;
+            } else {
+                r += c;
+            }
+        } else {
+            // Not an escape, like in windows paths
+            r += c;
+        }
+    }
+
+    return r;
+}
+
+bool PlaylistParser::parseXSPF(const QByteArray &data, const QString &dir, QList<PlaylistItem> &items)
+{
+    QXmlStreamReader xml(data);
+
+    PlaylistItem item;
+    QString creator;
+    bool in_track = false;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+
+        if (xml.isStartElement()) {
+            QStringRef tag = xml.name();
+
+            if (tag == "track") {
+                in_track = true;
+                item = PlaylistItem();
+                creator.clear();
+            } else if (in_track) {
+                if (tag == "location") {
+                    QString location = xml.readElementText().trimmed();
+
+                    if (location.startsWith("file:", Qt::CaseInsensitive)) {
+                        item.setFilename(QUrl::fromEncoded(location.toUtf8()).toLocalFile());
+                    } else if (location.contains("://")) {
+                        item.setFilename(location);
+                    } else {
+                        // Relative URI
+                        item.setFilename(resolve(QUrl::fromPercentEncoding(location.toUtf8()), dir));
+                    }
+                } else if (tag == "title") {
+                    item.setName(xml.readElementText().trimmed());
+                } else if (tag == "creator") {
+                    creator = xml.readElementText().trimmed();
+                } else if (tag == "duration") {
+                    // In milliseconds
+                    item.setDuration(xml.readElementText().toDouble() / 1000);
+                }
+            }
+        } else if ((xml.isEndElement()) && (xml.name() == "track")) {
+            in_track = false;
+
+            if (!item.filename().isEmpty()) {
+                if ((!creator.isEmpty()) && (!item.name().isEmpty())) {
+                    item.setName(creator + " - " + item.name());
+                }
+
+                items.append(item);
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        qWarning("PlaylistParser::parseXSPF: %s (line %lld)", xml.errorString().toUtf8().data(), (long long) xml.lineNumber());
+    }
+
+    // What was read before the error is kept
+    return (!xml.hasError()) || (!items.isEmpty());
+}
@@ -0,0 +1,67 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _PLAYLISTPARSER_H_
+#define _PLAYLISTPARSER_H_
+
+#include <QString>
+#include <QList>
+#include "playlist.h"
+
+class QByteArray;
+
+//! PlaylistParser reads playlist files (m3u, m3u8, pls and xspf).
+
+/*!
+ The file is mapped in memory and decoded at once, then the entries are
+ found by looking at the start of each line (or with a stream reader
+ for xspf), without regular expressions.
+
+ The files are not checked, so a playlist with thousands of entries on a
+ slow disk loads quickly. Relative paths are resolved against the
+ directory of the playlist.
+*/
+
+class PlaylistParser
+{
+
+public:
+    enum Format { M3U = 0, PLS = 1, XSPF = 2 };
+
+    //! Guesses the format by the extension of \a filename
+    static Format formatOf(const QString &filename);
+
+    //! Reads the entries of the playlist. Returns false if the file
+    //! can't be read.
+    static bool parse(const QString &filename, Format format, QList<PlaylistItem> &items);
+
+    static void parseM3U(const QByteArray &data, bool utf8, const QString &dir, QList<PlaylistItem> &items);
+    static void parsePLS(const QByteArray &data, const QString &dir, QList<PlaylistItem> &items);
+    static bool parseXSPF(const QByteArray &data, const QString &dir, QList<PlaylistItem> &items);
+
+protected:
+    //! Returns the absolute path of an entry, or the entry itself if
+    //! it's a URL
+    static QString resolve(const QString &entry, const QString &dir);
+
+    //! Undoes the escaping used by QSettings in ini files
+    static QString unescapeIniValue(const QString &value);
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "positiontracker.h"
+#include <QtAlgorithms>
+#include <QList>
+#include <QPair>
+#include <cmath>
+
+PositionTracker::PositionTracker()
+{
+    chapter_hint = -1;
+    reset();
+}
+
+void PositionTracker::reset()
+{
+    last_second = -1;
+    last_chapter = -1;
+    last_position = -1;
+    chapter_hint = -1;
+}
+
+bool PositionTracker::publishSecond(double sec)
+{
+    int second = (int) floor(sec);
+
+    if (second == last_second) return false;
+
+    last_second = second;
+    return true;
+}
+
+bool PositionTracker::publishChapter(int chapter)
+{
+    if (chapter == last_chapter) return false;
+
+    last_chapter = chapter;
+    return true;
+}
+
+bool PositionTracker::publishPosition(int value)
+{
+    if (value == last_position) return false;
+
+    last_position = value;
+    return true;
+}
+
+void PositionTracker::setChapters(const QMap<int, long long> &timestamps)
+{
+    QList< QPair<long long, int> > chapters;
+    QMap<int, long long>::const_iterator i;
+
+    for (i = timestamps.constBegin(); i != timestamps.constEnd(); ++i) {
+        chapters.append(qMakePair(i.value(), i.key()));
+    }
+
+    // The map is sorted by ID, keep that order for chapters with the same start
+    qStableSort(chapters.begin(), chapters.end());
+
+    chapter_starts.resize(chapters.count());
+    chapter_ids.resize(chapters.count());
+
+    for (int n = 0; n < chapters.count(); n++) {
+        chapter_starts[n] = chapters[n].first;
+        chapter_ids[n] = chapters[n].second;
+    }
+
+    chapter_hint = -1;
+}
+
+int PositionTracker::chapterAt(long long ms)
+{
+    int count = chapter_starts.count();
+
+    if ((count == 0) || (ms < chapter_starts[0])) return -1;
+
+    // Most of the time we're still in the same chapter or just entered the next one
+    int h = chapter_hint;
+
+    if ((h >= 0) && (h < count) && (chapter_starts[h] <= ms)) {
+        if ((h + 1 == count) || (ms < chapter_starts[h + 1])) {
+            return chapter_ids[h];
+        }
+
+        if ((h + 2 == count) || (ms < chapter_starts[h + 2])) {
+            chapter_hint = h + 1;
+            return chapter_ids[chapter_hint];
+        }
+    }
+
+    // Otherwise (after a seek) do a binary search
+    const long long *begin = chapter_starts.constData();
+    chapter_hint = (qUpperBound(begin, begin + count, ms) - begin) - 1;
+
+    return chapter_ids[chapter_hint];
+}
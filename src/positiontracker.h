@@ -0,0 +1,91 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _POSITIONTRACKER_H_
+#define _POSITIONTRACKER_H_
+
+#include <QVector>
+#include <QMap>
+
+//! PositionTracker remembers the last playback position published by Core.
+
+/*!
+ It holds the last second, chapter and seek bar value sent to the GUI, so
+ Core only emits them when they have really changed. It must be reset when
+ a new file starts to play and on every seek, otherwise the first update
+ after jumping back inside the same second would be lost.
+
+ The rate of the updates is already limited by MplayerProcess, so every
+ new seek bar value is published.
+
+ It also keeps the start time of the chapters sorted in an array, so the
+ current chapter can be found on every update without scanning them all.
+*/
+
+class PositionTracker
+{
+
+public:
+    PositionTracker();
+
+    //! Forget the published values, so the next ones will be sent
+    void reset();
+
+    //! Return true if \a sec is in a different second than the last
+    //! published one, and remember it.
+    bool publishSecond(double sec);
+
+    //! Return true if \a chapter is different from the last published
+    //! one, and remember it.
+    bool publishChapter(int chapter);
+
+    //! Return true if \a value is different from the last published seek
+    //! bar value, and remember it.
+    bool publishPosition(int value);
+
+    //! Set the chapters of the file. \a timestamps maps the chapter ID
+    //! to its start time in ms, as in MediaData::chapters_timestamp.
+    void setChapters(const QMap<int, long long> &timestamps);
+
+    //! Return the ID of the chapter playing at \a ms, or -1 if there are
+    //! no chapters or \a ms is before the first one.
+    int chapterAt(long long ms);
+
+    int lastSecond() {
+        return last_second;
+    };
+    int lastChapter() {
+        return last_chapter;
+    };
+    int lastPosition() {
+        return last_position;
+    };
+
+protected:
+    int last_second;
+    int last_chapter;
+    int last_position;
+
+    //! Chapter start times sorted in ascending order, and their IDs
+    QVector<long long> chapter_starts;
+    QVector<int> chapter_ids;
+    //! Index of the chapter found in the previous lookup
+    int chapter_hint;
+};
+
+#endif
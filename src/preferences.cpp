@@ -122,7 +122,7 @@ void Preferences::reset()
     osd = Seek;
     osd_delay = 2200;
 
-    file_settings_method = "hash"; // Possible values: normal & hash
+    file_settings_method = "indexed"; // Possible values: normal, hash & indexed
 
 
     /* ***************
@@ -164,6 +164,10 @@ void Preferences::reset()
 
     threads = 0;
 
+    position_update_rate = 10;
+    reuse_mplayer_process = false;
+    media_info_cache_size = 5000;
+
     cache_for_files = 0;
     cache_for_streams = 1000;
     cache_for_dvds = 0; // not recommended to use cache for dvds
@@ -226,6 +230,8 @@ void Preferences::reset()
     log_filter = ".*";
     verbose_log = false;
     save_smplayer2_log = false;
+    log_max_lines = 10000;
+    log_levels = "";
 
     //mplayer log autosaving
     autosave_mplayer_log = false;
@@ -528,6 +534,10 @@ void Preferences::save()
 
     set->setValue("lavdthreads", threads);
 
+    set->setValue("position_update_rate", position_update_rate);
+    set->setValue("reuse_mplayer_process", reuse_mplayer_process);
+    set->setValue("media_info_cache_size", media_info_cache_size);
+
     set->setValue("cache_for_files", cache_for_files);
     set->setValue("cache_for_streams", cache_for_streams);
     set->setValue("cache_for_dvds", cache_for_dvds);
@@ -597,6 +607,8 @@ void Preferences::save()
     set->setValue("log_filter", log_filter);
     set->setValue("verbose_log", verbose_log);
     set->setValue("save_smplayer2_log", save_smplayer2_log);
+    set->setValue("log_max_lines", log_max_lines);
+    set->setValue("log_levels", log_levels);
 
     //mplayer log autosaving
     set->setValue("autosave_mplayer_log", autosave_mplayer_log);
@@ -901,6 +913,11 @@ void Preferences::load()
 
     threads = set->value("lavdthreads", threads).toInt();
 
+    // More than 1000 would make the interval of the timer 0 ms
+    position_update_rate = qBound(0, set->value("position_update_rate", position_update_rate).toInt(), 1000);
+    reuse_mplayer_process = set->value("reuse_mplayer_process", reuse_mplayer_process).toBool();
+    media_info_cache_size = set->value("media_info_cache_size", media_info_cache_size).toInt();
+
     cache_for_files = set->value("cache_for_files", cache_for_files).toInt();
     cache_for_streams = set->value("cache_for_streams", cache_for_streams).toInt();
     cache_for_dvds = set->value("cache_for_dvds", cache_for_dvds).toInt();
@@ -978,6 +995,8 @@ void Preferences::load()
     log_filter = set->value("log_filter", log_filter).toString();
     verbose_log = set->value("verbose_log", verbose_log).toBool();
     save_smplayer2_log = set->value("save_smplayer2_log", save_smplayer2_log).toBool();
+    log_max_lines = set->value("log_max_lines", log_max_lines).toInt();
+    log_levels = set->value("log_levels", log_levels).toString();
 
     //mplayer log autosaving
     autosave_mplayer_log = set->value("autosave_mplayer_log", autosave_mplayer_log).toBool();
@@ -162,6 +162,20 @@ public:
 
     int threads; //!< number of threads to use for decoding (-lavdopts threads <1-16>)
 
+    //! Maximum number of times per second the playback position is sent
+    //! to the GUI, between 0 and 1000. If 0, it's sent for every status
+    //! line of mplayer.
+    int position_update_rate;
+
+    //! If true, a new file of the playlist is loaded with the loadfile
+    //! slave command in the running mplayer2 process, instead of starting
+    //! a new one, as long as the command line options are the same.
+    bool reuse_mplayer_process;
+
+    //! Maximum number of files in the cache of media info (duration,
+    //! tracks...). The ones not used for longer are removed first.
+    int media_info_cache_size;
+
     int cache_for_files;
     int cache_for_streams;
     int cache_for_dvds;
@@ -224,6 +238,11 @@ public:
     QString log_filter;
     bool verbose_log;
     bool save_smplayer2_log;
+    //! Lines kept in memory for each log, the oldest ones are dropped
+    int log_max_lines;
+    //! Level of the debug messages of each subsystem, like
+    //! "process=verbose,gui=quiet". See loglevels.h
+    QString log_levels;
 
     //mplayer log autosaving
     bool autosave_mplayer_log;
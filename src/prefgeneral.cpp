@@ -115,6 +115,7 @@ void PrefGeneral::retranslateStrings()
     filesettings_method_combo->clear();
     filesettings_method_combo->addItem(tr("one ini file"), "normal");
     filesettings_method_combo->addItem(tr("multiple ini files"), "hash");
+    filesettings_method_combo->addItem(tr("single indexed file"), "indexed");
     filesettings_method_combo->setCurrentIndex(filesettings_method_item);
 
     updateDriverCombos();
@@ -221,11 +222,8 @@ void PrefGeneral::getData(Preferences *pref)
         pref->mplayer_bin = mplayerPath();
 
         qDebug("PrefGeneral::getData: mplayer binary has changed, getting version number");
-        // Forces to get info from mplayer to update version number
-        InfoReader i(pref->mplayer_bin);
-        i.getInfo();
-        // Update the drivers list at the same time
-        //setDrivers( i.voList(), i.aoList() );
+        // Takes the info from the cache, or gets it in the background
+        InfoReader::obj()->setMplayerBin(pref->mplayer_bin);
     }
 
     TEST_AND_SET(pref->screenshot_directory, screenshotDir());
@@ -865,8 +863,11 @@ void PrefGeneral::createHelp()
                  tr("<b>one ini file</b>: the settings for all played files will be "
                     "saved in a single ini file (%1)").arg(QString("<i>" + Paths::iniPath() + "/smplayer2.ini</i>")) + "</li><li>" +
                  tr("<b>multiple ini files</b>: one ini file will be used for each played file. "
-                    "Those ini files will be saved in the folder %1").arg(QString("<i>" + Paths::iniPath() + "/file_settings</i>")) + "</li></ul>" +
-                 tr("The latter method could be faster if there is info for a lot of files."));
+                    "Those ini files will be saved in the folder %1").arg(QString("<i>" + Paths::iniPath() + "/file_settings</i>")) + "</li><li>" +
+                 tr("<b>single indexed file</b>: the settings for all played files will be "
+                    "saved in %1, which is fast even with a lot of files. The settings saved "
+                    "with the other methods are imported the first time.").arg(QString("<i>" + Paths::iniPath() + "/smplayer2_filesettings.dat</i>")) + "</li></ul>" +
+                 tr("The last method is the fastest if there is info for a lot of files."));
 
     setWhatsThis(screenshot_edit, tr("Screenshots folder"),
                  tr("Here you can specify a folder where the screenshots taken by "
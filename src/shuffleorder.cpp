@@ -0,0 +1,216 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "shuffleorder.h"
+#include <QDateTime>
+
+ShuffleOrder::ShuffleOrder()
+{
+    pos = -1;
+    rng = 1;
+    index_valid = true;
+}
+
+quint32 ShuffleOrder::randomSeed()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    return now.toTime_t() * 1000 + now.time().msec();
+}
+
+void ShuffleOrder::reset(int count, quint32 seed)
+{
+    qDebug("ShuffleOrder::reset: %d rows, seed %u", count, seed);
+
+    // xorshift doesn't work with 0
+    rng = (seed != 0) ? seed : 0x9e3779b9;
+
+    order.resize(count);
+
+    for (int n = 0; n < count; n++) order[n] = n;
+
+    // Fisher-Yates
+    for (int n = count - 1; n > 0; n--) {
+        int j = random(n + 1);
+        qSwap(order[n], order[j]);
+    }
+
+    pos = -1;
+    index_valid = false;
+}
+
+void ShuffleOrder::reshuffle()
+{
+    reset(order.count(), randomSeed());
+}
+
+int ShuffleOrder::random(int n)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+
+    return (int)(rng % (quint32) n);
+}
+
+int ShuffleOrder::indexOf(int row) const
+{
+    if (!index_valid) {
+        index.resize(order.count());
+
+        for (int n = 0; n < order.count(); n++) index[order[n]] = n;
+
+        index_valid = true;
+    }
+
+    if ((row < 0) || (row >= index.count())) return -1;
+
+    return index[row];
+}
+
+int ShuffleOrder::next() const
+{
+    if (pos + 1 < order.count()) return order[pos + 1];
+
+    return -1;
+}
+
+int ShuffleOrder::previous() const
+{
+    if ((pos > 0) && (pos <= order.count())) return order[pos - 1];
+
+    return -1;
+}
+
+void ShuffleOrder::setCurrent(int row)
+{
+    int i = indexOf(row);
+
+    if (i < 0) return;
+
+    if (i > pos) {
+        // Not played yet, it goes next
+        if (i != pos + 1) {
+            qSwap(order[i], order[pos + 1]);
+            index[order[i]] = i;
+            index[order[pos + 1]] = pos + 1;
+        }
+
+        pos++;
+    } else {
+        pos = i;
+    }
+}
+
+void ShuffleOrder::insertRows(int row, int count)
+{
+    if (count < 1) return;
+
+    int old_count = order.count();
+
+    // The rows after it have moved
+    if (row < old_count) {
+        for (int n = 0; n < old_count; n++) {
+            if (order[n] >= row) order[n] += count;
+        }
+    }
+
+    order.resize(old_count + count);
+
+    // Inside-out Fisher-Yates, only among the rows not played yet
+    for (int n = old_count; n < order.count(); n++) {
+        int first = pos + 1;
+        int j = first + random(n - first + 1);
+
+        order[n] = order[j];
+        order[j] = row + (n - old_count);
+    }
+
+    index_valid = false;
+}
+
+void ShuffleOrder::removeRows(int first, int last)
+{
+    int removed = last - first + 1;
+
+    if (removed < 1) return;
+
+    int new_pos = pos;
+    int j = 0;
+
+    for (int n = 0; n < order.count(); n++) {
+        int r = order[n];
+
+        if ((r >= first) && (r <= last)) {
+            if (n <= pos) new_pos--;
+
+            continue;
+        }
+
+        order[j++] = (r > last) ? r - removed : r;
+    }
+
+    order.resize(j);
+    pos = qMax(new_pos, -1);
+    index_valid = false;
+}
+
+void ShuffleOrder::swapRows(int row1, int row2)
+{
+    int i1 = indexOf(row1);
+    int i2 = indexOf(row2);
+
+    if ((i1 < 0) || (i2 < 0)) return;
+
+    order[i1] = row2;
+    order[i2] = row1;
+    index[row1] = i2;
+    index[row2] = i1;
+}
+
+void ShuffleOrder::moveRows(const QVector<int> &new_rows)
+{
+    if (new_rows.count() != order.count()) return;
+
+    for (int n = 0; n < order.count(); n++) order[n] = new_rows[order[n]];
+
+    index_valid = false;
+}
+
+bool ShuffleOrder::restore(const QVector<int> &rows, int cursor, quint32 random_state)
+{
+    // Must have every row once
+    QVector<bool> seen(rows.count(), false);
+
+    for (int n = 0; n < rows.count(); n++) {
+        int r = rows[n];
+
+        if ((r < 0) || (r >= rows.count()) || (seen[r])) return false;
+
+        seen[r] = true;
+    }
+
+    if ((cursor < -1) || (cursor >= rows.count())) return false;
+
+    order = rows;
+    pos = cursor;
+    rng = (random_state != 0) ? random_state : 0x9e3779b9;
+    index_valid = false;
+
+    return true;
+}
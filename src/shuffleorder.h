@@ -0,0 +1,110 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _SHUFFLEORDER_H_
+#define _SHUFFLEORDER_H_
+
+#include <QVector>
+
+//! ShuffleOrder is the order in which the playlist is played with shuffle.
+
+/*!
+ It's a random permutation of the rows of the playlist, made with the
+ Fisher-Yates algorithm and a generator with a known seed, so the same
+ seed gives the same order. The items before the cursor have been
+ played (the history, walked back by previous()), the ones after it
+ are still to be played.
+
+ It's kept up to date as rows are inserted, removed or moved, without
+ shuffling everything again: new rows are put in random positions
+ after the cursor.
+
+ All the changes are deterministic, so replaying the same operations on
+ a copy with the same state gives the same order (see PlaylistJournal).
+*/
+
+class ShuffleOrder
+{
+
+public:
+    ShuffleOrder();
+
+    //! Makes a new order for \a count rows with \a seed
+    void reset(int count, quint32 seed);
+    //! A new order for the same rows with a new random seed
+    void reshuffle();
+
+    //! Returns a seed taken from the clock
+    static quint32 randomSeed();
+
+    int count() const {
+        return order.count();
+    };
+
+    //! Next row to play, or -1 if all have been played
+    int next() const;
+    //! Previously played row, or -1 if there's none
+    int previous() const;
+
+    //! The row is being played. If it was still to be played, it's moved
+    //! to the end of the history; if it was in the history, the cursor
+    //! goes back to it.
+    void setCurrent(int row);
+
+    //! \a count rows have been inserted at \a row
+    void insertRows(int row, int count);
+    //! The rows from \a first to \a last have been removed
+    void removeRows(int first, int last);
+    void swapRows(int row1, int row2);
+    //! The rows have been reordered. \a new_rows has the new position of
+    //! every row, indexed by the old one.
+    void moveRows(const QVector<int> &new_rows);
+
+    // For saving and restoring it
+    QVector<int> rows() const {
+        return order;
+    };
+    int cursor() const {
+        return pos;
+    };
+    quint32 randomState() const {
+        return rng;
+    };
+    //! Returns false (and keeps the current state) if the data is not a
+    //! valid permutation
+    bool restore(const QVector<int> &rows, int cursor, quint32 random_state);
+
+protected:
+    //! Random number from 0 to \a n - 1
+    int random(int n);
+    int indexOf(int row) const;
+
+    //! Rows in the order they are played
+    QVector<int> order;
+    //! Position in order of the current row, -1 before the first one
+    int pos;
+    //! State of the random number generator (xorshift)
+    quint32 rng;
+
+    //! Position in order of every row, rebuilt when needed
+    mutable QVector<int> index;
+    mutable bool index_valid;
+};
+
+#endif
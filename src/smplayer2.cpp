@@ -26,6 +26,7 @@
 #include "config.h"
 #include "myclient.h"
 #include "clhelp.h"
+#include "inforeader.h"
 
 #include <QDir>
 #include <QApplication>
@@ -84,6 +85,9 @@ BaseGui *SMPlayer2::gui()
         qDebug("SMPlayer2::gui: changed working directory to app path");
         qDebug("SMPlayer2::gui: current directory: %s", QDir::currentPath().toUtf8().data());
 
+        // Load the info about mplayer now, so the dialogs don't have to wait
+        InfoReader::preload();
+
         if (gui_to_use.toLower() == "minigui")
             main_window = new MiniGui(use_control_server, 0);
         else if (gui_to_use.toLower() == "mpcgui")
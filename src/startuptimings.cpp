@@ -0,0 +1,176 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "startuptimings.h"
+#include "mediadata.h"
+#include <QtAlgorithms>
+
+StartupTimings::StartupTimings()
+{
+    active = false;
+    type = TYPE_UNKNOWN;
+    last_type = TYPE_UNKNOWN;
+    history_size = 200;
+}
+
+void StartupTimings::begin(const QString &filename)
+{
+    this->filename = filename;
+    type = TYPE_UNKNOWN;
+    times.fill(-1, NumStages);
+    active = true;
+    timer.start();
+}
+
+void StartupTimings::cancel()
+{
+    active = false;
+}
+
+bool StartupTimings::mark(Stage stage)
+{
+    if (!active) return false;
+
+    if (times[stage] == -1) {
+        times[stage] = timer.elapsed();
+    }
+
+    // The position and finishRestart() may arrive in any order
+    if ((times[FirstPosition] != -1) && (times[FinishRestart] != -1)) {
+        finish();
+        return true;
+    }
+
+    return false;
+}
+
+void StartupTimings::finish()
+{
+    active = false;
+
+    last_filename = filename;
+    last_type = type;
+    last_times = times;
+
+    QList<QVector<int> > &h = history[type];
+    h.append(times);
+
+    while (h.count() > history_size) {
+        h.removeFirst();
+    }
+}
+
+QString StartupTimings::lastToString()
+{
+    if (last_times.isEmpty()) return QString();
+
+    QString s = QString("'%1' (%2):").arg(last_filename).arg(typeName(last_type));
+
+    for (int n = 0; n < NumStages; n++) {
+        if (last_times[n] != -1) {
+            s += QString(" %1 %2 ms,").arg(stageName(n)).arg(last_times[n]);
+        }
+    }
+
+    s.chop(1);
+    return s;
+}
+
+QString StartupTimings::report()
+{
+    QString s = QString("%1\t%2\t%3\t%4\t%5\t%6\r\n")
+                .arg("Type").arg("Stage").arg("Count").arg("p50").arg("p90").arg("p99");
+
+    QMap<int, QList<QVector<int> > >::const_iterator it;
+
+    for (it = history.constBegin(); it != history.constEnd(); ++it) {
+        for (int stage = 0; stage < NumStages; stage++) {
+            QList<int> values;
+
+            for (int n = 0; n < it.value().count(); n++) {
+                int ms = it.value()[n][stage];
+
+                if (ms != -1) values.append(ms);
+            }
+
+            if (values.isEmpty()) continue;
+
+            qSort(values);
+
+            s += QString("%1\t%2\t%3\t%4\t%5\t%6\r\n")
+                 .arg(typeName(it.key())).arg(stageName(stage))
+                 .arg(values.count())
+                 .arg(percentile(values, 50))
+                 .arg(percentile(values, 90))
+                 .arg(percentile(values, 99));
+        }
+    }
+
+    return s;
+}
+
+int StartupTimings::percentile(const QList<int> &values, int p)
+{
+    int rank = (p * values.count() + 99) / 100;   // ceil(p * count / 100)
+
+    return values[qBound(0, rank - 1, values.count() - 1)];
+}
+
+QString StartupTimings::stageName(int stage)
+{
+    switch (stage) {
+    case Open:
+        return "open";
+    case Prepare:
+        return "prepare";
+    case Arguments:
+        return "arguments";
+    case Spawn:
+        return "spawn";
+    case FirstIdLine:
+        return "first_id";
+    case FullyLoaded:
+        return "loaded";
+    case FirstPosition:
+        return "first_position";
+    case FinishRestart:
+        return "finish_restart";
+    default:
+        return QString::number(stage);
+    }
+}
+
+QString StartupTimings::typeName(int media_type)
+{
+    switch (media_type) {
+    case TYPE_FILE:
+        return "file";
+    case TYPE_DVD:
+        return "dvd";
+    case TYPE_STREAM:
+        return "stream";
+    case TYPE_VCD:
+        return "vcd";
+    case TYPE_AUDIO_CD:
+        return "audio_cd";
+    case TYPE_TV:
+        return "tv";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,115 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _STARTUPTIMINGS_H_
+#define _STARTUPTIMINGS_H_
+
+#include <QTime>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QMap>
+
+//! StartupTimings measures how long each stage of opening a file takes.
+
+/*!
+ Core calls begin() when a file is opened and mark() when each stage is
+ reached, which stores the ms elapsed since begin(). Once the first
+ position has been received and finishRestart() has run, the times are
+ added to the history of the media type (TYPE_FILE, TYPE_STREAM...),
+ which keeps the last historySize() opens to calculate percentiles.
+
+ Restarts of the same file are not timed, only the stages reached after
+ begin() are recorded.
+*/
+
+class StartupTimings
+{
+
+public:
+    //! Open: the media has been identified and its open function called.
+    //! Prepare: previous file saved and settings loaded (playNewFile).
+    //! Arguments: mplayer command line ready. Spawn: process started
+    //! (or file sent to the running one). FinishRestart: the GUI has
+    //! been updated for the new file.
+    enum Stage { Open = 0, Prepare = 1, Arguments = 2, Spawn = 3,
+                 FirstIdLine = 4, FullyLoaded = 5, FirstPosition = 6,
+                 FinishRestart = 7, NumStages = 8
+               };
+
+    StartupTimings();
+
+    //! Starts timing a new open, the previous one is discarded if it
+    //! hasn't finished.
+    void begin(const QString &filename);
+    void cancel();
+
+    //! Type of the media being opened, known once it's been identified
+    void setMediaType(int media_type) {
+        type = media_type;
+    };
+
+    bool isActive() {
+        return active;
+    };
+
+    //! Stores the time of \a stage, if it's the first time it's reached.
+    //! Returns true if the open has just finished with this stage.
+    bool mark(Stage stage);
+
+    //! Times of the last finished open, in one line
+    QString lastToString();
+
+    //! Percentiles of each stage by media type, one tab separated line
+    //! per type and stage.
+    QString report();
+
+    void setHistorySize(int n) {
+        history_size = n;
+    };
+    int historySize() {
+        return history_size;
+    };
+
+    static QString stageName(int stage);
+    static QString typeName(int media_type);
+
+protected:
+    //! Adds the current times to the history and stops timing
+    void finish();
+    //! Nearest rank percentile of the sorted list \a values
+    static int percentile(const QList<int> &values, int p);
+
+    QTime timer;
+    bool active;
+    QString filename;
+    int type;
+    //! ms since begin() of each stage, -1 if it hasn't been reached
+    QVector<int> times;
+
+    QString last_filename;
+    int last_type;
+    QVector<int> last_times;
+
+    //! Times of the last opens by media type, oldest first
+    QMap<int, QList<QVector<int> > > history;
+    int history_size;
+};
+
+#endif
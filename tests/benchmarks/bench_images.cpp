@@ -0,0 +1,192 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/*
+ Loads the icons used by BaseGui::retranslateStrings(), the first time
+ (decoding them), from the cache, and after changing the iconset.
+ Needs a display, QPixmap is used.
+*/
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QPixmapCache>
+#include <QStringList>
+
+#include "images.h"
+#include "global.h"
+#include "preferences.h"
+#include "paths.h"
+#include "testinit.h"
+
+using namespace Global;
+
+static const char *icon_names[] = {
+    "logo", "open", "openfolder", "open_playlist", "vcd", "cdda", "dvd", "dvd_hd",
+    "url", "close", "play", "pause", "stop", "frame_step", "play_pause", "a_marker",
+    "b_marker", "clear_markers", "repeat", "jumpto", "fullscreen", "compact",
+    "equalizer", "screenshot", "screenshots", "flip", "mirror", "motion_vectors",
+    "letterbox", "upscaling", "audio_equalizer", "volume", "mute", "audio_down",
+    "audio_up", "delay_down", "delay_up", "audio_delay", "unload", "sub_delay",
+    "dec_sub_scale", "inc_sub_scale", "dec_sub_step", "inc_sub_step", "forced_subs",
+    "sub_visibility", "download_subs", "upload_subs", "playlist", "info", "prefs",
+    "cl_help", "logo_small", "next", "previous", "next_aspect", "next_wheel_function",
+    "open_menu", "play_menu", "video_menu", "audio_menu", "subtitles_menu",
+    "browse_menu", "options_menu", "help_menu", "recents", "delete", "open_disc",
+    "open_favorites", "open_tv", "open_radio", "speed", "ab_menu", "video_track",
+    "video_size", "panscan", "zoom", "aspect", "deinterlace", "video_filters",
+    "rotate", "ontop", "screen", "denoise", "audio_track", "audio_filters",
+    "audio_channels", "stereo_mode", "sub", "closed_caption", "title", "chapter",
+    "edition", "angle", "program_track", "dvdnav_up", "dvdnav_down", "dvdnav_left",
+    "dvdnav_right", "dvdnav_menu", "dvdnav_select", "dvdnav_prev", "dvdnav_mouse",
+    "osd", "logs", 0
+};
+
+// Two iconsets with a copy of the built-in icons
+#define ICONSET_1 "bench_images_1"
+#define ICONSET_2 "bench_images_2"
+
+class BenchImages : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void coldIcons();
+    void cachedIcons();
+    void switchIconset();
+
+private:
+    void createIconset(const QString &name);
+    void removeIconset(const QString &name);
+    int loadIcons();
+
+    QStringList names;
+    //! Icons found, not all of the names have one
+    int expected;
+};
+
+void BenchImages::initTestCase()
+{
+    quietDebugMessages();
+    initTestGlobals();
+
+    for (int n = 0; icon_names[n]; n++) names << icon_names[n];
+
+    createIconset(ICONSET_1);
+    createIconset(ICONSET_2);
+
+    pref->iconset = ICONSET_1;
+    expected = loadIcons();
+    QVERIFY(expected > 0);
+}
+
+void BenchImages::cleanupTestCase()
+{
+    pref->iconset = "";
+
+    removeIconset(ICONSET_1);
+    removeIconset(ICONSET_2);
+
+    Global::global_end();
+}
+
+void BenchImages::createIconset(const QString &name)
+{
+    QString dir = Paths::configPath() + "/themes/" + name;
+    QVERIFY(QDir().mkpath(dir));
+
+    // Not every name has a built-in icon
+    for (int n = 0; n < names.count(); n++) {
+        QString file = names[n] + ".png";
+        QFile::remove(dir + "/" + file);
+
+        if (QFile::exists(":/icons-png/" + file)) QFile::copy(":/icons-png/" + file, dir + "/" + file);
+    }
+}
+
+void BenchImages::removeIconset(const QString &name)
+{
+    QDir dir(Paths::configPath() + "/themes/" + name);
+    QStringList files = dir.entryList(QDir::Files);
+
+    for (int n = 0; n < files.count(); n++) dir.remove(files[n]);
+
+    QDir().rmdir(dir.path());
+}
+
+//! Returns the number of icons found
+int BenchImages::loadIcons()
+{
+    int found = 0;
+
+    for (int n = 0; n < names.count(); n++) {
+        if (!Images::icon(names[n]).isNull()) found++;
+    }
+
+    // Like retranslateStrings()
+    if (!Images::icon("logo", 64).isNull()) found++;
+
+    return found;
+}
+
+// Every icon is decoded again, what was done on each call before the cache
+void BenchImages::coldIcons()
+{
+    int found = 0;
+
+    QBENCHMARK {
+        QPixmapCache::clear();
+        found = loadIcons();
+    }
+
+    QCOMPARE(found, expected);
+}
+
+void BenchImages::cachedIcons()
+{
+    int found = loadIcons();
+
+    QBENCHMARK {
+        found = loadIcons();
+    }
+
+    QCOMPARE(found, expected);
+}
+
+// The files of the new iconset are listed and the icons decoded
+void BenchImages::switchIconset()
+{
+    int found = 0;
+
+    QBENCHMARK {
+        pref->iconset = (pref->iconset == ICONSET_1) ? ICONSET_2 : ICONSET_1;
+        QPixmapCache::clear();
+        found = loadIcons();
+    }
+
+    pref->iconset = ICONSET_1;
+
+    QCOMPARE(found, expected);
+}
+
+QTEST_MAIN(BenchImages)
+
+#include "bench_images.moc"
@@ -0,0 +1,117 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Throughput of OSParser::calculateHash(), with a big file (only its
+ first and last blocks are read) and with many small files.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+
+#include "findsubtitles/osparser.h"
+#include "testinit.h"
+
+#define BIG_FILE_SIZE (64 * 1024 * 1024)
+#define SMALL_FILE_COUNT 500
+#define SMALL_FILE_SIZE 10000
+
+class BenchOSParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void bigFile();
+    void smallFiles();
+
+private:
+    QString dir;
+    QStringList small_files;
+};
+
+void BenchOSParser::initTestCase()
+{
+    quietDebugMessages();
+
+    dir = QDir::tempPath() + "/smplayer2_bench_osparser";
+    QVERIFY(QDir().mkpath(dir));
+
+    QByteArray block(65536, 0);
+
+    for (int n = 0; n < block.size(); n++) block[n] = (char)(n * 13);
+
+    QFile big(dir + "/big.bin");
+    QVERIFY(big.open(QIODevice::WriteOnly | QIODevice::Truncate));
+
+    for (int n = 0; n < BIG_FILE_SIZE / block.size(); n++) big.write(block);
+
+    big.close();
+
+    for (int n = 0; n < SMALL_FILE_COUNT; n++) {
+        QString filename = dir + QString("/small_%1.bin").arg(n);
+        QFile f(filename);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        f.write(block.left(SMALL_FILE_SIZE));
+        small_files << filename;
+    }
+}
+
+void BenchOSParser::cleanupTestCase()
+{
+    QDir d(dir);
+    QStringList files = d.entryList(QDir::Files);
+
+    for (int n = 0; n < files.count(); n++) d.remove(files[n]);
+
+    QDir().rmdir(dir);
+}
+
+void BenchOSParser::bigFile()
+{
+    QString hash;
+
+    QBENCHMARK {
+        hash = OSParser::calculateHash(dir + "/big.bin");
+    }
+
+    QCOMPARE(hash.length(), 16);
+}
+
+void BenchOSParser::smallFiles()
+{
+    QBENCHMARK {
+        for (int n = 0; n < small_files.count(); n++) {
+            OSParser::calculateHash(small_files[n]);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    BenchOSParser bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_osparser.moc"
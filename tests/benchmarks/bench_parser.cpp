@@ -0,0 +1,133 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Replays the output of mplayer2 playing a file through the parser of
+ MplayerProcess and through the regex based parser it replaced.
+ test_parser checks that both give the same results. Both run with the
+ process category quiet and verbose.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+
+#include "mplayerprocess.h"
+#include "legacymplayerprocess.h"
+#include "loglevels.h"
+#include "testinit.h"
+
+class ReplayMplayerProcess : public MplayerProcess
+{
+public:
+    using MplayerProcess::parseLine;
+};
+
+class BenchParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void newParser_data();
+    void newParser();
+    void legacyParser_data();
+    void legacyParser();
+
+private:
+    QList<QByteArray> lines;
+};
+
+void BenchParser::initTestCase()
+{
+    quietDebugMessages();
+    initTestGlobals();
+
+    QFile file(TEST_DATA_DIR "/mplayer_output.txt");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    // Status lines end with \r, the rest with \n
+    QByteArray output = file.readAll();
+    output.replace('\r', '\n');
+    lines = output.split('\n');
+
+    qDebug("BenchParser::initTestCase: %d lines", lines.count());
+}
+
+void BenchParser::newParser_data()
+{
+    QTest::addColumn<QString>("levels");
+
+    QTest::newRow("quiet") << QString("all=quiet");
+    QTest::newRow("verbose") << QString("process=verbose");
+}
+
+// The messages are dropped by the handler, so the verbose row measures
+// only what it costs to build them
+void BenchParser::newParser()
+{
+    QFETCH(QString, levels);
+    Log::setLevels(levels);
+
+    ReplayMplayerProcess proc;
+
+    QBENCHMARK {
+        // Every run has to parse the ID_ and clip info lines again
+        proc.prepareNewFile(false);
+
+        foreach(const QByteArray & line, lines) {
+            proc.parseLine(line);
+        }
+    }
+
+    Log::setLevels("");
+}
+
+void BenchParser::legacyParser_data()
+{
+    newParser_data();
+}
+
+void BenchParser::legacyParser()
+{
+    QFETCH(QString, levels);
+    Log::setLevels(levels);
+
+    LegacyMplayerProcess proc;
+
+    QBENCHMARK {
+        proc.resetFileInfo();
+
+        foreach(const QByteArray & line, lines) {
+            proc.parseLine(line);
+        }
+    }
+
+    Log::setLevels("");
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    BenchParser bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_parser.moc"
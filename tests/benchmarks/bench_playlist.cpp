@@ -0,0 +1,164 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Adds many files to the playlist, one by one and from a parsed m3u.
+ Needs a display, as the playlist is a widget.
+*/
+
+#include <QtTest>
+#include <QStringList>
+#include <QByteArray>
+#include <QDir>
+
+#include "playlist.h"
+#include "playlistparser.h"
+#include "loglevels.h"
+#include "core.h"
+#include "mplayerwindow.h"
+#include "global.h"
+#include "testinit.h"
+
+#define PATH_COUNT 100000
+#define SINGLE_COUNT 10000
+
+class BenchPlaylist : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void addFiles();
+    void addDuplicatedFiles();
+    void addItem_data();
+    void addItem();
+    void parseAndAdd();
+
+private:
+    MplayerWindow *mplayerwindow;
+    Core *core;
+    Playlist *playlist;
+
+    QStringList paths;
+    QByteArray m3u;
+};
+
+void BenchPlaylist::initTestCase()
+{
+    quietDebugMessages();
+    initTestGlobals();
+
+    mplayerwindow = new MplayerWindow();
+    core = new Core(mplayerwindow);
+    playlist = new Playlist(core);
+
+    // Otherwise every change is written to the journal, and the disk
+    // would be measured instead of the playlist
+    playlist->setSavePlaylistOnExit(false);
+
+    // 100 files per directory
+    for (int n = 0; n < PATH_COUNT; n++) {
+        paths << QString("/media/music/artist %1/album/%2 - track.mp3").arg(n / 100).arg(n % 100);
+    }
+
+    m3u = "#EXTM3U\n";
+    for (int n = 0; n < PATH_COUNT; n++) {
+        m3u += QString("#EXTINF:%1,Track %2\n").arg(180 + n % 60).arg(n).toUtf8();
+        m3u += paths[n].toUtf8() + "\n";
+    }
+}
+
+void BenchPlaylist::cleanupTestCase()
+{
+    delete playlist;
+    delete core;
+    delete mplayerwindow;
+
+    Global::global_end();
+}
+
+void BenchPlaylist::addFiles()
+{
+    QBENCHMARK {
+        playlist->clear();
+        playlist->addFiles(paths, Playlist::NoGetInfo);
+    }
+
+    QCOMPARE(playlist->count(), PATH_COUNT);
+}
+
+void BenchPlaylist::addDuplicatedFiles()
+{
+    playlist->clear();
+    playlist->addFiles(paths, Playlist::NoGetInfo);
+
+    // All of them are skipped
+    QBENCHMARK {
+        playlist->addFiles(paths, Playlist::NoGetInfo);
+    }
+
+    QCOMPARE(playlist->count(), PATH_COUNT);
+}
+
+void BenchPlaylist::addItem_data()
+{
+    QTest::addColumn<QString>("levels");
+
+    QTest::newRow("quiet") << QString("all=quiet");
+    QTest::newRow("verbose") << QString("playlist=verbose");
+}
+
+// The messages are dropped by the handler, so this measures only what
+// it costs to build them
+void BenchPlaylist::addItem()
+{
+    QFETCH(QString, levels);
+    Log::setLevels(levels);
+
+    QBENCHMARK {
+        playlist->clear();
+        for (int n = 0; n < SINGLE_COUNT; n++) {
+            playlist->addItem(paths[n], "", 0);
+        }
+    }
+
+    Log::setLevels("");
+
+    QCOMPARE(playlist->count(), SINGLE_COUNT);
+}
+
+void BenchPlaylist::parseAndAdd()
+{
+    QList<PlaylistItem> items;
+
+    QBENCHMARK {
+        items.clear();
+        PlaylistParser::parseM3U(m3u, true, QDir::rootPath(), items);
+        playlist->clear();
+        playlist->addItems(items);
+    }
+
+    QCOMPARE(playlist->count(), PATH_COUNT);
+}
+
+QTEST_MAIN(BenchPlaylist)
+
+#include "bench_playlist.moc"
@@ -0,0 +1,154 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Loads generated playlist files with many entries in each format.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+
+#include "playlistparser.h"
+#include "testinit.h"
+
+#define ENTRY_COUNT 100000
+
+class BenchPlaylistParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void parse_data();
+    void parse();
+
+private:
+    static QString entry(int n);
+    bool writeFile(const QString &name, const QString &contents);
+
+    QString dir;
+};
+
+// Half of them relative to the directory of the playlist
+QString BenchPlaylistParser::entry(int n)
+{
+    QString path = QString("artist %1/album/%2 - track.mp3").arg(n / 100).arg(n % 100);
+
+    if (n % 2) path = "/media/music/" + path;
+
+    return path;
+}
+
+bool BenchPlaylistParser::writeFile(const QString &name, const QString &contents)
+{
+    QFile f(dir + "/" + name);
+
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    f.write(contents.toUtf8());
+    return true;
+}
+
+void BenchPlaylistParser::initTestCase()
+{
+    quietDebugMessages();
+
+    dir = QDir::tempPath() + "/smplayer2_bench_playlists";
+    QDir().mkpath(dir);
+
+    QString m3u = "#EXTM3U\n";
+    QString pls = QString("[playlist]\nNumberOfEntries=%1\n").arg(ENTRY_COUNT);
+    QString xspf = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<playlist version=\"1\" xmlns=\"http://xspf.org/ns/0/\">\n<trackList>\n";
+
+    for (int n = 0; n < ENTRY_COUNT; n++) {
+        QString path = entry(n);
+        QString title = QString("Track %1").arg(n);
+        int duration = 180 + n % 120;
+
+        m3u += QString("#EXTINF:%1,%2\n%3\n").arg(duration).arg(title).arg(path);
+
+        pls += QString("File%1=%2\nTitle%1=%3\nLength%1=%4\n")
+               .arg(n + 1).arg(path).arg(title).arg(duration);
+
+        QString location = path.startsWith("/") ?
+                           QString(QUrl::fromLocalFile(path).toEncoded()) :
+                           QString(QUrl::toPercentEncoding(path, "/"));
+
+        xspf += QString("<track><location>%1</location><title>%2</title>"
+                        "<duration>%3</duration></track>\n")
+                .arg(location).arg(title).arg(duration * 1000);
+    }
+
+    xspf += "</trackList>\n</playlist>\n";
+
+    QVERIFY(writeFile("list.m3u", m3u));
+    QVERIFY(writeFile("list.pls", pls));
+    QVERIFY(writeFile("list.xspf", xspf));
+}
+
+void BenchPlaylistParser::cleanupTestCase()
+{
+    QFile::remove(dir + "/list.m3u");
+    QFile::remove(dir + "/list.pls");
+    QFile::remove(dir + "/list.xspf");
+    QDir().rmdir(dir);
+}
+
+void BenchPlaylistParser::parse_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("m3u") << "list.m3u" << (int) PlaylistParser::M3U;
+    QTest::newRow("pls") << "list.pls" << (int) PlaylistParser::PLS;
+    QTest::newRow("xspf") << "list.xspf" << (int) PlaylistParser::XSPF;
+}
+
+void BenchPlaylistParser::parse()
+{
+    QFETCH(QString, file);
+    QFETCH(int, format);
+
+    QList<PlaylistItem> items;
+
+    QBENCHMARK {
+        items.clear();
+        QVERIFY(PlaylistParser::parse(dir + "/" + file, (PlaylistParser::Format) format, items));
+    }
+
+    QCOMPARE(items.count(), ENTRY_COUNT);
+    QCOMPARE(items[0].filename(), QDir::cleanPath(dir + "/" + entry(0)));
+    QCOMPARE(items[1].filename(), entry(1));
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    BenchPlaylistParser bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_playlistparser.moc"
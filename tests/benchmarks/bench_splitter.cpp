@@ -0,0 +1,310 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Splits the output of mplayer2 into lines with MyProcess and with the
+ code it used before, which copied the buffer and every line. Both read
+ the output through readStdOut() from a fake pipe, and allocations()
+ counts the memory allocated by each one.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <cstdlib>
+#include <cstring>
+
+#include "myprocess.h"
+
+// Size of the blocks read from the pipe
+#define READ_SIZE 4096
+
+#ifdef __GLIBC__
+#define COUNT_ALLOCATIONS 1
+#else
+#define COUNT_ALLOCATIONS 0
+#endif
+
+#if COUNT_ALLOCATIONS
+// Replaces malloc() and realloc() of glibc, which QByteArray uses, to
+// count the allocations made while count_allocations is true
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static bool count_allocations = false;
+static int allocation_count = 0;
+static qint64 allocated_bytes = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    if (count_allocations) {
+        allocation_count++;
+        allocated_bytes += size;
+    }
+
+    return __libc_malloc(size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (count_allocations) {
+        allocation_count++;
+        allocated_bytes += size;
+    }
+
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+//! MyProcess reading its output from a block in memory instead of
+//! from mplayer2
+class PipeProcess : public MyProcess
+{
+public:
+    PipeProcess() {
+        pipe_pos = 0;
+        setOpenMode(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    //! Makes \a block the data waiting in the pipe
+    void fillPipe(const QByteArray &block) {
+        pipe_data = block;
+        pipe_pos = 0;
+    }
+
+    qint64 bytesAvailable() const {
+        return pipe_data.size() - pipe_pos;
+    }
+
+    using MyProcess::readStdOut;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) {
+        qint64 size = qMin(maxlen, bytesAvailable());
+        memcpy(data, pipe_data.constData() + pipe_pos, size);
+        pipe_pos += size;
+        return size;
+    }
+
+private:
+    QByteArray pipe_data;
+    int pipe_pos;
+};
+
+//! The line splitter of MyProcess in smplayer2 0.8.0
+class LegacySplitter : public PipeProcess
+{
+public:
+    void readStdOut();
+    void genericRead(QByteArray buffer);
+
+private:
+    int isLine(const QByteArray &ba, int from = 0);
+
+    QByteArray remaining_output;
+};
+
+void LegacySplitter::readStdOut()
+{
+    genericRead(readAllStandardOutput());
+}
+
+void LegacySplitter::genericRead(QByteArray buffer)
+{
+    QByteArray ba = remaining_output + buffer;
+    int start = 0;
+    int from_pos = 0;
+    int pos = isLine(ba, from_pos);
+
+    while (pos > -1) {
+        QByteArray line = ba.mid(start, pos - start);
+        from_pos = pos + 1;
+#ifdef Q_OS_WIN
+
+        if ((from_pos < ba.size()) && (ba.at(from_pos) == '\n')) from_pos++;
+
+#endif
+        start = from_pos;
+
+        emit lineAvailable(line);
+
+        pos = isLine(ba, from_pos);
+    }
+
+    remaining_output = ba.mid(from_pos);
+}
+
+int LegacySplitter::isLine(const QByteArray &ba, int from)
+{
+    int pos1 = ba.indexOf('\n', from);
+    int pos2 = ba.indexOf('\r', from);
+
+    if ((pos1 == -1) && (pos2 == -1)) return -1;
+
+    int pos = pos1;
+
+    if ((pos1 != -1) && (pos2 != -1)) {
+        if (pos1 < pos2) pos = pos1;
+        else pos = pos2;
+    } else {
+        if (pos1 == -1) pos = pos2;
+        else if (pos2 == -1) pos = pos1;
+    }
+
+    return pos;
+}
+
+
+class BenchSplitter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void newSplitter();
+    void legacySplitter();
+    void allocations();
+
+    void countLine(QByteArray ba);
+
+private:
+    //! Sends all the blocks through the pipe of \a proc
+    template <class Process> void readAll(Process *proc);
+
+    QList<QByteArray> blocks;
+    int line_count;
+    int expected_lines;
+};
+
+void BenchSplitter::initTestCase()
+{
+    QFile file(TEST_DATA_DIR "/mplayer_output.txt");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QByteArray output = file.readAll();
+    expected_lines = output.count('\n') + output.count('\r');
+#ifdef Q_OS_WIN
+    expected_lines -= output.count("\r\n");
+#endif
+
+    // The lines arrive cut at random places, like reads from the pipe
+    for (int pos = 0; pos < output.size(); pos += READ_SIZE) {
+        blocks.append(output.mid(pos, READ_SIZE));
+    }
+}
+
+void BenchSplitter::countLine(QByteArray ba)
+{
+    Q_UNUSED(ba);
+    line_count++;
+}
+
+template <class Process> void BenchSplitter::readAll(Process *proc)
+{
+    line_count = 0;
+
+    foreach(const QByteArray & block, blocks) {
+        proc->fillPipe(block);
+        proc->readStdOut();
+    }
+}
+
+void BenchSplitter::newSplitter()
+{
+    PipeProcess proc;
+    connect(&proc, SIGNAL(lineAvailable(QByteArray)),
+            this, SLOT(countLine(QByteArray)), Qt::DirectConnection);
+
+    QBENCHMARK {
+        readAll(&proc);
+    }
+
+    QCOMPARE(line_count, expected_lines);
+}
+
+void BenchSplitter::legacySplitter()
+{
+    LegacySplitter splitter;
+    connect(&splitter, SIGNAL(lineAvailable(QByteArray)),
+            this, SLOT(countLine(QByteArray)), Qt::DirectConnection);
+
+    QBENCHMARK {
+        readAll(&splitter);
+    }
+
+    QCOMPARE(line_count, expected_lines);
+}
+
+void BenchSplitter::allocations()
+{
+#if COUNT_ALLOCATIONS
+    PipeProcess proc;
+    LegacySplitter splitter;
+    connect(&proc, SIGNAL(lineAvailable(QByteArray)),
+            this, SLOT(countLine(QByteArray)), Qt::DirectConnection);
+    connect(&splitter, SIGNAL(lineAvailable(QByteArray)),
+            this, SLOT(countLine(QByteArray)), Qt::DirectConnection);
+
+    // The first pass lets the buffer of MyProcess reach its final size
+    readAll(&proc);
+
+    allocation_count = 0;
+    allocated_bytes = 0;
+    count_allocations = true;
+    readAll(&proc);
+    count_allocations = false;
+
+    int new_count = allocation_count;
+    qint64 new_bytes = allocated_bytes;
+    QCOMPARE(line_count, expected_lines);
+
+    allocation_count = 0;
+    allocated_bytes = 0;
+    count_allocations = true;
+    readAll(&splitter);
+    count_allocations = false;
+
+    int legacy_count = allocation_count;
+    qint64 legacy_bytes = allocated_bytes;
+    QCOMPARE(line_count, expected_lines);
+
+    qDebug("BenchSplitter::allocations: %d lines", expected_lines);
+    qDebug("BenchSplitter::allocations: new splitter: %d allocations, %lld bytes",
+           new_count, new_bytes);
+    qDebug("BenchSplitter::allocations: old splitter: %d allocations, %lld bytes",
+           legacy_count, legacy_bytes);
+
+    // Each line still needs the header of a QByteArray::fromRawData(),
+    // but neither the buffer nor the text of the lines is copied
+    QVERIFY(new_count <= legacy_count);
+    QVERIFY(new_bytes < legacy_bytes);
+#else
+    QSKIP("Allocations can only be counted with glibc", SkipSingle);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    BenchSplitter bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_splitter.moc"
@@ -0,0 +1,364 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/*
+ Tests FileSettingsIndexed: the latest record of a file is the one used,
+ a truncated record is dropped, compact() keeps only the current records
+ and evicts the old ones, and the settings changed with FileSettings or
+ FileSettingsHash after the first import are imported again.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "filesettings.h"
+#include "filesettingshash.h"
+#include "filesettingsindexed.h"
+#include "mediasettings.h"
+#include "testinit.h"
+
+#include <utime.h>
+
+// Streams are not hashed, they are saved with their name
+#define STREAM_1 "dvd://1"
+#define STREAM_2 "dvd://2"
+
+class TestFileSettingsIndexed : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void latestRecord();
+    void truncatedRecord();
+    void compact();
+    void maxEntries();
+    void maxAge();
+    void importHash();
+    void importNormal();
+
+private:
+    void removeConfig();
+    int volumeSaved();
+    //! Volume saved for \a filename, or -1
+    int volumeOf(FileSettingsIndexed &set, const QString &filename);
+    void saveVolume(FileSettingsBase *set, int volume);
+    void saveVolume(FileSettingsBase *set, const QString &filename, int volume);
+    qint64 storeSize();
+    //! The dates are saved in seconds, a change has to be in the next one
+    void nextSecond();
+
+    QString dir;
+    QString media_file;
+};
+
+void TestFileSettingsIndexed::initTestCase()
+{
+    quietDebugMessages();
+    initTestGlobals();
+
+    dir = QDir::tempPath() + "/smplayer2_test_filesettingsindexed";
+    QVERIFY(QDir().mkpath(dir));
+
+    media_file = dir + "/media.avi";
+    QFile f(media_file);
+    QVERIFY(f.open(QIODevice::WriteOnly));
+
+    QByteArray data(200 * 1024, 0);
+
+    for (int n = 0; n < data.size(); n++) data[n] = (char)(n * 7 + 3);
+
+    QCOMPARE(f.write(data), (qint64) data.size());
+}
+
+void TestFileSettingsIndexed::init()
+{
+    removeConfig();
+}
+
+void TestFileSettingsIndexed::cleanupTestCase()
+{
+    removeConfig();
+    QFile::remove(media_file);
+    QDir().rmdir(dir);
+}
+
+void TestFileSettingsIndexed::removeConfig()
+{
+    QDirIterator it(dir + "/file_settings", QDir::Files, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) QFile::remove(it.next());
+
+    QDirIterator dirs(dir + "/file_settings", QDir::Dirs | QDir::NoDotAndDotDot);
+
+    while (dirs.hasNext()) QDir().rmdir(dirs.next());
+
+    QDir().rmdir(dir + "/file_settings");
+
+    QFile::remove(dir + "/smplayer2_files.ini");
+    QFile::remove(dir + "/smplayer2_filesettings.dat");
+}
+
+int TestFileSettingsIndexed::volumeSaved()
+{
+    FileSettingsIndexed set(dir);
+    return volumeOf(set, media_file);
+}
+
+int TestFileSettingsIndexed::volumeOf(FileSettingsIndexed &set, const QString &filename)
+{
+    if (!set.existSettingsFor(filename)) return -1;
+
+    MediaSettings mset;
+    set.loadSettingsFor(filename, mset);
+
+    return mset.volume;
+}
+
+void TestFileSettingsIndexed::saveVolume(FileSettingsBase *set, int volume)
+{
+    saveVolume(set, media_file, volume);
+}
+
+void TestFileSettingsIndexed::saveVolume(FileSettingsBase *set, const QString &filename, int volume)
+{
+    MediaSettings mset;
+    mset.reset();
+    mset.volume = volume;
+
+    set->saveSettingsFor(filename, mset);
+}
+
+qint64 TestFileSettingsIndexed::storeSize()
+{
+    return QFileInfo(dir + "/smplayer2_filesettings.dat").size();
+}
+
+void TestFileSettingsIndexed::nextSecond()
+{
+    QTest::qSleep(1100);
+}
+
+void TestFileSettingsIndexed::latestRecord()
+{
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, STREAM_1, 10);
+        saveVolume(&set, STREAM_1, 20);
+        saveVolume(&set, STREAM_2, 50);
+        saveVolume(&set, STREAM_1, 30);
+
+        QCOMPARE(volumeOf(set, STREAM_1), 30);
+    }
+
+    // Read from the file
+    FileSettingsIndexed set(dir);
+    QCOMPARE(volumeOf(set, STREAM_1), 30);
+    QCOMPARE(volumeOf(set, STREAM_2), 50);
+}
+
+void TestFileSettingsIndexed::truncatedRecord()
+{
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, STREAM_1, 10);
+    }
+
+    qint64 complete = storeSize();
+
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, STREAM_1, 20);
+    }
+
+    qint64 size = storeSize();
+    QVERIFY(size > complete);
+
+    // The program died while writing the second record
+    QFile f(dir + "/smplayer2_filesettings.dat");
+    QVERIFY(f.resize(complete + (size - complete) / 2));
+
+    {
+        FileSettingsIndexed set(dir);
+        QCOMPARE(volumeOf(set, STREAM_1), 10);
+    }
+
+    // The incomplete record has been removed
+    QCOMPARE(storeSize(), complete);
+
+    // And the next one is appended after the complete ones
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, STREAM_1, 30);
+    }
+
+    FileSettingsIndexed set(dir);
+    QCOMPARE(volumeOf(set, STREAM_1), 30);
+}
+
+void TestFileSettingsIndexed::compact()
+{
+    FileSettingsIndexed set(dir);
+
+    for (int n = 1; n <= 20; n++) saveVolume(&set, STREAM_1, n);
+
+    saveVolume(&set, STREAM_2, 50);
+
+    qint64 size = storeSize();
+
+    QVERIFY(set.compact());
+
+    // Only the last record of each one
+    QVERIFY(storeSize() < size);
+    QCOMPARE(volumeOf(set, STREAM_1), 20);
+    QCOMPARE(volumeOf(set, STREAM_2), 50);
+
+    qint64 compacted = storeSize();
+    QVERIFY(set.compact());
+    QCOMPARE(storeSize(), compacted);
+}
+
+void TestFileSettingsIndexed::maxEntries()
+{
+    FileSettingsIndexed set(dir);
+    set.setMaxEntries(1);
+
+    saveVolume(&set, STREAM_1, 10);
+
+    // The time of the records is in seconds
+    nextSecond();
+    saveVolume(&set, STREAM_2, 20);
+
+    QVERIFY(set.compact());
+
+    // The newest one is kept
+    QCOMPARE(volumeOf(set, STREAM_1), -1);
+    QCOMPARE(volumeOf(set, STREAM_2), 20);
+}
+
+void TestFileSettingsIndexed::maxAge()
+{
+    // An old file of FileSettingsHash, its date is imported
+    {
+        FileSettingsHash set(dir);
+        saveVolume(&set, 10);
+    }
+
+    QDirIterator it(dir + "/file_settings", QStringList() << "*.ini", QDir::Files, QDirIterator::Subdirectories);
+    QVERIFY(it.hasNext());
+
+    struct utimbuf t;
+    t.actime = t.modtime = QDateTime::currentDateTime().addDays(-10).toTime_t();
+    QCOMPARE(utime(QFile::encodeName(it.next()).constData(), &t), 0);
+
+    FileSettingsIndexed set(dir);
+    saveVolume(&set, STREAM_1, 20);
+
+    QCOMPARE(volumeOf(set, media_file), 10);
+
+    set.setMaxAge(5);
+    QVERIFY(set.compact());
+
+    QCOMPARE(volumeOf(set, media_file), -1);
+    QCOMPARE(volumeOf(set, STREAM_1), 20);
+}
+
+void TestFileSettingsIndexed::importHash()
+{
+    {
+        FileSettingsHash set(dir);
+        saveVolume(&set, 10);
+    }
+
+    QCOMPARE(volumeSaved(), 10);
+
+    // Newer than the file of FileSettingsHash, which is not imported again
+    nextSecond();
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, 30);
+    }
+
+    QCOMPARE(volumeSaved(), 30);
+
+    // Changed while "hash" was chosen
+    nextSecond();
+    {
+        FileSettingsHash set(dir);
+        saveVolume(&set, 20);
+    }
+
+    QCOMPARE(volumeSaved(), 20);
+    QCOMPARE(volumeSaved(), 20);
+}
+
+void TestFileSettingsIndexed::importNormal()
+{
+    {
+        FileSettings set(dir);
+        saveVolume(&set, 10);
+    }
+
+    QCOMPARE(volumeSaved(), 10);
+
+    nextSecond();
+    {
+        FileSettingsIndexed set(dir);
+        saveVolume(&set, 30);
+    }
+
+    QCOMPARE(volumeSaved(), 30);
+
+    // smplayer2_files.ini changes with any file, the group of this one is
+    // still the same
+    nextSecond();
+    {
+        FileSettings set(dir);
+        MediaSettings mset;
+        mset.reset();
+        set.saveSettingsFor(dir + "/other.avi", mset);
+    }
+
+    QCOMPARE(volumeSaved(), 30);
+
+    // Changed while "normal" was chosen
+    nextSecond();
+    {
+        FileSettings set(dir);
+        saveVolume(&set, 20);
+    }
+
+    QCOMPARE(volumeSaved(), 20);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    TestFileSettingsIndexed test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_filesettingsindexed.moc"
@@ -0,0 +1,163 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/*
+ Tests the ring of LogBuffer: dropping the oldest lines, the numbering
+ of the lines, and changing the capacity after the ring has wrapped.
+ LogModel uses firstLine() and endLine() to remove and insert rows.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+
+#include "logbuffer.h"
+
+class TestLogBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void notFull();
+    void wrap();
+    void shrinkAfterWrap();
+    void growAfterWrap();
+    void clear();
+
+private:
+    //! Appends the lines "line <from>" to "line <to - 1>"
+    void appendLines(LogBuffer &buffer, int from, int to);
+    //! Checks that the lines from \a first to \a end - 1 are available,
+    //! with the text given by appendLines()
+    void checkLines(const LogBuffer &buffer, qint64 first, qint64 end);
+};
+
+void TestLogBuffer::appendLines(LogBuffer &buffer, int from, int to)
+{
+    for (int n = from; n < to; n++) buffer.append(QString("line %1").arg(n));
+}
+
+void TestLogBuffer::checkLines(const LogBuffer &buffer, qint64 first, qint64 end)
+{
+    QCOMPARE(buffer.firstLine(), first);
+    QCOMPARE(buffer.endLine(), end);
+    QCOMPARE(buffer.count(), (int)(end - first));
+
+    QString text;
+
+    for (qint64 n = first; n < end; n++) {
+        QCOMPARE(buffer.line(n), QString("line %1").arg(n));
+        text += QString("line %1\n").arg(n);
+    }
+
+    QCOMPARE(buffer.toText(), text);
+
+    // Dropped, or not there yet
+    QVERIFY(buffer.line(first - 1).isEmpty());
+    QVERIFY(buffer.line(end).isEmpty());
+}
+
+void TestLogBuffer::notFull()
+{
+    LogBuffer buffer(5);
+
+    appendLines(buffer, 0, 3);
+    checkLines(buffer, 0, 3);
+}
+
+void TestLogBuffer::wrap()
+{
+    LogBuffer buffer(3);
+
+    appendLines(buffer, 0, 3);
+    checkLines(buffer, 0, 3);
+
+    // The head goes round the ring more than once
+    for (int n = 3; n < 11; n++) {
+        appendLines(buffer, n, n + 1);
+        checkLines(buffer, n - 2, n + 1);
+    }
+}
+
+void TestLogBuffer::shrinkAfterWrap()
+{
+    LogBuffer buffer(5);
+
+    // The head is at 2
+    appendLines(buffer, 0, 7);
+    checkLines(buffer, 2, 7);
+
+    buffer.setCapacity(3);
+    QCOMPARE(buffer.capacity(), 3);
+    checkLines(buffer, 4, 7);
+
+    appendLines(buffer, 7, 9);
+    checkLines(buffer, 6, 9);
+}
+
+void TestLogBuffer::growAfterWrap()
+{
+    LogBuffer buffer(3);
+
+    // The head is at 2
+    appendLines(buffer, 0, 5);
+    checkLines(buffer, 2, 5);
+
+    buffer.setCapacity(6);
+    QCOMPARE(buffer.capacity(), 6);
+    checkLines(buffer, 2, 5);
+
+    // Nothing is dropped until it's full again
+    appendLines(buffer, 5, 8);
+    checkLines(buffer, 2, 8);
+
+    appendLines(buffer, 8, 10);
+    checkLines(buffer, 4, 10);
+}
+
+void TestLogBuffer::clear()
+{
+    LogBuffer buffer(3);
+
+    appendLines(buffer, 0, 5);
+
+    qint64 first, end;
+    int clears;
+    buffer.state(&first, &end, &clears);
+    QCOMPARE(clears, 0);
+
+    buffer.clear();
+
+    buffer.state(&first, &end, &clears);
+    QCOMPARE(first, (qint64) 0);
+    QCOMPARE(end, (qint64) 0);
+    QCOMPARE(clears, 1);
+    QCOMPARE(buffer.count(), 0);
+
+    // Numbered from 0 again
+    appendLines(buffer, 0, 4);
+    checkLines(buffer, 1, 4);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    TestLogBuffer test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_logbuffer.moc"
@@ -0,0 +1,153 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Tests OSParser::calculateHash(), the OpenSubtitles hash: the size of the
+ file plus the sum of the 64-bit words of its first and last 64 KB.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+
+#include "findsubtitles/osparser.h"
+
+class TestOSParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generatedFiles_data();
+    void generatedFiles();
+
+    void referenceFiles_data();
+    void referenceFiles();
+
+    void smallFile();
+
+    void missingFile();
+
+private:
+    QString dir;
+};
+
+void TestOSParser::initTestCase()
+{
+    dir = QDir::tempPath() + "/smplayer2_test_osparser";
+    QVERIFY(QDir().mkpath(dir));
+}
+
+void TestOSParser::cleanupTestCase()
+{
+    QDir d(dir);
+    QStringList files = d.entryList(QDir::Files);
+
+    for (int n = 0; n < files.count(); n++) d.remove(files[n]);
+
+    QDir().rmdir(dir);
+}
+
+void TestOSParser::generatedFiles_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QString>("hash");
+
+    // Byte n of the file is (n * 7 + 3) & 0xff. The hashes were computed
+    // with the C example of the OpenSubtitles wiki. Files smaller than a
+    // block are used as both the first and the last block, the bytes
+    // after the last full 64-bit word are not summed.
+    QTest::newRow("empty") << 0 << "0000000000000000";
+    QTest::newRow("1 byte") << 1 << "0000000000000001";
+    QTest::newRow("7 bytes") << 7 << "0000000000000007";
+    QTest::newRow("1000 bytes") << 1000 << "e5103b5e89b4e376";
+    QTest::newRow("one block") << 65536 << "60a0df1f5fa0c000";
+    QTest::newRow("two blocks and a byte") << 131073 << "4080bfff3f81a001";
+    QTest::newRow("1000000 bytes") << 1000000 << "60a0df1f5faf0240";
+}
+
+void TestOSParser::generatedFiles()
+{
+    QFETCH(int, size);
+    QFETCH(QString, hash);
+
+    QByteArray data(size, 0);
+
+    for (int n = 0; n < size; n++) data[n] = (char)((n * 7 + 3) & 0xff);
+
+    QString filename = dir + QString("/file_%1.bin").arg(size);
+    QFile f(filename);
+    QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(f.write(data), (qint64) size);
+    f.close();
+
+    QCOMPARE(OSParser::calculateHash(filename), hash);
+}
+
+// The test files published by OpenSubtitles are too big to be included,
+// set SMPLAYER2_OSHASH_DATA to the directory where they have been extracted
+void TestOSParser::referenceFiles_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("hash");
+
+    QTest::newRow("breakdance.avi") << "breakdance.avi" << "8e245d9679d31e12";
+    QTest::newRow("dummy.bin") << "dummy.bin" << "61f7751fc2a72bfb";
+}
+
+void TestOSParser::referenceFiles()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, hash);
+
+    QString data_dir = QString::fromLocal8Bit(qgetenv("SMPLAYER2_OSHASH_DATA"));
+    QString filename = data_dir + "/" + file;
+
+    if ((data_dir.isEmpty()) || (!QFile::exists(filename))) {
+        QSKIP("SMPLAYER2_OSHASH_DATA doesn't have the OpenSubtitles test files", SkipSingle);
+    }
+
+    QCOMPARE(OSParser::calculateHash(filename), hash);
+}
+
+// 3001 bytes, hashed with the C example of the OpenSubtitles wiki (with
+// the size signed, so the tail block of a small file is read from its
+// start) and with a separate script
+void TestOSParser::smallFile()
+{
+    QCOMPARE(OSParser::calculateHash(TEST_DATA_DIR "/oshash_small.bin"),
+             QString("f3dbf9bdf9dbfe75"));
+}
+
+void TestOSParser::missingFile()
+{
+    QVERIFY(OSParser::calculateHash(dir + "/does_not_exist.avi").isEmpty());
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    TestOSParser test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_osparser.moc"
@@ -0,0 +1,280 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+/*
+ Replays the output of mplayer2 playing a file through the parser of
+ MplayerProcess and through the regex based parser it replaced, and
+ checks that both send the same signals and fill the same MediaData.
+*/
+
+#include <QtTest>
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <QMetaMethod>
+#include <QMetaType>
+#include <QSignalSpy>
+#include <QStringList>
+
+#include "mplayerprocess.h"
+#include "legacymplayerprocess.h"
+#include "preferences.h"
+#include "testinit.h"
+
+using namespace Global;
+
+class ReplayMplayerProcess : public MplayerProcess
+{
+public:
+    using MplayerProcess::parseLine;
+};
+
+static QString describeTracks(Tracks tracks)
+{
+    QStringList l;
+
+    for (int n = 0; n < tracks.numItems(); n++) {
+        TrackData t = tracks.itemAt(n);
+        l << QString("%1:%2:%3").arg(t.ID()).arg(t.lang()).arg(t.name());
+    }
+
+    return "(" + l.join(", ") + ")";
+}
+
+static QString describeSubTracks(SubTracks subs)
+{
+    QStringList l;
+
+    for (int n = 0; n < subs.numItems(); n++) {
+        SubData s = subs.itemAt(n);
+        l << QString("%1:%2:%3:%4:%5").arg(s.type()).arg(s.ID())
+          .arg(s.lang()).arg(s.name()).arg(s.filename());
+    }
+
+    return "(" + l.join(", ") + ")";
+}
+
+static QString describeTitleTracks(TitleTracks titles)
+{
+    QStringList l;
+
+    for (int n = 0; n < titles.numItems(); n++) {
+        TitleData t = titles.itemAt(n);
+        l << QString("%1:%2:%3:%4:%5").arg(t.ID()).arg(t.name())
+          .arg(t.duration()).arg(t.chapters()).arg(t.angles());
+    }
+
+    return "(" + l.join(", ") + ")";
+}
+
+//! The signals send SubTracks and Tracks, which QVariant can't compare
+static QString describeArgument(const QVariant &v)
+{
+    if (v.userType() == QMetaType::type("SubTracks")) {
+        return describeSubTracks(*static_cast<const SubTracks *>(v.constData()));
+    }
+
+    if (v.userType() == QMetaType::type("Tracks")) {
+        return describeTracks(*static_cast<const Tracks *>(v.constData()));
+    }
+
+    return QString("%1:%2").arg(v.typeName()).arg(v.toString());
+}
+
+static QStringList describeMediaData(MediaData md)
+{
+    QStringList l;
+
+    l << "filename=" + md.filename
+      << "duration=" + QString::number(md.duration)
+      << "video_width=" + QString::number(md.video_width)
+      << "video_height=" + QString::number(md.video_height)
+      << "video_aspect=" + QString::number(md.video_aspect)
+      << "type=" + QString::number(md.type)
+      << "dvd_id=" + md.dvd_id
+      << "novideo=" + QString::number(md.novideo)
+      << "initialized=" + QString::number(md.initialized)
+#if PROGRAM_SWITCH
+      << "programs=" + describeTracks(md.programs)
+#endif
+      << "videos=" + describeTracks(md.videos)
+      << "audios=" + describeTracks(md.audios)
+      << "titles=" + describeTitleTracks(md.titles)
+      << "subs=" + describeSubTracks(md.subs)
+      << "chapters=" + QString::number(md.chapters)
+      << "editions=" + QString::number(md.editions)
+      << "clip_name=" + md.clip_name
+      << "clip_artist=" + md.clip_artist
+      << "clip_author=" + md.clip_author
+      << "clip_album=" + md.clip_album
+      << "clip_genre=" + md.clip_genre
+      << "clip_date=" + md.clip_date
+      << "clip_track=" + md.clip_track
+      << "clip_copyright=" + md.clip_copyright
+      << "clip_comment=" + md.clip_comment
+      << "clip_software=" + md.clip_software
+      << "stream_title=" + md.stream_title
+      << "stream_url=" + md.stream_url
+      << "demuxer=" + md.demuxer
+      << "video_format=" + md.video_format
+      << "audio_format=" + md.audio_format
+      << "video_bitrate=" + QString::number(md.video_bitrate)
+      << "video_fps=" + md.video_fps
+      << "audio_bitrate=" + QString::number(md.audio_bitrate)
+      << "audio_rate=" + QString::number(md.audio_rate)
+      << "audio_nch=" + QString::number(md.audio_nch)
+      << "video_codec=" + md.video_codec
+      << "audio_codec=" + md.audio_codec;
+
+    QMap<int, QString>::const_iterator name = md.chapters_name.constBegin();
+
+    for (; name != md.chapters_name.constEnd(); ++name) {
+        l << QString("chapter_name_%1=%2").arg(name.key()).arg(name.value());
+    }
+
+    QMap<int, long long>::const_iterator ts = md.chapters_timestamp.constBegin();
+
+    for (; ts != md.chapters_timestamp.constEnd(); ++ts) {
+        l << QString("chapter_timestamp_%1=%2").arg(ts.key()).arg(ts.value());
+    }
+
+    return l;
+}
+
+class TestParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sameSignals();
+    void sameMediaData();
+
+private:
+    QList<QByteArray> lines;
+};
+
+void TestParser::initTestCase()
+{
+    quietDebugMessages();
+    initTestGlobals();
+
+    // The old parser sent every position, don't coalesce them
+    pref->position_update_rate = 0;
+
+    QFile file(TEST_DATA_DIR "/mplayer_output.txt");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    // Status lines end with \r, the rest with \n
+    QByteArray output = file.readAll();
+    output.replace('\r', '\n');
+    lines = output.split('\n');
+}
+
+void TestParser::sameSignals()
+{
+    ReplayMplayerProcess proc;
+    LegacyMplayerProcess legacy;
+
+    proc.prepareNewFile(false);
+    legacy.resetFileInfo();
+
+    // Spy on every signal of the old parser, and the same one of the new
+    const QMetaObject *mo = legacy.metaObject();
+    QStringList signatures;
+    QList<QSignalSpy *> spies;
+    QList<QSignalSpy *> legacy_spies;
+
+    for (int n = mo->methodOffset(); n < mo->methodCount(); n++) {
+        QMetaMethod method = mo->method(n);
+
+        if (method.methodType() != QMetaMethod::Signal) continue;
+
+        QByteArray signature = method.signature();
+        QVERIFY2(proc.metaObject()->indexOfSignal(signature) != -1, signature.constData());
+
+        signatures << QString::fromLatin1(signature);
+        spies << new QSignalSpy(&proc, QByteArray("2" + signature).constData());
+        legacy_spies << new QSignalSpy(&legacy, QByteArray("2" + signature).constData());
+    }
+
+    QVERIFY(!signatures.isEmpty());
+
+    foreach(const QByteArray & line, lines) {
+        proc.parseLine(line);
+        legacy.parseLine(line);
+    }
+
+    for (int n = 0; n < signatures.count(); n++) {
+        QSignalSpy *spy = spies[n];
+        QSignalSpy *legacy_spy = legacy_spies[n];
+
+        if (spy->count() != legacy_spy->count()) {
+            QFAIL(qPrintable(QString("%1 was emitted %2 times, the old parser did it %3 times")
+                             .arg(signatures[n]).arg(spy->count()).arg(legacy_spy->count())));
+        }
+
+        for (int e = 0; e < spy->count(); e++) {
+            QList<QVariant> args = spy->at(e);
+            QList<QVariant> legacy_args = legacy_spy->at(e);
+            QCOMPARE(args.count(), legacy_args.count());
+
+            for (int a = 0; a < args.count(); a++) {
+                QString s = signatures[n] + ": " + describeArgument(args[a]);
+                QString legacy_s = signatures[n] + ": " + describeArgument(legacy_args[a]);
+                QCOMPARE(s, legacy_s);
+            }
+        }
+    }
+
+    qDeleteAll(spies);
+    qDeleteAll(legacy_spies);
+}
+
+void TestParser::sameMediaData()
+{
+    ReplayMplayerProcess proc;
+    LegacyMplayerProcess legacy;
+
+    proc.prepareNewFile(false);
+    legacy.resetFileInfo();
+
+    foreach(const QByteArray & line, lines) {
+        proc.parseLine(line);
+        legacy.parseLine(line);
+    }
+
+    QStringList fields = describeMediaData(proc.mediaData());
+    QStringList legacy_fields = describeMediaData(legacy.mediaData());
+
+    QCOMPARE(fields.count(), legacy_fields.count());
+
+    for (int n = 0; n < fields.count(); n++) {
+        QCOMPARE(fields[n], legacy_fields[n]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    TestParser test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_parser.moc"
@@ -0,0 +1,62 @@
+/*  smplayer2, GUI front-end for mplayer2.
+    Copyright (C) 2006-2010 Ricardo Villalba <rvm@escomposlinux.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef _TESTINIT_H_
+#define _TESTINIT_H_
+
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <cstdio>
+
+#include "global.h"
+
+//! Helpers shared by the tests and benchmarks
+
+static QtMsgHandler previous_msg_handler = 0;
+
+static void quietMessageOutput(QtMsgType type, const char *msg)
+{
+    if (type == QtDebugMsg) return;
+
+    if (previous_msg_handler) {
+        previous_msg_handler(type, msg);
+    } else {
+        fprintf(stderr, "%s\n", msg);
+    }
+}
+
+//! Drops the qDebug() messages, they would be measured too
+inline void quietDebugMessages()
+{
+    previous_msg_handler = qInstallMsgHandler(quietMessageOutput);
+}
+
+//! Initializes the globals of smplayer2 (pref, settings...) with an
+//! empty configuration in a temporary directory
+inline void initTestGlobals()
+{
+    QString config_path = QDir::tempPath() + "/smplayer2_tests";
+    QDir().mkpath(config_path);
+    QFile::remove(config_path + "/smplayer2.ini");
+
+    Global::global_init(config_path);
+}
+
+#endif